@@ -47,7 +47,7 @@ __asm__
 #define S2(s) #s
 #define S(s) S2(s)
 
-"mov x8, " S(__NR_exit)          "\n"  // ensure clean process termination
+"mov x8, " S(__NR_exit_group)    "\n"  // terminate every thread of the process
 "svc 0"                          "\n"  // exit with returned status code
 
 #undef S2
@@ -0,0 +1,53 @@
+/* SPDX-License-Identifier: AGPL-3.0-or-later */
+
+#include <linux/unistd.h>
+#include <linux/sched.h>
+
+/**
+ *
+ * system-call:     x0 = "svc 0" [__NR_clone] flags stack parent_tid tls child_tid
+ *
+ * The new thread starts executing right after the system call
+ * on the given stack with every other register left unchanged.
+ * It cannot return into C code since the compiler's frame is not
+ * on its stack, so the function and its argument are placed on top
+ * of the new stack and the thread calls the function from here.
+ * Threads whose functions return terminate on their own.
+ * The thread id is written to the given address and cleared
+ * once the thread has terminated, waking up futex waiters.
+ *
+ **/
+
+long linux_thread_create(void *stack, size_t size, void (*function)(void *), void *argument, lone_u32 *thread)
+{
+	uintptr_t *top = (uintptr_t *) (((uintptr_t) stack + size) & ~((uintptr_t) 15));
+
+	register long x8 __asm__("x8") = __NR_clone;
+	register long x0 __asm__("x0") = CLONE_VM | CLONE_FS | CLONE_FILES | CLONE_SIGHAND | CLONE_THREAD |
+	                                 CLONE_SYSVSEM | CLONE_PARENT_SETTID | CLONE_CHILD_CLEARTID;
+	register long x1 __asm__("x1") = (long) (top - 2);
+	register long x2 __asm__("x2") = (long) thread;
+	register long x3 __asm__("x3") = 0;
+	register long x4 __asm__("x4") = (long) thread;
+
+	top[-2] = (uintptr_t) argument;
+	top[-1] = (uintptr_t) function;
+
+	__asm__ volatile
+	("svc 0"                         "\n"
+	 "cbnz x0, 0f"                   "\n"  // parent returns the thread id
+	 "mov x29, xzr"                  "\n"  // zero the deepest stack frame
+	 "mov x30, xzr"                  "\n"
+	 "ldp x0, x1, [sp], #16"         "\n"  // argument and function, stack is aligned again
+	 "blr x1"                        "\n"
+	 "mov x8, %[exit]"               "\n"  // terminate this thread alone
+	 "mov x0, xzr"                   "\n"
+	 "svc 0"                         "\n"
+	 "0:"
+
+		: "+r" (x0)
+		: "r" (x8), "r" (x1), "r" (x2), "r" (x3), "r" (x4), [exit] "i" (__NR_exit)
+		: "cc", "memory");
+
+	return x0;
+}
@@ -0,0 +1,79 @@
+/* SPDX-License-Identifier: AGPL-3.0-or-later */
+
+/**
+ * Vector kernels for the memory functions.
+ * NEON is part of the arm64 baseline and is always available.
+ * The vector types are GCC vector extensions which compile to NEON
+ * 128 bit registers: no intrinsics headers needed.
+ * Vectors are reduced by folding their two 64 bit halves together.
+ **/
+
+typedef unsigned char lone_neon     __attribute__((vector_size(16), aligned(1), may_alias));
+typedef unsigned long lone_neon_u64 __attribute__((vector_size(16)));
+
+static bool lone_neon_is_zero(lone_neon x)
+{
+	lone_neon_u64 halves = (lone_neon_u64) x;
+	return (halves[0] | halves[1]) == 0;
+}
+
+static size_t lone_memory_vector_copy_forwards(unsigned char *to, unsigned char *from, size_t count)
+{
+	size_t i;
+
+	for (i = 0; i + 2 * sizeof(lone_neon) <= count; i += 2 * sizeof(lone_neon)) {
+		lone_neon x = *(lone_neon *) (from + i), y = *(lone_neon *) (from + i + sizeof(lone_neon));
+		*(lone_neon *) (to + i) = x;
+		*(lone_neon *) (to + i + sizeof(lone_neon)) = y;
+	}
+
+	return i;
+}
+
+/* to and from point one past the end of the memory */
+static size_t lone_memory_vector_copy_backwards(unsigned char *to, unsigned char *from, size_t count)
+{
+	size_t i;
+
+	for (i = 2 * sizeof(lone_neon); i <= count; i += 2 * sizeof(lone_neon)) {
+		lone_neon x = *(lone_neon *) (from - i), y = *(lone_neon *) (from - i + sizeof(lone_neon));
+		*(lone_neon *) (to - i + sizeof(lone_neon)) = y;
+		*(lone_neon *) (to - i) = x;
+	}
+
+	return i - 2 * sizeof(lone_neon);
+}
+
+static size_t lone_memory_vector_set(unsigned char *to, unsigned char byte, size_t count)
+{
+	lone_neon x = (lone_neon) { 0 } + byte;
+	size_t i;
+
+	for (i = 0; i + sizeof(lone_neon) <= count; i += sizeof(lone_neon)) {
+		*(lone_neon *) (to + i) = x;
+	}
+
+	return i;
+}
+
+static size_t lone_memory_vector_mismatch(unsigned char *p, unsigned char *q, size_t count)
+{
+	size_t i;
+
+	for (i = 0; i + sizeof(lone_neon) <= count; i += sizeof(lone_neon)) {
+		if (!lone_neon_is_zero(*(lone_neon *) (p + i) ^ *(lone_neon *) (q + i))) { break; }
+	}
+
+	return i;
+}
+
+static size_t lone_memory_vector_zero_prefix(unsigned char *p, size_t count)
+{
+	size_t i;
+
+	for (i = 0; i + sizeof(lone_neon) <= count; i += sizeof(lone_neon)) {
+		if (!lone_neon_is_zero(*(lone_neon *) (p + i))) { break; }
+	}
+
+	return i;
+}
@@ -51,7 +51,7 @@ __asm__
 #define S2(s) #s
 #define S(s) S2(s)
 
-"mov $" S(__NR_exit) ", %rax"    "\n"  // ensure clean process termination
+"mov $" S(__NR_exit_group) ", %rax" "\n"  // terminate every thread of the process
 "syscall"                        "\n"  // exit with returned status code
 
 #undef S2
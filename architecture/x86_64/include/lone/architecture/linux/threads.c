@@ -0,0 +1,54 @@
+/* SPDX-License-Identifier: AGPL-3.0-or-later */
+
+#include <linux/unistd.h>
+#include <linux/sched.h>
+
+/**
+ *
+ * system-call:     rax = "syscall" [__NR_clone] flags stack parent_tid child_tid tls
+ *
+ * The new thread starts executing right after the system call
+ * on the given stack with every other register left unchanged.
+ * It cannot return into C code since the compiler's frame is not
+ * on its stack, so the function and its argument are placed on top
+ * of the new stack and the thread calls the function from here.
+ * Threads whose functions return terminate on their own.
+ * The thread id is written to the given address and cleared
+ * once the thread has terminated, waking up futex waiters.
+ *
+ **/
+
+long linux_thread_create(void *stack, size_t size, void (*function)(void *), void *argument, lone_u32 *thread)
+{
+	uintptr_t *top = (uintptr_t *) (((uintptr_t) stack + size) & ~((uintptr_t) 15));
+
+	register long rax __asm__("rax") = __NR_clone;
+	register long rdi __asm__("rdi") = CLONE_VM | CLONE_FS | CLONE_FILES | CLONE_SIGHAND | CLONE_THREAD |
+	                                   CLONE_SYSVSEM | CLONE_PARENT_SETTID | CLONE_CHILD_CLEARTID;
+	register long rsi __asm__("rsi") = (long) (top - 2);
+	register long rdx __asm__("rdx") = (long) thread;
+	register long r10 __asm__("r10") = (long) thread;
+	register long r8  __asm__("r8")  = 0;
+
+	top[-2] = (uintptr_t) argument;
+	top[-1] = (uintptr_t) function;
+
+	__asm__ volatile
+	("syscall"                       "\n"
+	 "test %%rax, %%rax"             "\n"  // parent returns the thread id
+	 "jnz 0f"                        "\n"
+	 "xor %%ebp, %%ebp"              "\n"  // zero the deepest stack frame
+	 "pop %%rdi"                     "\n"  // argument
+	 "pop %%rax"                     "\n"  // function, stack is aligned again
+	 "call *%%rax"                   "\n"
+	 "mov %[exit], %%eax"            "\n"  // terminate this thread alone
+	 "xor %%edi, %%edi"              "\n"
+	 "syscall"                       "\n"
+	 "0:"
+
+		: "+r" (rax)
+		: "r" (rdi), "r" (rsi), "r" (rdx), "r" (r10), "r" (r8), [exit] "i" (__NR_exit)
+		: "rcx", "r11", "cc", "memory");
+
+	return rax;
+}
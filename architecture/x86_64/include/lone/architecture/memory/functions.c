@@ -0,0 +1,191 @@
+/* SPDX-License-Identifier: AGPL-3.0-or-later */
+
+/**
+ * Vector kernels for the memory functions.
+ * SSE2 is part of the x86_64 baseline and is always available.
+ * AVX2 is used for larger amounts of data when the processor supports it
+ * and the kernel saves the extended register state, as reported by cpuid.
+ * The vector types are GCC vector extensions: no intrinsics headers needed.
+ **/
+
+typedef unsigned char lone_sse2  __attribute__((vector_size(16), aligned(1), may_alias));
+typedef unsigned char lone_avx2  __attribute__((vector_size(32), aligned(1), may_alias));
+typedef char          lone_sse2_mask __attribute__((vector_size(16)));
+typedef char          lone_avx2_mask __attribute__((vector_size(32)));
+
+#define LONE_AVX2_MINIMUM_SIZE 256
+
+static bool lone_x86_64_has_avx2(void)
+{
+	static int avx2 = -1;
+	unsigned int a, b, c, d;
+
+	if (avx2 >= 0) { return avx2; }
+
+	avx2 = 0;
+
+	__asm__ ("cpuid" : "=a" (a), "=b" (b), "=c" (c), "=d" (d) : "a" (1), "c" (0));
+	if (!(c & (1 << 27)) || !(c & (1 << 28))) { /* no OSXSAVE or no AVX */ return avx2; }
+
+	__asm__ ("xgetbv" : "=a" (a), "=d" (d) : "c" (0));
+	if ((a & 6) != 6) { /* kernel does not save YMM registers */ return avx2; }
+
+	__asm__ ("cpuid" : "=a" (a), "=b" (b), "=c" (c), "=d" (d) : "a" (7), "c" (0));
+	avx2 = (b >> 5) & 1;
+
+	return avx2;
+}
+
+static bool lone_x86_64_use_avx2(size_t count)
+{
+	return count >= LONE_AVX2_MINIMUM_SIZE && lone_x86_64_has_avx2();
+}
+
+static int lone_sse2_equal_mask(lone_sse2 x, lone_sse2 y)
+{
+	return __builtin_ia32_pmovmskb128((lone_sse2_mask) (x == y));
+}
+
+__attribute__((target("avx2")))
+static int lone_avx2_equal_mask(lone_avx2 x, lone_avx2 y)
+{
+	return __builtin_ia32_pmovmskb256((lone_avx2_mask) (x == y));
+}
+
+__attribute__((target("avx2")))
+static size_t lone_avx2_copy_forwards(unsigned char *to, unsigned char *from, size_t count)
+{
+	size_t i;
+
+	for (i = 0; i + 2 * sizeof(lone_avx2) <= count; i += 2 * sizeof(lone_avx2)) {
+		lone_avx2 x = *(lone_avx2 *) (from + i), y = *(lone_avx2 *) (from + i + sizeof(lone_avx2));
+		*(lone_avx2 *) (to + i) = x;
+		*(lone_avx2 *) (to + i + sizeof(lone_avx2)) = y;
+	}
+
+	return i;
+}
+
+static size_t lone_memory_vector_copy_forwards(unsigned char *to, unsigned char *from, size_t count)
+{
+	size_t i;
+
+	if (lone_x86_64_use_avx2(count)) { return lone_avx2_copy_forwards(to, from, count); }
+
+	for (i = 0; i + 2 * sizeof(lone_sse2) <= count; i += 2 * sizeof(lone_sse2)) {
+		lone_sse2 x = *(lone_sse2 *) (from + i), y = *(lone_sse2 *) (from + i + sizeof(lone_sse2));
+		*(lone_sse2 *) (to + i) = x;
+		*(lone_sse2 *) (to + i + sizeof(lone_sse2)) = y;
+	}
+
+	return i;
+}
+
+/* to and from point one past the end of the memory */
+__attribute__((target("avx2")))
+static size_t lone_avx2_copy_backwards(unsigned char *to, unsigned char *from, size_t count)
+{
+	size_t i;
+
+	for (i = 2 * sizeof(lone_avx2); i <= count; i += 2 * sizeof(lone_avx2)) {
+		lone_avx2 x = *(lone_avx2 *) (from - i), y = *(lone_avx2 *) (from - i + sizeof(lone_avx2));
+		*(lone_avx2 *) (to - i + sizeof(lone_avx2)) = y;
+		*(lone_avx2 *) (to - i) = x;
+	}
+
+	return i - 2 * sizeof(lone_avx2);
+}
+
+static size_t lone_memory_vector_copy_backwards(unsigned char *to, unsigned char *from, size_t count)
+{
+	size_t i;
+
+	if (lone_x86_64_use_avx2(count)) { return lone_avx2_copy_backwards(to, from, count); }
+
+	for (i = 2 * sizeof(lone_sse2); i <= count; i += 2 * sizeof(lone_sse2)) {
+		lone_sse2 x = *(lone_sse2 *) (from - i), y = *(lone_sse2 *) (from - i + sizeof(lone_sse2));
+		*(lone_sse2 *) (to - i + sizeof(lone_sse2)) = y;
+		*(lone_sse2 *) (to - i) = x;
+	}
+
+	return i - 2 * sizeof(lone_sse2);
+}
+
+__attribute__((target("avx2")))
+static size_t lone_avx2_set(unsigned char *to, unsigned char byte, size_t count)
+{
+	lone_avx2 x = (lone_avx2) { 0 } + byte;
+	size_t i;
+
+	for (i = 0; i + sizeof(lone_avx2) <= count; i += sizeof(lone_avx2)) {
+		*(lone_avx2 *) (to + i) = x;
+	}
+
+	return i;
+}
+
+static size_t lone_memory_vector_set(unsigned char *to, unsigned char byte, size_t count)
+{
+	lone_sse2 x = (lone_sse2) { 0 } + byte;
+	size_t i;
+
+	if (lone_x86_64_use_avx2(count)) { return lone_avx2_set(to, byte, count); }
+
+	for (i = 0; i + sizeof(lone_sse2) <= count; i += sizeof(lone_sse2)) {
+		*(lone_sse2 *) (to + i) = x;
+	}
+
+	return i;
+}
+
+__attribute__((target("avx2")))
+static size_t lone_avx2_mismatch(unsigned char *p, unsigned char *q, size_t count)
+{
+	size_t i;
+
+	for (i = 0; i + sizeof(lone_avx2) <= count; i += sizeof(lone_avx2)) {
+		if (lone_avx2_equal_mask(*(lone_avx2 *) (p + i), *(lone_avx2 *) (q + i)) != -1) { break; }
+	}
+
+	return i;
+}
+
+static size_t lone_memory_vector_mismatch(unsigned char *p, unsigned char *q, size_t count)
+{
+	size_t i;
+
+	if (lone_x86_64_use_avx2(count)) { return lone_avx2_mismatch(p, q, count); }
+
+	for (i = 0; i + sizeof(lone_sse2) <= count; i += sizeof(lone_sse2)) {
+		if (lone_sse2_equal_mask(*(lone_sse2 *) (p + i), *(lone_sse2 *) (q + i)) != 0xFFFF) { break; }
+	}
+
+	return i;
+}
+
+__attribute__((target("avx2")))
+static size_t lone_avx2_zero_prefix(unsigned char *p, size_t count)
+{
+	lone_avx2 zero = { 0 };
+	size_t i;
+
+	for (i = 0; i + sizeof(lone_avx2) <= count; i += sizeof(lone_avx2)) {
+		if (lone_avx2_equal_mask(*(lone_avx2 *) (p + i), zero) != -1) { break; }
+	}
+
+	return i;
+}
+
+static size_t lone_memory_vector_zero_prefix(unsigned char *p, size_t count)
+{
+	lone_sse2 zero = { 0 };
+	size_t i;
+
+	if (lone_x86_64_use_avx2(count)) { return lone_avx2_zero_prefix(p, count); }
+
+	for (i = 0; i + sizeof(lone_sse2) <= count; i += sizeof(lone_sse2)) {
+		if (lone_sse2_equal_mask(*(lone_sse2 *) (p + i), zero) != 0xFFFF) { break; }
+	}
+
+	return i;
+}
@@ -0,0 +1,71 @@
+/* SPDX-License-Identifier: AGPL-3.0-or-later */
+
+#ifndef LONE_BENCHMARK_HEADER
+#define LONE_BENCHMARK_HEADER
+
+#include <lone/types.h>
+
+/* ╭────────────────────────────────────────────────────────────────────────╮
+   │                                                                        │
+   │    Benchmarks run a function over a number of iterations and report   │
+   │    the elapsed monotonic time. Benchmark functions may perform any     │
+   │    setup they need and then bracket the measured section with the      │
+   │    start and stop functions. Only the time between them is counted.    │
+   │                                                                        │
+   ╰────────────────────────────────────────────────────────────────────────╯ */
+
+struct lone_benchmark;
+
+typedef void (*lone_benchmark_function)(struct lone_benchmark *benchmark);
+
+struct lone_benchmark {
+	struct lone_bytes name;
+	lone_benchmark_function function;
+	void *context;
+	size_t iterations;
+
+	struct {
+		lone_u64 started;
+		lone_u64 elapsed;
+	} nanoseconds;
+};
+
+#define LONE_BENCHMARK_FUNCTION(__name)                                                            \
+void __name(struct lone_benchmark *benchmark)
+
+#define LONE_BENCHMARK(__name_c_string_literal, __function, __iterations) \
+	{ \
+		.name = LONE_BYTES_INIT_FROM_LITERAL(__name_c_string_literal), \
+		.function = (__function), \
+		.context = 0, \
+		.iterations = (__iterations), \
+		.nanoseconds.started = 0, \
+		.nanoseconds.elapsed = 0, \
+	}
+
+#define LONE_BENCHMARK_WITH_CONTEXT(__name_c_string_literal, __function, __context, __iterations) \
+	{ \
+		.name = LONE_BYTES_INIT_FROM_LITERAL(__name_c_string_literal), \
+		.function = (__function), \
+		.context = (void *) (__context), \
+		.iterations = (__iterations), \
+		.nanoseconds.started = 0, \
+		.nanoseconds.elapsed = 0, \
+	}
+
+#define LONE_BENCHMARK_NULL() \
+	{ \
+		.name = LONE_BYTES_INIT_NULL(), \
+		.function = 0, \
+		.context = 0, \
+		.iterations = 0, \
+		.nanoseconds.started = 0, \
+		.nanoseconds.elapsed = 0, \
+	}
+
+void lone_benchmark_start(struct lone_benchmark *benchmark);
+void lone_benchmark_stop(struct lone_benchmark *benchmark);
+
+void lone_benchmark_run(struct lone_benchmark *benchmarks);
+
+#endif /* LONE_BENCHMARK_HEADER */
@@ -25,6 +25,34 @@
 	#define LONE_ALIGNMENT 16
 #endif
 
+#ifndef LONE_MEMORY_ARENA_SIZE
+	#define LONE_MEMORY_ARENA_SIZE (1024 * 1024)
+#endif
+
+#ifndef LONE_MEMORY_LARGE_SIZE
+	#define LONE_MEMORY_LARGE_SIZE (128 * 1024)
+#endif
+
+#ifndef LONE_MEMORY_TRIM_SIZE
+	#define LONE_MEMORY_TRIM_SIZE (64 * 1024)
+#endif
+
+#ifndef LONE_MEMORY_SCRATCH_SIZE
+	#define LONE_MEMORY_SCRATCH_SIZE 1024
+#endif
+
+#ifndef LONE_MEMORY_PAGE_SIZE
+	#define LONE_MEMORY_PAGE_SIZE 4096
+#endif
+
+#ifndef LONE_MEMORY_HUGE_PAGES
+	#define LONE_MEMORY_HUGE_PAGES 0
+#endif
+
+#ifndef LONE_MEMORY_HUGE_PAGE_SIZE
+	#define LONE_MEMORY_HUGE_PAGE_SIZE (2 * 1024 * 1024)
+#endif
+
 #ifndef PT_LONE
 //      PT_LONE   l o n e
 #define PT_LONE 0x6c6f6e65
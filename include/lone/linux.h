@@ -8,6 +8,9 @@
 #include <linux/fs.h>
 #include <linux/fcntl.h>
 #include <linux/mman.h>
+#include <linux/time.h>
+#include <linux/time_types.h>
+#include <linux/futex.h>
 
 #include <lone/types.h>
 
@@ -25,7 +28,7 @@ linux_exit(int code);
 
 long
 __attribute__((tainted_args))
-linux_openat(int dirfd, unsigned char *path, int flags);
+linux_openat(int dirfd, unsigned char *path, int flags, unsigned int mode);
 
 long
 __attribute__((tainted_args))
@@ -51,4 +54,22 @@ int
 __attribute__((tainted_args))
 linux_munmap(void *address, size_t length);
 
+intptr_t
+__attribute__((tainted_args))
+linux_mremap(void *old_address, size_t old_length, size_t new_length, int flags);
+
+int
+__attribute__((tainted_args))
+linux_madvise(void *address, size_t length, int advice);
+
+long
+__attribute__((tainted_args))
+linux_clock_gettime(int clock, struct __kernel_timespec *time);
+
+long linux_futex(lone_u32 *address, int operation, lone_u32 value);
+long linux_sched_yield(void);
+
+/* threads share everything, the function runs on the given stack */
+long linux_thread_create(void *stack, size_t size, void (*function)(void *), void *argument, lone_u32 *thread);
+
 #endif /* LONE_LINUX_HEADER */
@@ -12,11 +12,63 @@
 #endif
 
 #ifndef LONE_LISP_MEMORY_SIZE
-	#define LONE_LISP_MEMORY_SIZE (1024 * 1024)
+	#define LONE_LISP_MEMORY_SIZE (64 * 1024)
 #endif
 
 #ifndef LONE_LISP_HEAP_VALUE_COUNT
-	#define LONE_LISP_HEAP_VALUE_COUNT 512
+	#define LONE_LISP_HEAP_VALUE_COUNT 504   /* heaps of 32 byte values fit in 16 KiB */
+#endif
+
+#ifndef LONE_LISP_GARBAGE_COLLECTOR_NURSERY_VALUES
+	#define LONE_LISP_GARBAGE_COLLECTOR_NURSERY_VALUES (16 * LONE_LISP_HEAP_VALUE_COUNT)
+#endif
+
+#ifndef LONE_LISP_GARBAGE_COLLECTOR_SLICE_VALUES
+	#define LONE_LISP_GARBAGE_COLLECTOR_SLICE_VALUES 0
+#endif
+
+#ifndef LONE_LISP_GARBAGE_COLLECTOR_MARKING_RATE
+	#define LONE_LISP_GARBAGE_COLLECTOR_MARKING_RATE 4
+#endif
+
+#ifndef LONE_LISP_GARBAGE_COLLECTOR_MARK_CHUNK
+	#define LONE_LISP_GARBAGE_COLLECTOR_MARK_CHUNK 256
+#endif
+
+#ifndef LONE_LISP_GARBAGE_COLLECTOR_MARKING_THREADS
+	#define LONE_LISP_GARBAGE_COLLECTOR_MARKING_THREADS 0
+#endif
+
+#ifndef LONE_LISP_GARBAGE_COLLECTOR_BACKGROUND_SWEEPING
+	#define LONE_LISP_GARBAGE_COLLECTOR_BACKGROUND_SWEEPING 0
+#endif
+
+#ifndef LONE_LISP_GARBAGE_COLLECTOR_THREAD_STACK_SIZE
+	#define LONE_LISP_GARBAGE_COLLECTOR_THREAD_STACK_SIZE (64 * 1024)
+#endif
+
+#ifndef LONE_LISP_GARBAGE_COLLECTOR_PAUSE_BUCKETS
+	#define LONE_LISP_GARBAGE_COLLECTOR_PAUSE_BUCKETS 16
+#endif
+
+#ifndef LONE_LISP_GARBAGE_COLLECTOR_CONSERVATIVE
+	#define LONE_LISP_GARBAGE_COLLECTOR_CONSERVATIVE 0
+#endif
+
+#ifndef LONE_LISP_GARBAGE_COLLECTOR_STRESS
+	#define LONE_LISP_GARBAGE_COLLECTOR_STRESS 0
+#endif
+
+#ifndef LONE_LISP_GARBAGE_COLLECTOR_COMPACTION_OCCUPANCY
+	#define LONE_LISP_GARBAGE_COLLECTOR_COMPACTION_OCCUPANCY 25
+#endif
+
+#ifndef LONE_LISP_GARBAGE_COLLECTOR_MINIMUM_VALUES
+	#define LONE_LISP_GARBAGE_COLLECTOR_MINIMUM_VALUES (64 * LONE_LISP_HEAP_VALUE_COUNT)
+#endif
+
+#ifndef LONE_LISP_GARBAGE_COLLECTOR_MINIMUM_BYTES
+	#define LONE_LISP_GARBAGE_COLLECTOR_MINIMUM_BYTES (1024 * 1024)
 #endif
 
 #ifndef LONE_LISP_TABLE_LOAD_FACTOR
@@ -27,6 +79,26 @@
 	#define LONE_LISP_TABLE_GROWTH_FACTOR 2
 #endif
 
+#ifndef LONE_LISP_PROFILER_INTERVAL
+	#define LONE_LISP_PROFILER_INTERVAL 4096   /* bytes allocated between samples */
+#endif
+
+#ifndef LONE_LISP_PROFILER_VARIABLE
+	#define LONE_LISP_PROFILER_VARIABLE "LONE_PROFILE"
+#endif
+
+#ifndef LONE_LISP_PROFILER_FORMAT_VARIABLE
+	#define LONE_LISP_PROFILER_FORMAT_VARIABLE "LONE_PROFILE_FORMAT"
+#endif
+
+#ifndef LONE_LISP_IMAGE_ADDRESS
+	#define LONE_LISP_IMAGE_ADDRESS (64UL << 30)   /* images are laid out here unless it is taken */
+#endif
+
+#ifndef LONE_LISP_IMAGE_VARIABLE
+	#define LONE_LISP_IMAGE_VARIABLE "LONE_IMAGE"
+#endif
+
 #define LONE_LISP_PRIMITIVE(name)                       \
 struct lone_lisp_value lone_lisp_primitive_ ## name     \
 (                                                       \
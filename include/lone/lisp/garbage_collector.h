@@ -5,6 +5,22 @@
 
 #include <lone/lisp/types.h>
 
+void lone_lisp_garbage_collector_initialize(struct lone_lisp *lone);
+void lone_lisp_garbage_collector_finalize(struct lone_lisp *lone);
 void lone_lisp_garbage_collector(struct lone_lisp *lone);
+void lone_lisp_garbage_collector_minor(struct lone_lisp *lone);
+void lone_lisp_garbage_collector_major(struct lone_lisp *lone);
+void lone_lisp_garbage_collector_on_allocation(struct lone_lisp *lone);
+void lone_lisp_garbage_collector_safe_point(struct lone_lisp *lone);
+bool lone_lisp_garbage_collector_sweep_next_heap(struct lone_lisp *lone);
+void lone_lisp_garbage_collector_join_sweeper(struct lone_lisp *lone);
+void lone_lisp_garbage_collector_write_barrier(struct lone_lisp *lone,
+		struct lone_lisp_value object, struct lone_lisp_value value);
+void lone_lisp_garbage_collector_write_barrier_at(struct lone_lisp *lone,
+		struct lone_lisp_value vector, size_t i, struct lone_lisp_value value);
+
+size_t lone_lisp_roots_save(struct lone_lisp *lone);
+void lone_lisp_root(struct lone_lisp *lone, struct lone_lisp_value *value);
+void lone_lisp_roots_restore(struct lone_lisp *lone, size_t roots);
 
 #endif /* LONE_LISP_GARBAGE_COLLECTOR_HEADER */
@@ -6,8 +6,22 @@
 #include <lone/lisp/definitions.h>
 #include <lone/lisp/types.h>
 
+/* heaps are aligned to their size rounded up to a power of two */
+#define LONE_LISP_HEAP_ALIGNMENT \
+	(2UL << (8 * sizeof(unsigned long) - 1 - __builtin_clzl(sizeof(struct lone_lisp_heap) - 1)))
+
 void lone_lisp_heap_initialize(struct lone_lisp *lone);
+struct lone_lisp_heap *lone_lisp_heap_create(struct lone_lisp *lone);
+void lone_lisp_heap_adopt(struct lone_lisp *lone, struct lone_lisp_heap *heap);
+void lone_lisp_heap_destroy(struct lone_lisp *lone, struct lone_lisp_heap *heap);
+struct lone_lisp_heap_value *lone_lisp_heap_find_value(struct lone_lisp *lone, void *pointer);
 struct lone_lisp_heap_value *lone_lisp_heap_allocate_value(struct lone_lisp *lone);
+void lone_lisp_heap_kill_value(struct lone_lisp_heap *heap, struct lone_lisp_heap_value *value);
+void lone_lisp_heap_promote_value(struct lone_lisp_heap *heap, struct lone_lisp_heap_value *value);
 void lone_lisp_deallocate_dead_heaps(struct lone_lisp *lone);
 
+#define LONE_LISP_HEAP_VALUE_TYPES (LONE_LISP_TYPE_BYTES + 1)
+
+void lone_lisp_heap_count_live_values(struct lone_lisp *lone, size_t counts[LONE_LISP_HEAP_VALUE_TYPES]);
+
 #endif /* LONE_LISP_HEAP_HEADER */
@@ -0,0 +1,31 @@
+/* SPDX-License-Identifier: AGPL-3.0-or-later */
+
+#ifndef LONE_LISP_IMAGE_HEADER
+#define LONE_LISP_IMAGE_HEADER
+
+#include <lone/types.h>
+#include <lone/segment.h>
+
+#include <lone/lisp/definitions.h>
+#include <lone/lisp/types.h>
+
+/* ╭────────────────────────────────────────────────────────────────────────╮
+   │                                                                        │
+   │    Heap images. The image named by the LONE_IMAGE environment          │
+   │    variable is mapped, otherwise the one at the start of the           │
+   │    embedded segment if there is one. Images written by other           │
+   │    executables are ignored and the interpreter initializes itself.     │
+   │                                                                        │
+   ╰────────────────────────────────────────────────────────────────────────╯ */
+
+#define LONE_LISP_IMAGE_MAGIC "lone img"
+#define LONE_LISP_IMAGE_VERSION 1
+
+void lone_lisp_image_write(struct lone_lisp *lone, int file_descriptor);
+
+size_t lone_lisp_image_size(struct lone_bytes bytes);
+struct lone_bytes lone_lisp_image_map(struct lone_lisp *lone, char **environment, lone_elf_native_segment *segment);
+bool lone_lisp_image_load(struct lone_lisp *lone, struct lone_bytes image);
+bool lone_lisp_image_contains(struct lone_lisp *lone, void *pointer);
+
+#endif /* LONE_LISP_IMAGE_HEADER */
@@ -15,6 +15,9 @@
 void lone_lisp_modules_intrinsic_linux_initialize(struct lone_lisp *lone,
 		int argc, char **argv, char **envp, struct lone_auxiliary_vector *auxv);
 
+void lone_lisp_modules_intrinsic_linux_bind(struct lone_lisp *lone,
+		int argc, char **argv, char **envp, struct lone_auxiliary_vector *auxv);
+
 LONE_LISP_PRIMITIVE(linux_system_call);
 
 #endif /* LONE_LISP_MODULES_INTRINSIC_LINUX_HEADER */
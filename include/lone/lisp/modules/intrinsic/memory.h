@@ -0,0 +1,33 @@
+/* SPDX-License-Identifier: AGPL-3.0-or-later */
+
+#ifndef LONE_LISP_MODULES_INTRINSIC_MEMORY_HEADER
+#define LONE_LISP_MODULES_INTRINSIC_MEMORY_HEADER
+
+#include <lone/lisp/definitions.h>
+#include <lone/lisp/types.h>
+
+/* ╭────────────────────────────────────────────────────────────────────────╮
+   │                                                                        │
+   │    Introspection of the memory allocator and the value heap.           │
+   │    Collections can be forced instead of waiting for allocations to     │
+   │    trigger them. Snapshots of the heap are written as images which     │
+   │    later interpreters map instead of initializing themselves.          │
+   │    Profiles attribute sampled allocations to the functions that made   │
+   │    them and report what they kept alive.                               │
+   │                                                                        │
+   ╰────────────────────────────────────────────────────────────────────────╯ */
+
+void lone_lisp_modules_intrinsic_memory_initialize(struct lone_lisp *lone);
+
+LONE_LISP_PRIMITIVE(memory_statistics);
+LONE_LISP_PRIMITIVE(memory_huge_pages);
+LONE_LISP_PRIMITIVE(memory_collect);
+LONE_LISP_PRIMITIVE(memory_incremental);
+LONE_LISP_PRIMITIVE(memory_parallel);
+LONE_LISP_PRIMITIVE(memory_background_sweeping);
+LONE_LISP_PRIMITIVE(memory_compact);
+LONE_LISP_PRIMITIVE(memory_snapshot);
+LONE_LISP_PRIMITIVE(memory_profile);
+LONE_LISP_PRIMITIVE(memory_profile_report);
+
+#endif /* LONE_LISP_MODULES_INTRINSIC_MEMORY_HEADER */
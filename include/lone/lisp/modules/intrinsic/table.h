@@ -19,5 +19,6 @@ LONE_LISP_PRIMITIVE(table_set);
 LONE_LISP_PRIMITIVE(table_delete);
 LONE_LISP_PRIMITIVE(table_each);
 LONE_LISP_PRIMITIVE(table_count);
+LONE_LISP_PRIMITIVE(table_weak);
 
 #endif /* LONE_LISP_MODULES_INTRINSIC_TABLE_HEADER */
@@ -0,0 +1,45 @@
+/* SPDX-License-Identifier: AGPL-3.0-or-later */
+
+#ifndef LONE_LISP_PROFILER_HEADER
+#define LONE_LISP_PROFILER_HEADER
+
+#include <lone/types.h>
+
+#include <lone/lisp/definitions.h>
+#include <lone/lisp/types.h>
+
+/* ╭────────────────────────────────────────────────────────────────────────╮
+   │                                                                        │
+   │    Sampling heap profiler. Entering a frame returns the frame to       │
+   │    return to once the function has been applied. Table reports list    │
+   │    the estimated bytes each function allocated and kept alive by       │
+   │    type. Folded reports list the stacks of the samples that are still  │
+   │    alive in the format read by flame graph tools. Profiling is         │
+   │    started by the profile primitive of the memory module, or at        │
+   │    startup if LONE_PROFILE names the file the report is written to     │
+   │    once the program ends.                                              │
+   │                                                                        │
+   ╰────────────────────────────────────────────────────────────────────────╯ */
+
+enum lone_lisp_profiler_format {
+	LONE_LISP_PROFILER_TABLE,
+	LONE_LISP_PROFILER_FOLDED,
+};
+
+void lone_lisp_profiler_initialize(struct lone_lisp *lone);
+void lone_lisp_profiler_start(struct lone_lisp *lone, size_t interval);
+void lone_lisp_profiler_stop(struct lone_lisp *lone);
+
+size_t lone_lisp_profiler_enter(struct lone_lisp *lone, struct lone_bytes name, struct lone_lisp_value applicable);
+void lone_lisp_profiler_leave(struct lone_lisp *lone, size_t frame);
+
+bool lone_lisp_profiler_should_sample_value(struct lone_lisp *lone);
+void lone_lisp_profiler_sample_value(struct lone_lisp *lone, struct lone_lisp_heap_value *value);
+void lone_lisp_profiler_forget_value(struct lone_lisp *lone, struct lone_lisp_heap_value *value);
+void lone_lisp_profiler_move_value(struct lone_lisp *lone,
+		struct lone_lisp_heap_value *from, struct lone_lisp_heap_value *to);
+
+void lone_lisp_profiler_report(struct lone_lisp *lone, int file_descriptor, enum lone_lisp_profiler_format format);
+void lone_lisp_profiler_report_to_file(struct lone_lisp *lone, char *path, char *format);
+
+#endif /* LONE_LISP_PROFILER_HEADER */
@@ -13,6 +13,7 @@ typedef long lone_lisp_integer;
 
 struct lone_lisp_reader {
 	int file_descriptor;
+	struct lone_memory_scratch scratch;
 	struct {
 		struct lone_bytes bytes;
 		struct {
@@ -105,18 +106,39 @@ union lone_lisp_pointer {
 	lone_lisp_integer *to_integer;
 };
 
+/* ╭────────────────────────────────────────────────────────────────────────╮
+   │                                                                        │
+   │    Values are single machine words distinguished by their low bits.    │
+   │    Heap values are aligned, so pointers to them need no tag at all     │
+   │    and may be dereferenced directly. Nil is the null pointer.          │
+   │                                                                        │
+   │        ◦ …xxxxxxx1    integer, shifted left by one bit                 │
+   │        ◦ …xxxxxx00    heap value, or nil if all bits are zero          │
+   │        ◦ …tttt0010    pointer, shifted left by eight bits              │
+   │                                                                        │
+   │    Integers lose their most significant bit. The pointer type fits     │
+   │    in the tag of pointers along with their address, which must fit     │
+   │    in 56 bits like every user space address on supported platforms.    │
+   │    Values fit in a register and lists, vectors and tables store        │
+   │    half as many bytes as a pair of type and union would need.          │
+   │    Heap values fit in 32 bytes, two to a cache line: functions and     │
+   │    primitives keep their flags beside the type and tables keep         │
+   │    their entries and indexes in a single allocation.                   │
+   │                                                                        │
+   ╰────────────────────────────────────────────────────────────────────────╯ */
+
+#define LONE_LISP_INTEGER_TAG 0x1UL
+#define LONE_LISP_POINTER_TAG 0x2UL
+#define LONE_LISP_TAG_MASK    0x3UL
+#define LONE_LISP_POINTER_TYPE_SHIFT 4
+#define LONE_LISP_POINTER_SHIFT 8
+
 struct lone_lisp_heap_value;
 struct lone_lisp_value {
 	union {
-		struct lone_lisp_heap_value *heap_value;
-		union lone_lisp_pointer pointer;
-		lone_lisp_integer integer;
+		struct lone_lisp_heap_value *heap_value;   /* untagged */
+		uintptr_t bits;
 	} as;
-
-	struct {
-		enum lone_lisp_value_type type;
-		enum lone_lisp_pointer_type pointer_type;
-	};
 };
 
 struct lone_lisp_module {
@@ -137,7 +159,6 @@ struct lone_lisp_function {
 	struct lone_lisp_value arguments;         /* the bindings */
 	struct lone_lisp_value code;              /* the lambda */
 	struct lone_lisp_value environment;       /* the closure */
-	struct lone_lisp_function_flags flags;    /* how to evaluate & apply */
 };
 
 struct lone_lisp;
@@ -150,7 +171,6 @@ struct lone_lisp_primitive {
 	struct lone_lisp_value name;
 	lone_lisp_primitive_function function;
 	struct lone_lisp_value closure;
-	struct lone_lisp_function_flags flags;
 };
 
 struct lone_lisp_list {
@@ -176,7 +196,8 @@ struct lone_lisp_vector {
    │    they will be rehashed once they're above 70% capacity.              │
    │                                                                        │
    │    When deleting keys, entries are shifted backwards.                  │
-   │    Tombstones are not used.                                            │
+   │    Tombstones are not used. Both arrays share a single allocation:     │
+   │    the indexes follow the entries.                                     │
    │                                                                        │
    │    Currently, lone tables use the FNV-1a hashing algorithm.            │
    │    More algorithms will probably be implemented in the future.         │
@@ -187,7 +208,23 @@ struct lone_lisp_vector {
    │    but will also serve as a prototype-based object system              │
    │    as in Javascript and Self.                                          │
    │                                                                        │
+   │    Tables may also hold their keys or their values weakly, so that     │
+   │    caches do not keep alive what they cache. Entries are removed by    │
+   │    the garbage collector once a weakly held key or value has died.     │
+   │    Ephemeron tables hold their keys weakly and their values only as    │
+   │    long as their keys are alive, so values that refer back to their    │
+   │    keys do not keep them alive. Weakly held keys are hashed and        │
+   │    compared by identity: any value may be a key, and equal keys do     │
+   │    not share the entry of whichever one dies first.                    │
+   │                                                                        │
    ╰────────────────────────────────────────────────────────────────────────╯ */
+enum lone_lisp_table_weakness {
+	LONE_LISP_TABLE_STRONG,
+	LONE_LISP_TABLE_WEAK_KEYS,
+	LONE_LISP_TABLE_WEAK_VALUES,
+	LONE_LISP_TABLE_EPHEMERON,
+};
+
 struct lone_lisp_table_index {
 	bool used: 1;
 	size_t index;
@@ -199,21 +236,25 @@ struct lone_lisp_table_entry {
 };
 
 struct lone_lisp_table {
-	size_t count;
-	size_t capacity;
-	struct lone_lisp_table_index *indexes;
-	struct lone_lisp_table_entry *entries;
+	lone_u32 count;
+	lone_u32 capacity;
+	struct lone_lisp_table_entry *entries;    /* followed by the indexes */
 	struct lone_lisp_value prototype;
 };
 
 struct lone_lisp_heap_value {
 	struct {
 		bool live: 1;
-		bool marked: 1;
 		bool should_deallocate_bytes: 1;
+		bool old: 1;
+		bool remembered: 1;
+		bool forwarded: 1;
+		bool sampled: 1;
 	};
 
 	enum lone_lisp_heap_value_type type;
+	struct lone_lisp_function_flags flags;    /* how functions and primitives evaluate & apply */
+	enum lone_lisp_table_weakness weakness;   /* which references of tables do not keep values alive */
 
 	union {
 		struct lone_lisp_module module;
@@ -223,6 +264,7 @@ struct lone_lisp_heap_value {
 		struct lone_lisp_vector vector;
 		struct lone_lisp_table table;
 		struct lone_bytes bytes;   /* also used by texts and symbols */
+		struct lone_lisp_heap_value *forwarding;   /* where compaction moved the value */
 	} as;
 };
 
@@ -244,6 +286,8 @@ struct lone_lisp_value lone_lisp_boolean_for(struct lone_lisp *lisp, bool value)
    │                                                                        │
    ╰────────────────────────────────────────────────────────────────────────╯ */
 
+enum lone_lisp_value_type lone_lisp_type_of(struct lone_lisp_value value);
+
 bool lone_lisp_is_register_value(struct lone_lisp_value value);
 bool lone_lisp_is_heap_value(struct lone_lisp_value value);
 bool lone_lisp_is_register_value_of_type(struct lone_lisp_value value, enum lone_lisp_value_type register_value_type);
@@ -280,6 +324,172 @@ bool lone_lisp_integer_is_less_than_or_equal_to(struct lone_lisp_value x, struct
 bool lone_lisp_integer_is_greater_than(struct lone_lisp_value x, struct lone_lisp_value y);
 bool lone_lisp_integer_is_greater_than_or_equal_to(struct lone_lisp_value x, struct lone_lisp_value y);
 
+/* slot is the index of the vector element that was written or -1 if unknown */
+struct lone_lisp_remembered_value {
+	struct lone_lisp_heap_value *value;
+	size_t slot;
+};
+
+/* marked values whose children from the index onwards are not marked yet */
+struct lone_lisp_mark {
+	struct lone_lisp_heap_value *value;
+	size_t index;
+};
+
+/* replaced rather than resized since other markers may be reading it */
+struct lone_lisp_mark_buffer {
+	struct lone_lisp_mark_buffer *retired;   /* replaced buffers, freed after marking */
+	size_t capacity;                          /* power of two */
+	struct lone_lisp_mark marks[];
+};
+
+/* owners push and pop at the bottom, other markers steal from the top */
+struct lone_lisp_mark_stack {
+	struct lone_lisp_mark_buffer *buffer;
+	long top;
+	long bottom;
+};
+
+/* every marking thread owns a mark stack and counts the values it marked */
+struct lone_lisp_marker {
+	struct lone_lisp *lone;
+	struct lone_lisp_mark_stack stack;
+	size_t marked;
+	size_t id;
+	lone_u32 generation;     /* last parallel marking phase joined */
+	lone_u32 thread;         /* cleared by Linux once the helper thread has terminated */
+	void *thread_stack;
+};
+
+/* heaps sorted by address so that words can be looked up while scanning the stack */
+struct lone_lisp_heap_index {
+	struct lone_lisp_heap **heaps;
+	size_t count;
+	size_t capacity;
+	lone_u32 lock;           /* the sweeper removes the heaps it deallocates */
+};
+
+/* addresses of the variables holding values that must survive collection */
+struct lone_lisp_roots {
+	struct lone_lisp_value **values;
+	size_t count;
+	size_t capacity;
+};
+
+/* ╭───────────────────────┨ LONE LISP HEAP PROFILER ┠──────────────────────╮
+   │                                                                        │
+   │    The profiler samples allocations of values and of memory blocks     │
+   │    and attributes them to the functions and primitives that were       │
+   │    being applied when they were allocated. Samples are taken at        │
+   │    random distances around the sampling interval so that periodic      │
+   │    allocation patterns cannot hide from the profiler. Every sample     │
+   │    stands for an interval's worth of bytes, so the bytes allocated by  │
+   │    each function are estimated without recording every allocation.     │
+   │                                                                        │
+   │    Applied functions form a tree of frames rooted at the top level.    │
+   │    Frames are named after the symbols that were applied. Primitives    │
+   │    applied by other means are named after themselves and other         │
+   │    functions are simply lambdas. Names refer to the bytes of interned  │
+   │    symbols, which live as long as the interpreter does.                │
+   │                                                                        │
+   │    Sampled values and blocks are kept in a table indexed by their      │
+   │    addresses until they die. The garbage collector and the allocator   │
+   │    tell the profiler about the death of the values and blocks that     │
+   │    were sampled, which is then counted against the frame that          │
+   │    allocated them. Reports show how much each frame allocated and how  │
+   │    much of it survived.                                                │
+   │                                                                        │
+   ╰────────────────────────────────────────────────────────────────────────╯ */
+
+/* memory blocks are counted after the value types */
+#define LONE_LISP_PROFILER_KINDS (LONE_LISP_TYPE_BYTES + 2)
+
+struct lone_lisp_profiler_frame {
+	size_t parent;
+	struct lone_bytes name;
+	struct {
+		size_t samples;
+		size_t bytes;
+	} dead[LONE_LISP_PROFILER_KINDS];
+};
+
+struct lone_lisp_profiler_sample {
+	void *pointer;           /* sampled value or memory block, zero in empty slots */
+	size_t frame;
+	size_t bytes;            /* estimated bytes allocated since the previous sample */
+	bool value;              /* a value rather than a memory block */
+};
+
+struct lone_lisp_profiler {
+	size_t interval;         /* bytes between samples, zero stops sampling */
+	size_t countdown;        /* bytes of values left until the next sample */
+	unsigned long random;    /* varies the intervals around their mean */
+	size_t frame;            /* frame of the function being applied */
+	bool reporting;          /* memory allocated while reporting is not sampled */
+	lone_u32 lock;           /* the sweeper reports the death of the values it sweeps */
+	struct {
+		struct lone_lisp_profiler_frame *list;
+		size_t count;
+		size_t capacity;
+		size_t *slots;   /* indexes of frames by parent and name, plus one */
+		size_t slot_count;
+	} frames;
+	struct {
+		struct lone_lisp_profiler_sample *slots;
+		size_t count;
+		size_t slot_count;
+	} samples;
+};
+
+/* ╭────────────────────────┨ LONE LISP IMAGES ┠────────────────────────────╮
+   │                                                                        │
+   │    Images are snapshots of the heap which spare new interpreters the   │
+   │    work of initializing the intrinsic modules and loading the modules  │
+   │    they preload. Everything reachable from the symbol table, the       │
+   │    loaded modules and the top level environment is laid out in heaps   │
+   │    like those of the interpreter, preceded by the bytes, vector        │
+   │    elements and table entries the values own. Values in images are     │
+   │    old and always live until collected.                                │
+   │                                                                        │
+   │    Images are laid out at the address they are meant to be mapped at,  │
+   │    so that they are mapped from their files with a single private      │
+   │    mapping: pages are only read in when they are needed and copied     │
+   │    when they are written to. Tables are rehashed with the hash         │
+   │    function state of the process that loads the image, so that         │
+   │    processes started from the same image do not share it; only the     │
+   │    pages holding table entries are copied. Should the address be       │
+   │    taken, the image is mapped elsewhere and relocated: every           │
+   │    reference is adjusted before the tables are rehashed.               │
+   │                                                                        │
+   │    Primitives refer to functions of the executable which wrote the     │
+   │    image, so images are only loaded by that same executable. Memory    │
+   │    owned by values in images is never deallocated, it is copied out    │
+   │    when it must grow. Values which differ between processes, such as   │
+   │    the arguments and environment of the linux module, are set again    │
+   │    once an image has been loaded.                                      │
+   │                                                                        │
+   ╰────────────────────────────────────────────────────────────────────────╯ */
+
+struct lone_lisp_image_header {
+	unsigned char magic[8];
+	lone_u32 version;
+	lone_u32 value_count;         /* values per heap */
+	size_t heap_size;             /* bytes per heap, heaps are aligned to their size */
+	uintptr_t base;               /* address the image was laid out at */
+	uintptr_t reference;          /* address of a function of the executable that wrote it */
+	unsigned long hash;           /* offset basis its tables were hashed with */
+	size_t size;                  /* bytes in the image including this header, a multiple of the page size */
+	size_t heaps;                 /* offset of the first heap, the owned memory precedes it */
+	size_t heap_count;
+	size_t values;                /* live values in the heaps */
+	struct {
+		struct lone_lisp_value symbol_table;
+		struct lone_lisp_value truth;
+		struct lone_lisp_value loaded;
+		struct lone_lisp_value top_level_environment;
+	} roots;
+};
+
 /* ╭───────────────────────┨ LONE LISP INTERPRETER ┠────────────────────────╮
    │                                                                        │
    │    The lone lisp interpreter is composed of all internal state         │
@@ -294,6 +504,12 @@ struct lone_lisp {
 	struct lone_system *system;
 	void *native_stack;
 	struct lone_lisp_heap *heaps;
+	struct lone_lisp_heap *available_heaps;
+	struct lone_lisp_heap *young_heaps;
+	struct lone_lisp_heap *unswept_heaps;
+	struct lone_lisp_heap_index heap_index;
+	struct lone_bytes image;      /* mapped heap image, never unmapped */
+	struct lone_lisp_profiler profiler;
 	struct lone_lisp_value symbol_table;
 	struct {
 		struct lone_lisp_value truth;
@@ -304,7 +520,81 @@ struct lone_lisp {
 		struct lone_lisp_value null;
 		struct lone_lisp_value top_level_environment;
 		struct lone_lisp_value path;
+		size_t loading;          /* modules whose code is being evaluated */
 	} modules;
+	struct {
+		bool running;
+		bool minor;              /* only young values are being collected */
+		bool conservative;       /* scan the native stack for values as well */
+		bool sweeping;           /* heaps marked by the last major cycle remain unswept */
+		size_t old;              /* values promoted to the old generation */
+		size_t allocations;      /* values allocated since the last cycle */
+		size_t allocated;        /* bytes in use after the last cycle */
+		struct {
+			size_t values;   /* old values that trigger a major cycle */
+			size_t bytes;    /* bytes in use that trigger a major cycle */
+		} threshold;
+		struct {
+			struct lone_lisp_remembered_value *values;
+			size_t count;
+			size_t capacity;
+		} remembered;            /* old values that were given young values */
+		struct {
+			size_t slice;            /* values marked per slice, zero stops the world */
+			bool marking;
+			size_t allocations;      /* values allocated since the last slice */
+			size_t examined;         /* values in the heap when marking started */
+		} incremental;
+		struct {
+			bool requested;          /* compact the heap at the next safe point */
+		} compaction;
+		struct {
+			size_t threads;          /* helper threads, zero marks on this thread alone */
+			size_t started;          /* helper threads created so far */
+			struct lone_lisp_marker **markers;   /* this thread's marker followed by the helpers' */
+			bool marking;            /* helpers are marking, marks must be set atomically */
+			bool stopping;           /* helpers terminate once woken up */
+			lone_u32 generation;     /* incremented to wake the helpers up */
+			lone_u32 idle;           /* markers that found nothing left to steal */
+			lone_u32 finished;       /* helpers done with the current phase */
+		} parallel;
+		struct {
+			bool enabled;            /* major cycles hand the unswept heaps over to the sweeper */
+			bool active;             /* the sweeper may be sweeping, heaps must be claimed */
+			bool stopping;           /* the sweeper terminates once woken up */
+			lone_u32 generation;     /* incremented to wake the sweeper up */
+			lone_u32 finished;       /* last generation the sweeper is done with */
+			lone_u32 thread;         /* cleared by Linux once the sweeper has terminated */
+			lone_u32 lock;           /* serializes claiming unswept heaps */
+			void *stack;
+			struct lone_lisp_heap *swept;    /* heaps swept by the sweeper, waiting to be adopted */
+			size_t released;         /* dead heaps deallocated by the sweeper */
+		} sweeper;
+		struct {
+			struct lone_lisp_heap_value **tables;
+			size_t count;
+			size_t capacity;
+			lone_u32 lock;           /* markers may find weak tables at the same time */
+		} weak;                          /* weak tables found while marking, cleared once it is done */
+		struct lone_lisp_marker marker;          /* marks values on this thread, its stack holds the gray values */
+		struct lone_lisp_roots roots;            /* shadow stack of rooted variables */
+	} garbage_collector;
+	struct {
+		struct {
+			size_t pages;
+			size_t allocations;
+			size_t collections;
+			size_t minor_collections;
+			size_t slices;
+			size_t compactions;
+		} heap;
+		struct {
+			size_t count;
+			lone_u64 total;          /* nanoseconds */
+			lone_u64 maximum;        /* nanoseconds */
+			size_t histogram[LONE_LISP_GARBAGE_COLLECTOR_PAUSE_BUCKETS];
+		} pauses;
+	} statistics;
 };
 
 /* ╭────────────────────┨ LONE LISP MEMORY ALLOCATION ┠─────────────────────╮
@@ -319,26 +609,154 @@ struct lone_lisp {
    │    All allocated lone lisp values are placed in the value heap,        │
    │    essentially a linked list of arrays of contiguous lone values.      │
    │                                                                        │
-   │    Lone employs a very simple mark-and-sweep garbage collector.        │
-   │    It walks through the whole interpreter, including the processor     │
-   │    stack and registers, looking for pointers that fall within the      │
-   │    ranges of each allocated value heap and marking them as used.       │
-   │    The purpose of the heap is to enable more efficient pointer         │
-   │    ranging computations so as to avoid the need to quadratically       │
-   │    check every discovered pointer against every managed pointer.       │
-   │    Once all reachable pointers are marked, the garbage collector       │
-   │    sweeps through the value heap, killing all unmarked values          │
-   │    by marking them as unused. Future lone value allocations            │
-   │    may simply return these objects, thereby resurrecting them.         │
+   │    Lone employs a mark-and-sweep garbage collector. It marks every     │
+   │    value reachable from the roots of the interpreter and sweeps        │
+   │    through the value heap, killing all unmarked values by marking      │
+   │    them as unused. Future lone value allocations may simply return     │
+   │    these objects, thereby resurrecting them.                           │
+   │                                                                        │
+   │    Marking does not recurse. Marked values whose children are yet      │
+   │    to be marked are pushed onto an explicit mark stack. List spines    │
+   │    are followed in place rather than pushed, and large vectors and     │
+   │    tables are marked in chunks, the rest of them pushed back onto      │
+   │    the stack, so marking long lists and deep trees takes bounded       │
+   │    native stack space.                                                 │
+   │                                                                        │
+   │    The roots are precise. Besides the values referenced by the         │
+   │    interpreter itself, C code registers the addresses of variables     │
+   │    holding values on a shadow stack before calling anything that       │
+   │    might allocate. Functions save the height of the shadow stack,      │
+   │    root their variables and restore the saved height before they       │
+   │    return. Values passed as arguments are rooted by the functions      │
+   │    that receive them, so freshly created values may be passed on       │
+   │    directly. The stack is only scanned conservatively, looking for     │
+   │    words that point into the value heaps, when Linux fails to          │
+   │    provide memory since that may happen anywhere, or when the          │
+   │    conservative fallback is enabled. Heaps are indexed by address,     │
+   │    so the heap a word points into is found by binary search. Words     │
+   │    must point exactly at the start of a value to be considered.        │
    │                                                                        │
    │    When a value heap is allocated, all values within it are dead.      │
-   │    After each garbage collection cycle, completely dead heaps          │
+   │    Once a cycle has finished sweeping, completely dead heaps           │
    │    are deallocated, thereby freeing up memory for other uses.          │
    │                                                                        │
+   │    Allocating values triggers a garbage collection cycle once          │
+   │    enough values or bytes have been allocated since the last one.      │
+   │    The thresholds are proportional to the memory that survived         │
+   │    the last cycle, growing further when most of it survived:           │
+   │    collecting often is a waste of time if little garbage is found.     │
+   │    A cycle is also triggered when Linux fails to provide memory,       │
+   │    right before the allocation is retried.                             │
+   │                                                                        │
+   │    Every heap counts its live values and tracks which of them are      │
+   │    live in a bitmap. Heaps with at least one dead value are linked     │
+   │    into the list of available heaps, which is rebuilt after every      │
+   │    garbage collection cycle. Allocating a value takes the first        │
+   │    dead value of the first available heap, so the cost does not        │
+   │    depend on the number of live values.                                │
+   │                                                                        │
+   │    Marks are kept in a separate bitmap of every heap rather than in    │
+   │    the values themselves. Heaps are aligned to their size rounded up   │
+   │    to a power of two, so the heap of a value is found by masking its   │
+   │    address. Marking never writes to the values it visits, sweeping     │
+   │    finds dead values a byte of the bitmaps at a time, and clearing     │
+   │    the marks for the next cycle is a single pass over the bitmap.      │
+   │                                                                        │
+   │    Sweeping is lazy. Major cycles only mark values, leaving every      │
+   │    heap unswept. Whenever no available heap is left, the allocator     │
+   │    sweeps the next unswept heap and allocates from it, so sweeping     │
+   │    is spread across allocations and the pause of the cycle consists    │
+   │    of marking alone. The next cycle depends on the marks and must      │
+   │    finish sweeping first. Explicit collections and those triggered     │
+   │    by Linux failing to provide memory sweep everything right away.     │
+   │                                                                        │
+   │    Sweeping may also happen in the background. Major cycles then hand  │
+   │    the unswept heaps over to a helper thread which sweeps them and     │
+   │    deallocates the dead ones while the interpreter continues. Every    │
+   │    heap is claimed by whichever thread gets to it first, and the       │
+   │    allocator only takes values from heaps that have already been       │
+   │    swept. Values in unswept heaps must not be written to, so the       │
+   │    write barrier sweeps the heap of the value or waits for it first.   │
+   │    The memory allocator takes a lock while other threads may be using  │
+   │    it. The next cycle sweeps whatever is left and waits for the        │
+   │    helper to finish.                                                   │
+   │                                                                        │
+   │    Most values die young. Newly allocated values are placed in the     │
+   │    young generation and recorded in the nursery bitmap of their heap.  │
+   │    Values that survive a cycle are promoted to the old generation.     │
+   │    Minor cycles only mark and sweep young values: old values are       │
+   │    assumed to be alive, so the cost is proportional to the number      │
+   │    of young values rather than to the size of the heap. Heaps with     │
+   │    young values are linked into a list so that minor cycles need       │
+   │    not visit the other heaps at all. A major cycle collects            │
+   │    everything once the old generation has grown enough since the       │
+   │    last major cycle.                                                   │
+   │                                                                        │
+   │    Old values which reference young values are also roots of minor     │
+   │    cycles. Functions that store values into existing lists, vectors    │
+   │    and tables pass through a write barrier which adds the old value    │
+   │    to the remembered set the first time it is given a young value.     │
+   │    Vectors can be large, so their individual elements are remembered   │
+   │    instead: minor cycles need not scan all of their elements.          │
+   │    Values must never be stored into other values by any other means    │
+   │    after their creation.                                               │
+   │                                                                        │
+   │    Major cycles may also be incremental. Marking then proceeds in      │
+   │    slices of bounded size interleaved with allocation, following       │
+   │    the tri-color invariant: white values are unmarked, gray values     │
+   │    are marked but their children are not, black values are marked      │
+   │    along with their children. Gray values are kept in the mark stack.  │
+   │    The write barrier grays any value stored into a marked value,       │
+   │    so black values never point to white values. Values allocated       │
+   │    while marking start out white. Once no gray values remain, the      │
+   │    roots are scanned again, the resulting gray values are marked       │
+   │    and the heap is swept. Every pause is measured and recorded         │
+   │    in a histogram of power of two microsecond buckets.                 │
+   │                                                                        │
+   │    Marking may also be parallel. Helper threads created with clone     │
+   │    share the address space of the interpreter and sleep on a futex     │
+   │    until a cycle marks all remaining gray values at once. The gray     │
+   │    values found by scanning the roots are dealt out to the helpers,    │
+   │    every marker works through its own mark stack and steals values     │
+   │    from the others once it runs out. Marks are set atomically so       │
+   │    every value is claimed by exactly one marker. Marking ends once no  │
+   │    marker finds anything left to steal. Incremental slices always      │
+   │    mark on the thread of the interpreter alone.                        │
+   │                                                                        │
+   │    Weak references of tables are not followed while marking, the       │
+   │    tables are recorded instead. Once no gray values remain, the        │
+   │    values of ephemerons whose keys have been marked are marked in      │
+   │    turn, repeatedly, since that may mark more keys. Then entries       │
+   │    whose weak references point to unmarked values are removed from     │
+   │    every recorded table. Compaction copies weak references like any    │
+   │    other, their entries are cleared by the next cycle.                 │
+   │                                                                        │
+   │    Sweeping leaves survivors scattered across partially filled         │
+   │    heaps. When a major cycle finds the heaps mostly empty, they are    │
+   │    compacted at the next safe point: survivors are copied              │
+   │    breadth first into fresh heaps as in Cheney's algorithm, leaving    │
+   │    forwarding addresses behind, and every reference is updated.        │
+   │    Lists end up laid out in the order they are walked and the old      │
+   │    heaps are deallocated. Moving values requires precise roots and     │
+   │    no C code may be holding values that are not rooted, so the only    │
+   │    safe points are between the top level expressions of the            │
+   │    outermost module being loaded. Symbols are hashed by address,       │
+   │    so tables are rehashed after their keys have moved.                 │
+   │                                                                        │
    ╰────────────────────────────────────────────────────────────────────────╯ */
 
 struct lone_lisp_heap {
 	struct lone_lisp_heap *next;
+	struct lone_lisp_heap *next_available;
+	struct lone_lisp_heap *next_young;
+	struct lone_lisp_heap *next_unswept;
+	size_t live;
+	size_t young;
+	bool unswept;
+	bool claimed;            /* being swept by some thread */
+	unsigned char occupied[(LONE_LISP_HEAP_VALUE_COUNT + 7) / 8];
+	unsigned char nursery[(LONE_LISP_HEAP_VALUE_COUNT + 7) / 8];
+	unsigned char marks[(LONE_LISP_HEAP_VALUE_COUNT + 7) / 8];
 	struct lone_lisp_heap_value values[LONE_LISP_HEAP_VALUE_COUNT];
 };
 
@@ -18,4 +18,19 @@ struct lone_bytes lone_lisp_join(struct lone_lisp *lone,
 struct lone_bytes lone_lisp_concatenate(struct lone_lisp *lone,
 		struct lone_lisp_value arguments, lone_lisp_predicate_function is_valid);
 
+/* ╭────────────────────────────────────────────────────────────────────────╮
+   │                                                                        │
+   │    The scratch variants allocate the result in the given scratch       │
+   │    memory instead. They are meant for temporary results which do       │
+   │    not outlive the scope that owns the scratch memory.                 │
+   │                                                                        │
+   ╰────────────────────────────────────────────────────────────────────────╯ */
+
+struct lone_bytes lone_lisp_join_scratch(struct lone_lisp *lone, struct lone_memory_scratch *scratch,
+		struct lone_lisp_value separator, struct lone_lisp_value arguments,
+		lone_lisp_predicate_function is_valid);
+
+struct lone_bytes lone_lisp_concatenate_scratch(struct lone_lisp *lone, struct lone_memory_scratch *scratch,
+		struct lone_lisp_value arguments, lone_lisp_predicate_function is_valid);
+
 #endif /* LONE_LISP_UTILITIES_HEADER */
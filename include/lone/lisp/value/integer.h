@@ -8,10 +8,13 @@
 /* ╭────────────────────────────────────────────────────────────────────────╮
    │                                                                        │
    │    Lone integers are currently signed fixed-length integers.           │
+   │    One bit of the word is taken by the tag: integers wrap around       │
+   │    at 63 bits.                                                         │
    │                                                                        │
    ╰────────────────────────────────────────────────────────────────────────╯ */
 
 struct lone_lisp_value lone_lisp_integer_create(lone_lisp_integer integer);
+lone_lisp_integer lone_lisp_integer_of(struct lone_lisp_value integer);
 
 struct lone_lisp_value lone_lisp_integer_parse(struct lone_lisp *lone,
 		unsigned char *digits, size_t count);
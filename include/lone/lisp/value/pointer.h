@@ -12,6 +12,8 @@
    ╰────────────────────────────────────────────────────────────────────────╯ */
 
 struct lone_lisp_value lone_lisp_pointer_create(void *pointer, enum lone_lisp_pointer_type type);
+union lone_lisp_pointer lone_lisp_pointer_of(struct lone_lisp_value pointer);
+enum lone_lisp_pointer_type lone_lisp_pointer_type_of(struct lone_lisp_value pointer);
 
 /* ╭────────────────────────────────────────────────────────────────────────╮
    │                                                                        │
@@ -14,6 +14,9 @@
 struct lone_lisp_value lone_lisp_table_create(struct lone_lisp *lone,
 		size_t capacity, struct lone_lisp_value prototype);
 
+struct lone_lisp_value lone_lisp_table_create_weak(struct lone_lisp *lone,
+		size_t capacity, enum lone_lisp_table_weakness weakness);
+
 struct lone_lisp_value lone_lisp_table_get(struct lone_lisp *lone,
 		struct lone_lisp_value table, struct lone_lisp_value key);
 
@@ -23,6 +26,8 @@ void lone_lisp_table_set(struct lone_lisp *lone, struct lone_lisp_value table,
 void lone_lisp_table_delete(struct lone_lisp *lone,
 		struct lone_lisp_value table, struct lone_lisp_value key);
 
+void lone_lisp_table_rehash(struct lone_lisp *lone, struct lone_lisp_value table);
+
 size_t lone_lisp_table_count(struct lone_lisp_value table);
 struct lone_lisp_value lone_lisp_table_key_at(struct lone_lisp_value table, lone_size i);
 struct lone_lisp_value lone_lisp_table_value_at(struct lone_lisp_value table, lone_size i);
@@ -32,4 +32,37 @@ lone_reallocate(struct lone_system *system, void *pointer, size_t size);
 
 void lone_deallocate(struct lone_system *system, void *pointer);
 
+/* ╭────────────────────────────────────────────────────────────────────────╮
+   │                                                                        │
+   │    Releasing a block hands memory that is not in use over to the       │
+   │    allocator. New arenas release their single block this way.          │
+   │    The largest free block is a measure of heap fragmentation.          │
+   │                                                                        │
+   │    Trimming gives free memory back to Linux: mapped arenas which       │
+   │    are entirely free are unmapped and the pages inside other large     │
+   │    free blocks are discarded. The resident set size then follows       │
+   │    the memory in use instead of its historical peak.                   │
+   │                                                                        │
+   │    Reclaiming calls the function registered by the user of the         │
+   │    allocator to free up memory when Linux fails to provide more.       │
+   │    It returns whether the failed request is worth retrying.            │
+   │    The allocator is locked while other threads may be using it,        │
+   │    the lock is released while reclaiming since that function may       │
+   │    wait for those threads.                                             │
+   │                                                                        │
+   │    Allocations are sampled once a sampling interval is set: the        │
+   │    sampler is told about every allocation that brings the bytes        │
+   │    allocated since the last sample to a random distance around the     │
+   │    interval, and about the deallocation of every block it chose to     │
+   │    keep track of. Aligned allocations, such as the heaps of the lisp   │
+   │    interpreter, are never sampled. Their users sample what they store  │
+   │    in them instead.                                                    │
+   │                                                                        │
+   ╰────────────────────────────────────────────────────────────────────────╯ */
+
+void lone_memory_release(struct lone_system *system, struct lone_memory *block);
+size_t lone_memory_largest_free_block(struct lone_system *system);
+void lone_memory_trim(struct lone_system *system);
+bool lone_memory_reclaim(struct lone_system *system);
+
 #endif /* LONE_MEMORY_ALLOCATOR_HEADER */
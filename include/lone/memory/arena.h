@@ -0,0 +1,25 @@
+/* SPDX-License-Identifier: AGPL-3.0-or-later */
+
+#ifndef LONE_MEMORY_ARENA_HEADER
+#define LONE_MEMORY_ARENA_HEADER
+
+#include <lone/types.h>
+
+/* ╭────────────────────────────────────────────────────────────────────────╮
+   │                                                                        │
+   │    Arenas are the large regions of memory that the allocator           │
+   │    carves blocks out of. Initializing an arena creates a single        │
+   │    free block spanning it and releases it to the allocator.            │
+   │    Mapping an arena obtains enough memory from Linux to satisfy        │
+   │    an allocation of the given size, but never less than the            │
+   │    configured arena size so that small allocations are amortized.      │
+   │    Unmapping an arena returns it to Linux; its blocks must have        │
+   │    already been unlinked from the allocator.                           │
+   │                                                                        │
+   ╰────────────────────────────────────────────────────────────────────────╯ */
+
+struct lone_memory *lone_memory_arena_initialize(struct lone_system *system, struct lone_bytes memory, bool mapped);
+struct lone_memory *lone_memory_arena_map(struct lone_system *system, size_t minimum_size);
+void lone_memory_arena_unmap(struct lone_system *system, struct lone_memory_arena *arena);
+
+#endif /* LONE_MEMORY_ARENA_HEADER */
@@ -0,0 +1,27 @@
+/* SPDX-License-Identifier: AGPL-3.0-or-later */
+
+#ifndef LONE_MEMORY_SCRATCH_HEADER
+#define LONE_MEMORY_SCRATCH_HEADER
+
+#include <lone/definitions.h>
+#include <lone/types.h>
+
+void lone_memory_scratch_initialize(struct lone_memory_scratch *scratch,
+		struct lone_system *system, size_t chunk_size);
+
+void *
+__attribute__((malloc, alloc_size(2), assume_aligned(LONE_ALIGNMENT)))
+lone_memory_scratch_allocate(struct lone_memory_scratch *scratch, size_t size);
+
+void *
+__attribute__((malloc, alloc_size(2), assume_aligned(LONE_ALIGNMENT)))
+lone_memory_scratch_allocate_uninitialized(struct lone_memory_scratch *scratch, size_t size);
+
+void *
+__attribute__((alloc_size(4)))
+lone_memory_scratch_reallocate(struct lone_memory_scratch *scratch, void *pointer, size_t old_size, size_t new_size);
+
+void lone_memory_scratch_reset(struct lone_memory_scratch *scratch);
+void lone_memory_scratch_finalize(struct lone_memory_scratch *scratch);
+
+#endif /* LONE_MEMORY_SCRATCH_HEADER */
@@ -310,6 +310,83 @@ bool lone_bytes_write_s32be(struct lone_bytes bytes, lone_size offset, lone_s32
 bool lone_bytes_write_u64be(struct lone_bytes bytes, lone_size offset, lone_u64 u64);
 bool lone_bytes_write_s64be(struct lone_bytes bytes, lone_size offset, lone_s64 s64);
 
+/* ╭────────────────────┨ LONE LISP MEMORY ALLOCATION ┠─────────────────────╮
+   │                                                                        │
+   │    Lone implements a block-based memory allocator.                     │
+   │    Free memory blocks are segregated by size into bins.                │
+   │    They will be split into smaller units when allocated                │
+   │    and merged together with free neighbors when deallocated.           │
+   │                                                                        │
+   │    Memory blocks are segments prefixed by a block descriptor           │
+   │    that tracks its size, allocation status as well as pointers         │
+   │    to surrounding memory blocks. It is simple to obtain a pointer      │
+   │    to the block descriptor from a pointer to the memory block:         │
+   │    simply subtract the block descriptor's size from the pointer.       │
+   │                                                                        │
+   │    Free blocks are additionally linked into the free list of their     │
+   │    size class. Half of the size classes are exact: they hold blocks    │
+   │    of one size only, in multiples of the alignment. The other half     │
+   │    hold blocks whose sizes lie between consecutive powers of two.      │
+   │    A bitmap tracks which free lists are not empty, allowing the        │
+   │    smallest suitable size class to be found in constant time.          │
+   │                                                                        │
+   │    Large blocks are mapped directly from Linux instead. They are       │
+   │    not linked to any other blocks and are unmapped when deallocated.   │
+   │    Resizing them remaps their pages without copying any data.          │
+   │    Their size is the size that was requested, rounded up to the        │
+   │    alignment; the rest of their last page is kept zero filled.         │
+   │                                                                        │
+   │    Blocks aligned beyond the minimum alignment are always carved out   │
+   │    of arenas. A free block large enough to hold the aligned block at   │
+   │    any offset is found, and the memory that precedes the aligned       │
+   │    address is split off and released as a free block of its own.       │
+   │                                                                        │
+   │    Trimming returns the whole pages inside large free blocks to        │
+   │    Linux. Their contents are discarded but free memory is never        │
+   │    read before it is allocated and zero filled anyway. Trimmed         │
+   │    blocks are flagged so that they are not trimmed again until         │
+   │    they are coalesced with memory that was in use.                     │
+   │                                                                        │
+   ╰────────────────────────────────────────────────────────────────────────╯ */
+struct lone_memory {
+	struct lone_memory *prev, *next;              /* neighboring blocks */
+	struct lone_memory *prev_free, *next_free;    /* blocks of the same size class */
+	bool free;
+	bool mapped;
+	bool trimmed;
+	bool sampled;                                 /* reported to the sampler when deallocated */
+	size_t size;
+	unsigned char pointer[];
+};
+
+#define LONE_MEMORY_SIZE_CLASSES (8 * sizeof(unsigned long))
+#define LONE_MEMORY_EXACT_SIZE_CLASSES (LONE_MEMORY_SIZE_CLASSES / 2)
+
+/* ╭────────────────────────────────────────────────────────────────────────╮
+   │                                                                        │
+   │    Memory blocks are carved out of arenas: large contiguous regions    │
+   │    of memory that begin with an arena descriptor followed by a         │
+   │    single free block spanning all of the remaining space.              │
+   │                                                                        │
+   │    The first arena is the statically allocated bootstrap memory.       │
+   │    When no free block can satisfy an allocation, lone maps a new       │
+   │    arena with mmap and links its blocks into the block list.           │
+   │    If huge pages are enabled, arenas are aligned to and sized in       │
+   │    multiples of the huge page size and transparent huge pages are      │
+   │    requested for them. Value heaps are allocated from arenas and       │
+   │    so are backed by huge pages as well, reducing TLB misses.           │
+   │    Blocks are only ever coalesced with adjacent blocks which are       │
+   │    necessarily in the same arena. Mapped arenas whose memory has       │
+   │    been coalesced back into a single free block are unmapped when      │
+   │    the allocator is trimmed.                                           │
+   │                                                                        │
+   ╰────────────────────────────────────────────────────────────────────────╯ */
+struct lone_memory_arena {
+	struct lone_memory_arena *next;
+	size_t size;              /* total size of the arena in bytes */
+	bool mapped;              /* whether the arena was obtained via mmap */
+} __attribute__((aligned(LONE_ALIGNMENT)));
+
 /* ╭────────────────────────────────────────────────────────────────────────╮
    │                                                                        │
    │    The lone system structure represents low level system state         │
@@ -318,7 +395,42 @@ bool lone_bytes_write_s64be(struct lone_bytes bytes, lone_size offset, lone_s64
    ╰────────────────────────────────────────────────────────────────────────╯ */
 
 struct lone_system {
-	struct lone_memory *memory;
+	struct {
+		struct lone_memory *blocks;
+		struct lone_memory_arena *arenas;
+		struct {
+			struct lone_memory *lists[LONE_MEMORY_SIZE_CLASSES];
+			unsigned long occupied;
+		} free;
+		struct {
+			size_t allocations;
+			size_t deallocations;
+			size_t allocated;        /* bytes in allocated blocks */
+			struct {
+				size_t blocks;
+				size_t bytes;
+			} free;
+			size_t arenas;
+			size_t mapped;           /* bytes mapped from Linux */
+			size_t trimmed;          /* bytes returned to Linux */
+		} statistics;
+		size_t page_size;
+		bool huge_pages;
+		struct {
+			void (*function)(void *context);
+			void *context;
+		} reclaim;
+		struct {
+			bool (*allocated)(void *context, void *pointer, size_t size);
+			void (*deallocated)(void *context, void *pointer);
+			void *context;
+			size_t interval;     /* bytes between samples, zero stops sampling */
+			size_t countdown;    /* bytes left until the next sample */
+			unsigned long random;   /* varies the intervals around their mean */
+		} sampler;
+		size_t threads;              /* other threads which may be allocating right now */
+		lone_u32 lock;               /* serializes the allocator while there are any */
+	} memory;
 	struct {
 		struct {
 			unsigned long offset_basis;
@@ -326,25 +438,29 @@ struct lone_system {
 	} hash;
 };
 
-/* ╭────────────────────┨ LONE LISP MEMORY ALLOCATION ┠─────────────────────╮
+/* ╭────────────────────────────────────────────────────────────────────────╮
    │                                                                        │
-   │    Lone implements a block-based memory allocator.                     │
-   │    Memory blocks are allocated on a first fit basis.                   │
-   │    They will be split into smaller units when allocated                │
-   │    and merged together with free neighbors when deallocated.           │
+   │    Scratch memory is bump allocated out of chunks obtained from        │
+   │    the general allocator. Its allocations cannot be deallocated        │
+   │    individually: they are all released in one step when the           │
+   │    scratch memory is reset or finalized. This makes it suitable        │
+   │    for temporary data whose lifetime is bounded by a single scope.     │
    │                                                                        │
-   │    Memory blocks are segments prefixed by a block descriptor           │
-   │    that tracks its size, allocation status as well as pointers         │
-   │    to surrounding memory blocks. It is simple to obtain a pointer      │
-   │    to the block descriptor from a pointer to the memory block:         │
-   │    simply subtract the block descriptor's size from the pointer.       │
+   │    Each new chunk is at least twice as large as the previous one       │
+   │    so that the number of chunks grows logarithmically.                 │
    │                                                                        │
    ╰────────────────────────────────────────────────────────────────────────╯ */
-struct lone_memory {
-	struct lone_memory *prev, *next;
-	int free;
+struct lone_memory_scratch_chunk {
+	struct lone_memory_scratch_chunk *next;
 	size_t size;
+	size_t used;
 	unsigned char pointer[];
+} __attribute__((aligned(LONE_ALIGNMENT)));
+
+struct lone_memory_scratch {
+	struct lone_system *system;
+	struct lone_memory_scratch_chunk *chunks;
+	size_t chunk_size;
 };
 
 #endif /* LONE_TYPES_HEADER */
@@ -3,8 +3,14 @@
 #ifndef LONE_UTILITIES_HEADER
 #define LONE_UTILITIES_HEADER
 
+#include <lone/types.h>
+
 long lone_min(long x, long y);
 long lone_max(long x, long y);
 
+char *lone_environment_get(char **environment, char *name);
+
+size_t lone_random_interval(unsigned long *state, size_t mean);
+
 #endif /* LONE_UTILITIES_HEADER */
 
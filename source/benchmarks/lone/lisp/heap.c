@@ -0,0 +1,187 @@
+/* SPDX-License-Identifier: AGPL-3.0-or-later */
+
+#include <lone/types.h>
+#include <lone/system.h>
+#include <lone/auxiliary_vector.h>
+
+#include <lone/lisp.h>
+#include <lone/lisp/definitions.h>
+#include <lone/lisp/garbage_collector.h>
+
+#include <lone/lisp/value/list.h>
+#include <lone/lisp/value/integer.h>
+#include <lone/lisp/value/vector.h>
+
+#include <lone/benchmark.h>
+
+#define LONE_BENCHMARK_ALLOCATED_VALUES 10000
+#define LONE_BENCHMARK_LIVE_VALUES 50000
+#define LONE_BENCHMARK_LARGE_HEAP_LISTS 256
+#define LONE_BENCHMARK_LARGE_HEAP_LIST_VALUES 2000
+#define LONE_BENCHMARK_DEAD_VECTORS 50000
+
+static struct lone_auxiliary_vector *auxiliary_vector;
+static void *native_stack;
+
+/* the context selects whether arenas are backed by huge pages */
+static void initialize(struct lone_benchmark *benchmark, struct lone_system *system, struct lone_lisp *lone)
+{
+	static unsigned char __attribute__((aligned(LONE_ALIGNMENT))) bytes[LONE_LISP_MEMORY_SIZE];
+
+	lone_system_initialize(system, LONE_BYTES_VALUE(sizeof(bytes), bytes),
+			lone_auxiliary_vector_random(auxiliary_vector),
+			lone_auxiliary_vector_page_size(auxiliary_vector));
+
+	system->memory.huge_pages = benchmark->context != 0;
+
+	lone_lisp_initialize(lone, system, native_stack);
+}
+
+static struct lone_lisp_value build_list(struct lone_lisp *lone, size_t count)
+{
+	struct lone_lisp_value list = lone_lisp_nil();
+	size_t i;
+
+	for (i = 0; i < count; ++i) {
+		list = lone_lisp_list_create(lone, lone_lisp_integer_create((lone_lisp_integer) i), list);
+	}
+
+	return list;
+}
+
+static LONE_BENCHMARK_FUNCTION(benchmark_lone_lisp_heap_allocate)
+{
+	struct lone_system system;
+	struct lone_lisp lone;
+	size_t i;
+
+	initialize(benchmark, &system, &lone);
+
+	for (i = 0; i < benchmark->iterations; ++i) {
+		lone_benchmark_start(benchmark);
+		build_list(&lone, LONE_BENCHMARK_ALLOCATED_VALUES);
+		lone_benchmark_stop(benchmark);
+
+		lone_lisp_garbage_collector(&lone);
+	}
+}
+
+static LONE_BENCHMARK_FUNCTION(benchmark_lone_lisp_garbage_collector)
+{
+	struct lone_lisp_value live;
+	struct lone_system system;
+	struct lone_lisp lone;
+	size_t i;
+
+	initialize(benchmark, &system, &lone);
+
+	/* rooted and marked on every collection */
+	live = build_list(&lone, LONE_BENCHMARK_LIVE_VALUES);
+	lone_lisp_root(&lone, &live);
+
+	lone_benchmark_start(benchmark);
+
+	for (i = 0; i < benchmark->iterations; ++i) {
+		lone_lisp_garbage_collector(&lone);
+	}
+
+	lone_benchmark_stop(benchmark);
+}
+
+/* many independent lists give every marking thread something to steal, the context is the number of helpers */
+static LONE_BENCHMARK_FUNCTION(benchmark_lone_lisp_garbage_collector_parallel)
+{
+	struct lone_lisp_value live;
+	struct lone_system system;
+	struct lone_lisp lone;
+	size_t i;
+
+	initialize(benchmark, &system, &lone);
+
+	system.memory.huge_pages = false;
+	lone.garbage_collector.parallel.threads = (size_t) benchmark->context;
+
+	live = lone_lisp_vector_create(&lone, LONE_BENCHMARK_LARGE_HEAP_LISTS);
+	lone_lisp_root(&lone, &live);
+
+	for (i = 0; i < LONE_BENCHMARK_LARGE_HEAP_LISTS; ++i) {
+		lone_lisp_vector_push(&lone, live, build_list(&lone, LONE_BENCHMARK_LARGE_HEAP_LIST_VALUES));
+	}
+
+	lone_benchmark_start(benchmark);
+
+	for (i = 0; i < benchmark->iterations; ++i) {
+		lone_lisp_garbage_collector(&lone);
+	}
+
+	lone_benchmark_stop(benchmark);
+
+	lone_lisp_garbage_collector_finalize(&lone);
+}
+
+/* dead vectors own memory which sweeping deallocates, the context selects background sweeping */
+static LONE_BENCHMARK_FUNCTION(benchmark_lone_lisp_garbage_collector_background)
+{
+	struct lone_lisp_value live;
+	struct lone_system system;
+	struct lone_lisp lone;
+	size_t i, j;
+
+	initialize(benchmark, &system, &lone);
+
+	system.memory.huge_pages = false;
+	lone.garbage_collector.sweeper.enabled = benchmark->context != 0;
+
+	live = lone_lisp_vector_create(&lone, LONE_BENCHMARK_LARGE_HEAP_LISTS);
+	lone_lisp_root(&lone, &live);
+
+	for (i = 0; i < LONE_BENCHMARK_LARGE_HEAP_LISTS; ++i) {
+		lone_lisp_vector_push(&lone, live, build_list(&lone, LONE_BENCHMARK_LARGE_HEAP_LIST_VALUES));
+	}
+
+	for (i = 0; i < benchmark->iterations; ++i) {
+		for (j = 0; j < LONE_BENCHMARK_DEAD_VECTORS; ++j) {
+			lone_lisp_vector_create(&lone, 8);
+		}
+
+		/* the next allocation starts a major cycle, the allocations after it find the heaps unswept */
+		lone.garbage_collector.allocations = LONE_LISP_GARBAGE_COLLECTOR_NURSERY_VALUES;
+		lone.garbage_collector.threshold.values = 0;
+
+		lone_benchmark_start(benchmark);
+		build_list(&lone, LONE_BENCHMARK_ALLOCATED_VALUES);
+		lone_benchmark_stop(benchmark);
+
+		lone_lisp_garbage_collector(&lone);
+	}
+
+	lone_lisp_garbage_collector_finalize(&lone);
+}
+
+long lone(int argc, char **argv, char **envp, struct lone_auxiliary_vector *auxv)
+{
+	static struct lone_benchmark benchmarks[] = {
+
+		LONE_BENCHMARK_WITH_CONTEXT("lone/lisp/heap/allocate", benchmark_lone_lisp_heap_allocate, false, 20),
+		LONE_BENCHMARK_WITH_CONTEXT("lone/lisp/heap/allocate/huge-pages", benchmark_lone_lisp_heap_allocate, true, 20),
+		LONE_BENCHMARK_WITH_CONTEXT("lone/lisp/garbage-collector", benchmark_lone_lisp_garbage_collector, false, 100),
+		LONE_BENCHMARK_WITH_CONTEXT("lone/lisp/garbage-collector/huge-pages", benchmark_lone_lisp_garbage_collector, true, 100),
+		LONE_BENCHMARK_WITH_CONTEXT("lone/lisp/garbage-collector/parallel/0", benchmark_lone_lisp_garbage_collector_parallel, 0, 20),
+		LONE_BENCHMARK_WITH_CONTEXT("lone/lisp/garbage-collector/parallel/1", benchmark_lone_lisp_garbage_collector_parallel, 1, 20),
+		LONE_BENCHMARK_WITH_CONTEXT("lone/lisp/garbage-collector/parallel/3", benchmark_lone_lisp_garbage_collector_parallel, 3, 20),
+		LONE_BENCHMARK_WITH_CONTEXT("lone/lisp/garbage-collector/parallel/7", benchmark_lone_lisp_garbage_collector_parallel, 7, 20),
+		LONE_BENCHMARK_WITH_CONTEXT("lone/lisp/garbage-collector/background/off", benchmark_lone_lisp_garbage_collector_background, false, 20),
+		LONE_BENCHMARK_WITH_CONTEXT("lone/lisp/garbage-collector/background/on", benchmark_lone_lisp_garbage_collector_background, true, 20),
+
+		LONE_BENCHMARK_NULL(),
+	};
+
+	native_stack = __builtin_frame_address(0);
+	auxiliary_vector = auxv;
+
+	lone_benchmark_run(benchmarks);
+
+	return 0;
+}
+
+#include <lone/architecture/linux/entry_point.c>
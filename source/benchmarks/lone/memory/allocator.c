@@ -0,0 +1,145 @@
+/* SPDX-License-Identifier: AGPL-3.0-or-later */
+
+#include <lone/types.h>
+#include <lone/memory.h>
+#include <lone/memory/allocator.h>
+#include <lone/auxiliary_vector.h>
+
+#include <lone/benchmark.h>
+
+#define LONE_BENCHMARK_LIVE_BLOCKS 16384
+
+static size_t page_size;
+static lone_u64 random_state = 0x9E3779B97F4A7C15;
+
+static size_t random_size(size_t minimum, size_t maximum)
+{
+	random_state ^= random_state << 13;
+	random_state ^= random_state >> 7;
+	random_state ^= random_state << 17;
+
+	return minimum + random_state % (maximum - minimum + 1);
+}
+
+static void initialize(struct lone_system *system)
+{
+	static unsigned char __attribute__((aligned(LONE_ALIGNMENT))) bytes[64 * 1024];
+	lone_memory_initialize(system, LONE_BYTES_VALUE(sizeof(bytes), bytes), page_size);
+}
+
+/* leaves small holes between live blocks, every other block is freed */
+static void fragment(struct lone_system *system, void **live, size_t count, size_t minimum, size_t maximum)
+{
+	size_t i;
+
+	for (i = 0; i < count; ++i) {
+		live[i] = lone_allocate_uninitialized(system, random_size(minimum, maximum));
+	}
+
+	for (i = 0; i < count; i += 2) {
+		lone_deallocate(system, live[i]);
+		live[i] = 0;
+	}
+}
+
+static LONE_BENCHMARK_FUNCTION(benchmark_lone_memory_allocator_fragmented)
+{
+	static void *live[LONE_BENCHMARK_LIVE_BLOCKS];
+	struct lone_system system;
+	void *pointer;
+	size_t i;
+
+	initialize(&system);
+	fragment(&system, live, LONE_BENCHMARK_LIVE_BLOCKS, 16, 128);
+
+	lone_benchmark_start(benchmark);
+
+	/* none of the holes are large enough to satisfy these allocations */
+	for (i = 0; i < benchmark->iterations; ++i) {
+		pointer = lone_allocate_uninitialized(&system, random_size(256, 1024));
+		lone_deallocate(&system, pointer);
+	}
+
+	lone_benchmark_stop(benchmark);
+}
+
+static LONE_BENCHMARK_FUNCTION(benchmark_lone_memory_allocator_churn)
+{
+	static void *live[LONE_BENCHMARK_LIVE_BLOCKS];
+	struct lone_system system;
+	size_t i, slot;
+
+	initialize(&system);
+	fragment(&system, live, LONE_BENCHMARK_LIVE_BLOCKS, 16, 512);
+
+	lone_benchmark_start(benchmark);
+
+	/* replace random live blocks with new blocks of random sizes */
+	for (i = 0; i < benchmark->iterations; ++i) {
+		slot = random_size(0, LONE_BENCHMARK_LIVE_BLOCKS - 1);
+		if (live[slot]) { lone_deallocate(&system, live[slot]); }
+		live[slot] = lone_allocate_uninitialized(&system, random_size(16, 512));
+	}
+
+	lone_benchmark_stop(benchmark);
+}
+
+static LONE_BENCHMARK_FUNCTION(benchmark_lone_memory_allocator_reallocate)
+{
+	struct lone_system system;
+	void *buffer;
+	size_t i;
+
+	initialize(&system);
+	buffer = lone_allocate(&system, LONE_ALIGNMENT);
+
+	lone_benchmark_start(benchmark);
+
+	/* grow a single buffer the way vector pushes do */
+	for (i = 1; i <= benchmark->iterations; ++i) {
+		buffer = lone_reallocate(&system, buffer, i * LONE_ALIGNMENT);
+	}
+
+	lone_benchmark_stop(benchmark);
+}
+
+static LONE_BENCHMARK_FUNCTION(benchmark_lone_memory_allocator_reallocate_large)
+{
+	struct lone_system system;
+	unsigned char *buffer;
+	size_t i, step = 64 * 1024;
+
+	initialize(&system);
+	buffer = lone_allocate(&system, step);
+
+	lone_benchmark_start(benchmark);
+
+	/* grow a multi-megabyte buffer, touching only its last page each time */
+	for (i = 2; i <= benchmark->iterations + 1; ++i) {
+		buffer = lone_reallocate(&system, buffer, i * step);
+		buffer[i * step - 1] = 1;
+	}
+
+	lone_benchmark_stop(benchmark);
+}
+
+long lone(int argc, char **argv, char **envp, struct lone_auxiliary_vector *auxv)
+{
+	static struct lone_benchmark benchmarks[] = {
+
+		LONE_BENCHMARK("lone/memory/allocator/fragmented", benchmark_lone_memory_allocator_fragmented, 100000),
+		LONE_BENCHMARK("lone/memory/allocator/churn", benchmark_lone_memory_allocator_churn, 1000000),
+		LONE_BENCHMARK("lone/memory/allocator/reallocate", benchmark_lone_memory_allocator_reallocate, 20000),
+		LONE_BENCHMARK("lone/memory/allocator/reallocate/large", benchmark_lone_memory_allocator_reallocate_large, 256),
+
+		LONE_BENCHMARK_NULL(),
+	};
+
+	page_size = lone_auxiliary_vector_page_size(auxv);
+
+	lone_benchmark_run(benchmarks);
+
+	return 0;
+}
+
+#include <lone/architecture/linux/entry_point.c>
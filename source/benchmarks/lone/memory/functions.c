@@ -0,0 +1,139 @@
+/* SPDX-License-Identifier: AGPL-3.0-or-later */
+
+#include <lone/types.h>
+#include <lone/memory/functions.h>
+
+#include <lone/benchmark.h>
+
+#define LONE_BENCHMARK_BUFFER_SIZE (1024 * 1024)
+
+static unsigned char a[LONE_BENCHMARK_BUFFER_SIZE + 64], b[LONE_BENCHMARK_BUFFER_SIZE + 64];
+
+/* sizes are passed through the context; offsets keep the data unaligned */
+
+static LONE_BENCHMARK_FUNCTION(benchmark_lone_memory_move)
+{
+	size_t i, count = (size_t) benchmark->context;
+
+	lone_benchmark_start(benchmark);
+
+	for (i = 0; i < benchmark->iterations; ++i) {
+		lone_memory_move(a + 1, b + 3, count);
+		__asm__ volatile ("" :: "r" (b) : "memory");
+	}
+
+	lone_benchmark_stop(benchmark);
+}
+
+static LONE_BENCHMARK_FUNCTION(benchmark_lone_memory_move_overlapping)
+{
+	size_t i, count = (size_t) benchmark->context;
+
+	lone_benchmark_start(benchmark);
+
+	/* destination ahead of source forces a backwards copy */
+	for (i = 0; i < benchmark->iterations; ++i) {
+		lone_memory_move(a + 1, a + 9, count);
+		__asm__ volatile ("" :: "r" (a) : "memory");
+	}
+
+	lone_benchmark_stop(benchmark);
+}
+
+static LONE_BENCHMARK_FUNCTION(benchmark_lone_memory_set)
+{
+	size_t i, count = (size_t) benchmark->context;
+
+	lone_benchmark_start(benchmark);
+
+	for (i = 0; i < benchmark->iterations; ++i) {
+		lone_memory_set(b + 3, (unsigned char) i, count);
+		__asm__ volatile ("" :: "r" (b) : "memory");
+	}
+
+	lone_benchmark_stop(benchmark);
+}
+
+static LONE_BENCHMARK_FUNCTION(benchmark_lone_memory_compare)
+{
+	size_t i, count = (size_t) benchmark->context;
+	volatile int result;
+
+	lone_memory_zero(a, sizeof(a));
+	lone_memory_zero(b, sizeof(b));
+
+	lone_benchmark_start(benchmark);
+
+	/* equal memory must be scanned in its entirety */
+	for (i = 0; i < benchmark->iterations; ++i) {
+		result = lone_memory_compare(a + 1, b + 3, count);
+		__asm__ volatile ("" ::: "memory");
+	}
+
+	lone_benchmark_stop(benchmark);
+	(void) result;
+}
+
+static LONE_BENCHMARK_FUNCTION(benchmark_lone_memory_is_zero)
+{
+	size_t i, count = (size_t) benchmark->context;
+	volatile bool result;
+
+	lone_memory_zero(a, sizeof(a));
+
+	lone_benchmark_start(benchmark);
+
+	for (i = 0; i < benchmark->iterations; ++i) {
+		result = lone_memory_is_zero(a + 1, count);
+		__asm__ volatile ("" ::: "memory");
+	}
+
+	lone_benchmark_stop(benchmark);
+	(void) result;
+}
+
+static LONE_BENCHMARK_FUNCTION(benchmark_lone_c_string_length)
+{
+	size_t i, count = (size_t) benchmark->context;
+	volatile size_t result;
+
+	lone_memory_set(a, 'x', sizeof(a));
+	a[1 + count] = '\0';
+
+	lone_benchmark_start(benchmark);
+
+	for (i = 0; i < benchmark->iterations; ++i) {
+		result = lone_c_string_length((char *) a + 1);
+		__asm__ volatile ("" ::: "memory");
+	}
+
+	lone_benchmark_stop(benchmark);
+	(void) result;
+}
+
+long lone(int argc, char **argv, char **envp, struct lone_auxiliary_vector *auxv)
+{
+	static struct lone_benchmark benchmarks[] = {
+
+		LONE_BENCHMARK_WITH_CONTEXT("lone/memory/functions/move/64", benchmark_lone_memory_move, 64, 10000000),
+		LONE_BENCHMARK_WITH_CONTEXT("lone/memory/functions/move/4096", benchmark_lone_memory_move, 4096, 1000000),
+		LONE_BENCHMARK_WITH_CONTEXT("lone/memory/functions/move/1048576", benchmark_lone_memory_move, 1048576, 2000),
+		LONE_BENCHMARK_WITH_CONTEXT("lone/memory/functions/move/overlapping/4096", benchmark_lone_memory_move_overlapping, 4096, 1000000),
+		LONE_BENCHMARK_WITH_CONTEXT("lone/memory/functions/set/64", benchmark_lone_memory_set, 64, 10000000),
+		LONE_BENCHMARK_WITH_CONTEXT("lone/memory/functions/set/4096", benchmark_lone_memory_set, 4096, 1000000),
+		LONE_BENCHMARK_WITH_CONTEXT("lone/memory/functions/set/1048576", benchmark_lone_memory_set, 1048576, 2000),
+		LONE_BENCHMARK_WITH_CONTEXT("lone/memory/functions/compare/64", benchmark_lone_memory_compare, 64, 10000000),
+		LONE_BENCHMARK_WITH_CONTEXT("lone/memory/functions/compare/4096", benchmark_lone_memory_compare, 4096, 1000000),
+		LONE_BENCHMARK_WITH_CONTEXT("lone/memory/functions/is-zero/4096", benchmark_lone_memory_is_zero, 4096, 1000000),
+		LONE_BENCHMARK_WITH_CONTEXT("lone/memory/functions/c-string-length/64", benchmark_lone_c_string_length, 64, 10000000),
+		LONE_BENCHMARK_WITH_CONTEXT("lone/memory/functions/c-string-length/4096", benchmark_lone_c_string_length, 4096, 1000000),
+
+		LONE_BENCHMARK_NULL(),
+	};
+
+	lone_benchmark_run(benchmarks);
+
+	return 0;
+}
+
+#include <lone/architecture/linux/entry_point.c>
@@ -9,15 +9,19 @@
 #include <lone.h>
 
 #include <lone/system.h>
+#include <lone/utilities.h>
 #include <lone/auxiliary_vector.h>
 
 #include <lone/lisp.h>
 #include <lone/lisp/definitions.h>
 #include <lone/lisp/types.h>
+#include <lone/lisp/image.h>
+#include <lone/lisp/profiler.h>
 
 #include <lone/lisp/module.h>
 #include <lone/lisp/modules/intrinsic.h>
 #include <lone/lisp/modules/embedded.h>
+#include <lone/lisp/modules/intrinsic/linux.h>
 
 /* ╭───────────────────────┨ LONE LISP ENTRY POINT ┠────────────────────────╮
    │                                                                        │
@@ -29,6 +33,7 @@
    │    During early initialization, lone has no dynamic memory             │
    │    allocation capabilities and so this function statically             │
    │    allocates 64 KiB of memory for the early bootstrapping process.     │
+   │    Further memory is mapped from Linux on demand as the heap grows.    │
    │                                                                        │
    ╰────────────────────────────────────────────────────────────────────────╯ */
 
@@ -39,13 +44,26 @@ long lone(int argc, char **argv, char **envp, struct lone_auxiliary_vector *auxv
 	void *stack = __builtin_frame_address(0);
 	static unsigned char __attribute__((aligned(LONE_ALIGNMENT))) bytes[LONE_LISP_MEMORY_SIZE];
 	struct lone_bytes memory = { sizeof(bytes), bytes }, random = lone_auxiliary_vector_random(auxv);
+	size_t page_size = lone_auxiliary_vector_page_size(auxv);
+	lone_elf_native_segment *segment = lone_auxiliary_vector_embedded_segment(auxv);
 	struct lone_system system;
 	struct lone_lisp lone;
+	struct lone_bytes image;
+	char *profile, *profile_format;
 
-	lone_system_initialize(&system, memory, random);
+	lone_system_initialize(&system, memory, random, page_size);
 	lone_lisp_initialize(&lone, &system, stack);
 
-	lone_lisp_modules_intrinsic_initialize(&lone, argc, argv, envp, auxv);
+	/* the environment is read before the linux module modifies it */
+	image = lone_lisp_image_map(&lone, envp, segment);
+	profile = lone_environment_get(envp, LONE_LISP_PROFILER_VARIABLE);
+	profile_format = lone_environment_get(envp, LONE_LISP_PROFILER_FORMAT_VARIABLE);
+
+	if (lone_lisp_image_load(&lone, image)) {
+		lone_lisp_modules_intrinsic_linux_bind(&lone, argc, argv, envp, auxv);
+	} else {
+		lone_lisp_modules_intrinsic_initialize(&lone, argc, argv, envp, auxv);
+	}
 
 	lone_lisp_module_path_push_all(&lone, 4,
 
@@ -56,9 +74,13 @@ long lone(int argc, char **argv, char **envp, struct lone_auxiliary_vector *auxv
 
 	);
 
-	lone_lisp_modules_embedded_load(&lone, lone_auxiliary_vector_embedded_segment(auxv));
+	if (profile) { lone_lisp_profiler_start(&lone, LONE_LISP_PROFILER_INTERVAL); }
+
+	lone_lisp_modules_embedded_load(&lone, segment);
 
 	lone_lisp_module_load_null_from_standard_input(&lone);
 
+	if (profile) { lone_lisp_profiler_report_to_file(&lone, profile, profile_format); }
+
 	return 0;
 }
@@ -0,0 +1,63 @@
+/* SPDX-License-Identifier: AGPL-3.0-or-later */
+
+#include <lone/benchmark.h>
+#include <lone/linux.h>
+
+#define LINUX_WRITE_LITERAL(fd, c_string_literal)                                                  \
+	linux_write(fd, c_string_literal, sizeof(c_string_literal) - 1)
+
+static lone_u64 lone_benchmark_now(void)
+{
+	struct __kernel_timespec now;
+
+	if (linux_clock_gettime(CLOCK_MONOTONIC, &now) < 0) { linux_exit(-1); }
+
+	return (lone_u64) now.tv_sec * 1000000000 + (lone_u64) now.tv_nsec;
+}
+
+void lone_benchmark_start(struct lone_benchmark *benchmark)
+{
+	benchmark->nanoseconds.started = lone_benchmark_now();
+}
+
+void lone_benchmark_stop(struct lone_benchmark *benchmark)
+{
+	benchmark->nanoseconds.elapsed += lone_benchmark_now() - benchmark->nanoseconds.started;
+}
+
+static void lone_benchmark_write_unsigned(int fd, lone_u64 n)
+{
+	unsigned char digits[20], *digit = digits + sizeof(digits);
+
+	do {
+		*--digit = '0' + n % 10;
+		n /= 10;
+	} while (n);
+
+	linux_write(fd, digit, (size_t) (digits + sizeof(digits) - digit));
+}
+
+static void lone_benchmark_report(struct lone_benchmark *benchmark)
+{
+	LINUX_WRITE_LITERAL(1, "BENCHMARK ");
+	linux_write(1, benchmark->name.pointer, benchmark->name.count);
+	LINUX_WRITE_LITERAL(1, "\n\tITERATIONS ");
+	lone_benchmark_write_unsigned(1, benchmark->iterations);
+	LINUX_WRITE_LITERAL(1, "\n\tNANOSECONDS ");
+	lone_benchmark_write_unsigned(1, benchmark->nanoseconds.elapsed);
+	LINUX_WRITE_LITERAL(1, "\n\tNANOSECONDS/ITERATION ");
+	lone_benchmark_write_unsigned(1, benchmark->iterations?
+			benchmark->nanoseconds.elapsed / benchmark->iterations : 0);
+	LINUX_WRITE_LITERAL(1, "\n");
+}
+
+void lone_benchmark_run(struct lone_benchmark *benchmarks)
+{
+	struct lone_benchmark *current;
+
+	for (current = benchmarks; current->function; ++current) {
+		current->nanoseconds.elapsed = 0;
+		current->function(current);
+		lone_benchmark_report(current);
+	}
+}
@@ -3,16 +3,17 @@
 #include <lone/linux.h>
 
 #include <lone/architecture/linux/system_calls.c>
+#include <lone/architecture/linux/threads.c>
 
 void linux_exit(int code)
 {
-	linux_system_call_1(__NR_exit, code);
+	linux_system_call_1(__NR_exit_group, code);
 	__builtin_unreachable();
 }
 
-long linux_openat(int dirfd, unsigned char *path, int flags)
+long linux_openat(int dirfd, unsigned char *path, int flags, unsigned int mode)
 {
-	return linux_system_call_4(__NR_openat, dirfd, (long) path, flags, 0);
+	return linux_system_call_4(__NR_openat, dirfd, (long) path, flags, mode);
 }
 
 long linux_close(int fd)
@@ -44,3 +45,28 @@ int linux_munmap(void *address, size_t length)
 {
 	return linux_system_call_2(__NR_munmap, (long) address, (long) length);
 }
+
+intptr_t linux_mremap(void *old_address, size_t old_length, size_t new_length, int flags)
+{
+	return linux_system_call_4(__NR_mremap, (long) old_address, (long) old_length, (long) new_length, (long) flags);
+}
+
+int linux_madvise(void *address, size_t length, int advice)
+{
+	return linux_system_call_3(__NR_madvise, (long) address, (long) length, (long) advice);
+}
+
+long linux_clock_gettime(int clock, struct __kernel_timespec *time)
+{
+	return linux_system_call_2(__NR_clock_gettime, (long) clock, (long) time);
+}
+
+long linux_futex(lone_u32 *address, int operation, lone_u32 value)
+{
+	return linux_system_call_6(__NR_futex, (long) address, (long) operation, (long) value, 0, 0, 0);
+}
+
+long linux_sched_yield(void)
+{
+	return linux_system_call_0(__NR_sched_yield);
+}
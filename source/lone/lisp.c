@@ -2,7 +2,9 @@
 
 #include <lone/lisp.h>
 #include <lone/lisp/heap.h>
+#include <lone/lisp/garbage_collector.h>
 #include <lone/lisp/module.h>
+#include <lone/lisp/profiler.h>
 
 #include <lone/lisp/value/module.h>
 #include <lone/lisp/value/primitive.h>
@@ -15,16 +17,35 @@ void lone_lisp_initialize(struct lone_lisp *lone, struct lone_system *system, vo
 {
 	struct lone_lisp_function_flags flags = { .evaluate_arguments = 0, .evaluate_result = 0 };
 	struct lone_lisp_value import, export;
+	size_t roots;
 
 	lone->system = system;
 	lone->native_stack = native_stack;
 
+	/* roots are marked by collections triggered while they are being created */
+	lone->symbol_table = lone_lisp_nil();
+	lone->constants.truth = lone_lisp_nil();
+	lone->modules.loaded = lone_lisp_nil();
+	lone->modules.embedded = lone_lisp_nil();
+	lone->modules.null = lone_lisp_nil();
+	lone->modules.top_level_environment = lone_lisp_nil();
+	lone->modules.path = lone_lisp_nil();
+	lone->modules.loading = 0;
+	lone->image = LONE_BYTES_VALUE_NULL();
+
+	lone_lisp_profiler_initialize(lone);
 	lone_lisp_heap_initialize(lone);
+	lone_lisp_garbage_collector_initialize(lone);
 
 	/* system, memory, stack and heap initialized
 	 * can now use lisp value creation functions
 	 */
 
+	roots = lone_lisp_roots_save(lone);
+	import = export = lone_lisp_nil();
+	lone_lisp_root(lone, &import);
+	lone_lisp_root(lone, &export);
+
 	lone->symbol_table = lone_lisp_table_create(lone, 256, lone_lisp_nil());
 	lone->constants.truth = lone_lisp_intern_c_string(lone, "true");
 
@@ -39,4 +60,6 @@ void lone_lisp_initialize(struct lone_lisp *lone, struct lone_system *system, vo
 	lone_lisp_table_set(lone, lone->modules.top_level_environment, lone_lisp_intern_c_string(lone, "export"), export);
 
 	lone->modules.null = lone_lisp_module_create(lone, lone_lisp_nil());
+
+	lone_lisp_roots_restore(lone, roots);
 }
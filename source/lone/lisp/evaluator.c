@@ -6,8 +6,15 @@
 #include <lone/lisp/value/vector.h>
 #include <lone/lisp/value/table.h>
 
+#include <lone/lisp/garbage_collector.h>
+#include <lone/lisp/profiler.h>
+
 #include <lone/linux.h>
 
+static struct lone_lisp_value lone_lisp_apply_as(struct lone_lisp *lone,
+		struct lone_lisp_value module, struct lone_lisp_value environment, struct lone_bytes name,
+		struct lone_lisp_value applicable, struct lone_lisp_value arguments);
+
 static struct lone_lisp_value lone_lisp_evaluate_form_index(struct lone_lisp *lone,
 		struct lone_lisp_value module, struct lone_lisp_value environment,
 		struct lone_lisp_value collection, struct lone_lisp_value arguments)
@@ -16,8 +23,9 @@ static struct lone_lisp_value lone_lisp_evaluate_form_index(struct lone_lisp *lo
 	void (*set)(struct lone_lisp *, struct lone_lisp_value, struct lone_lisp_value, struct lone_lisp_value);
 	struct lone_lisp_value key, value;
 	struct lone_lisp_heap_value *actual;
+	size_t roots;
 
-	switch (collection.type) {
+	switch (lone_lisp_type_of(collection)) {
 	case LONE_LISP_TYPE_NIL:
 	case LONE_LISP_TYPE_INTEGER:
 	case LONE_LISP_TYPE_POINTER:
@@ -52,9 +60,13 @@ static struct lone_lisp_value lone_lisp_evaluate_form_index(struct lone_lisp *lo
 	key = lone_lisp_list_first(arguments);
 	arguments = lone_lisp_list_rest(arguments);
 
+	roots = lone_lisp_roots_save(lone);
+	lone_lisp_root(lone, &collection);
+
 	if (lone_lisp_is_nil(arguments)) {
 		/* collection get: (collection key) */
 		key = lone_lisp_evaluate(lone, module, environment, key);
+		lone_lisp_roots_restore(lone, roots);
 
 		return get(lone, collection, key);
 	} else {
@@ -64,11 +76,17 @@ static struct lone_lisp_value lone_lisp_evaluate_form_index(struct lone_lisp *lo
 
 		if (lone_lisp_is_nil(arguments)) {
 			/* collection set: (collection key value) */
+			lone_lisp_root(lone, &module);
+			lone_lisp_root(lone, &environment);
+			lone_lisp_root(lone, &key);
+			lone_lisp_root(lone, &value);
+
 			key = lone_lisp_evaluate(lone, module, environment, key);
 			value = lone_lisp_evaluate(lone, module, environment, value);
 
 			set(lone, collection, key, value);
 
+			lone_lisp_roots_restore(lone, roots);
 			return value;
 		} else {
 			/* too many arguments given: (collection key value extra) */
@@ -83,11 +101,22 @@ static struct lone_lisp_value lone_lisp_evaluate_form(struct lone_lisp *lone,
 {
 	struct lone_lisp_value first, rest;
 	struct lone_lisp_heap_value *actual;
+	struct lone_bytes name;
+	size_t roots;
+
+	roots = lone_lisp_roots_save(lone);
+	lone_lisp_root(lone, &module);
+	lone_lisp_root(lone, &environment);
+	lone_lisp_root(lone, &list);
 
 	first = lone_lisp_list_first(list);
+	name = lone_lisp_is_symbol(first)? first.as.heap_value->as.bytes : LONE_BYTES_VALUE_NULL();
 	first = lone_lisp_evaluate(lone, module, environment, first);
 
-	switch (first.type) {
+	/* values are rooted again by whatever they are passed to */
+	lone_lisp_roots_restore(lone, roots);
+
+	switch (lone_lisp_type_of(first)) {
 	case LONE_LISP_TYPE_NIL:
 	case LONE_LISP_TYPE_INTEGER:
 	case LONE_LISP_TYPE_POINTER:
@@ -103,7 +132,7 @@ static struct lone_lisp_value lone_lisp_evaluate_form(struct lone_lisp *lone,
 	switch (actual->type) {
 	case LONE_LISP_TYPE_FUNCTION:
 	case LONE_LISP_TYPE_PRIMITIVE:
-		return lone_lisp_apply(lone, module, environment, first, rest);
+		return lone_lisp_apply_as(lone, module, environment, name, first, rest);
 	case LONE_LISP_TYPE_VECTOR:
 	case LONE_LISP_TYPE_TABLE:
 		return lone_lisp_evaluate_form_index(lone, module, environment, first, rest);
@@ -122,7 +151,7 @@ struct lone_lisp_value lone_lisp_evaluate(struct lone_lisp *lone,
 {
 	struct lone_lisp_heap_value *actual;
 
-	switch (value.type) {
+	switch (lone_lisp_type_of(value)) {
 	case LONE_LISP_TYPE_NIL:
 	case LONE_LISP_TYPE_INTEGER:
 	case LONE_LISP_TYPE_POINTER:
@@ -154,12 +183,21 @@ struct lone_lisp_value lone_lisp_evaluate_all(struct lone_lisp *lone,
 		struct lone_lisp_value list)
 {
 	struct lone_lisp_value evaluated, head;
+	size_t roots;
+
+	roots = lone_lisp_roots_save(lone);
+	evaluated = head = lone_lisp_nil();
+	lone_lisp_root(lone, &module);
+	lone_lisp_root(lone, &environment);
+	lone_lisp_root(lone, &list);
+	lone_lisp_root(lone, &evaluated);
 
-	for (evaluated = head = lone_lisp_nil(); !lone_lisp_is_nil(list); list = lone_lisp_list_rest(list)) {
+	for (/* list */; !lone_lisp_is_nil(list); list = lone_lisp_list_rest(list)) {
 		lone_lisp_list_append(lone, &evaluated, &head,
 			lone_lisp_evaluate(lone, module, environment, lone_lisp_list_first(list)));
 	}
 
+	lone_lisp_roots_restore(lone, roots);
 	return evaluated;
 }
 
@@ -171,27 +209,40 @@ struct lone_lisp_value lone_lisp_evaluate_in_module(struct lone_lisp *lone,
 
 static struct lone_lisp_value lone_lisp_apply_function(struct lone_lisp *lone,
 		struct lone_lisp_value module, struct lone_lisp_value environment,
-		struct lone_lisp_value function, struct lone_lisp_value arguments)
+		struct lone_bytes name, struct lone_lisp_value function, struct lone_lisp_value arguments)
 {
 	struct lone_lisp_value new_environment, names, code, value, current;
 	struct lone_lisp_heap_value *actual;
+	size_t roots, frame;
+
+	roots = lone_lisp_roots_save(lone);
+	new_environment = lone_lisp_nil();
+	lone_lisp_root(lone, &module);
+	lone_lisp_root(lone, &environment);
+	lone_lisp_root(lone, &function);
+	lone_lisp_root(lone, &arguments);
+	lone_lisp_root(lone, &new_environment);
 
 	actual = function.as.heap_value;
-	new_environment = lone_lisp_table_create(lone, 16, actual->as.function.environment);
-	names = actual->as.function.arguments;
-	code = actual->as.function.code;
-	value = lone_lisp_nil();
 
 	/* evaluate each argument if function is configured to do so */
-	if (actual->as.function.flags.evaluate_arguments) {
+	if (actual->flags.evaluate_arguments) {
 		arguments = lone_lisp_evaluate_all(lone, module, environment, arguments);
 	}
 
+	/* what the caller allocated to evaluate the arguments is not attributed to the function */
+	frame = lone_lisp_profiler_enter(lone, name, function);
+
+	new_environment = lone_lisp_table_create(lone, 16, actual->as.function.environment);
+	names = actual->as.function.arguments;
+	code = actual->as.function.code;
+	value = lone_lisp_nil();
+
 	while (1) {
 		if (!lone_lisp_is_nil(names)) {
 			current = lone_lisp_list_first(names);
 
-			switch (current.type) {
+			switch (lone_lisp_type_of(current)) {
 			case LONE_LISP_TYPE_HEAP_VALUE:
 				break;
 			case LONE_LISP_TYPE_NIL:
@@ -257,43 +308,65 @@ names_bound:
 		code = lone_lisp_list_rest(code);
 	}
 
+	lone_lisp_profiler_leave(lone, frame);
+
 	/* evaluate result if function is configured to do so */
-	if (actual->as.function.flags.evaluate_result) {
+	if (actual->flags.evaluate_result) {
 		value = lone_lisp_evaluate(lone, module, environment, value);
 	}
 
+	lone_lisp_roots_restore(lone, roots);
 	return value;
 }
 
 static struct lone_lisp_value lone_lisp_apply_primitive(struct lone_lisp *lone,
 		struct lone_lisp_value module, struct lone_lisp_value environment,
-		struct lone_lisp_value primitive, struct lone_lisp_value arguments)
+		struct lone_bytes name, struct lone_lisp_value primitive, struct lone_lisp_value arguments)
 {
 	struct lone_lisp_heap_value *actual = primitive.as.heap_value;
 	struct lone_lisp_value result;
+	size_t roots, frame;
+
+	/* primitives may rely on their arguments being rooted */
+	roots = lone_lisp_roots_save(lone);
+	lone_lisp_root(lone, &module);
+	lone_lisp_root(lone, &environment);
+	lone_lisp_root(lone, &primitive);
+	lone_lisp_root(lone, &arguments);
 
-	if (actual->as.primitive.flags.evaluate_arguments) {
+	if (actual->flags.evaluate_arguments) {
 		arguments = lone_lisp_evaluate_all(lone, module, environment, arguments);
 	}
 
+	frame = lone_lisp_profiler_enter(lone, name, primitive);
 	result = actual->as.primitive.function(lone, module, environment, arguments, actual->as.primitive.closure);
+	lone_lisp_profiler_leave(lone, frame);
 
-	if (actual->as.primitive.flags.evaluate_result) {
+	if (actual->flags.evaluate_result) {
 		result = lone_lisp_evaluate(lone, module, environment, result);
 	}
 
+	lone_lisp_roots_restore(lone, roots);
 	return result;
 }
 
-struct lone_lisp_value lone_lisp_apply(struct lone_lisp *lone,
-		struct lone_lisp_value module, struct lone_lisp_value environment,
+/* the name is given to the profiler frame the application is attributed to */
+static struct lone_lisp_value lone_lisp_apply_as(struct lone_lisp *lone,
+		struct lone_lisp_value module, struct lone_lisp_value environment, struct lone_bytes name,
 		struct lone_lisp_value applicable, struct lone_lisp_value arguments)
 {
 	if (!lone_lisp_is_applicable(applicable)) { /* given function is not an applicable type */ linux_exit(-1); }
 
 	if (lone_lisp_is_function(applicable)) {
-		return lone_lisp_apply_function(lone, module, environment, applicable, arguments);
+		return lone_lisp_apply_function(lone, module, environment, name, applicable, arguments);
 	} else {
-		return lone_lisp_apply_primitive(lone, module, environment, applicable, arguments);
+		return lone_lisp_apply_primitive(lone, module, environment, name, applicable, arguments);
 	}
 }
+
+struct lone_lisp_value lone_lisp_apply(struct lone_lisp *lone,
+		struct lone_lisp_value module, struct lone_lisp_value environment,
+		struct lone_lisp_value applicable, struct lone_lisp_value arguments)
+{
+	return lone_lisp_apply_as(lone, module, environment, LONE_BYTES_VALUE_NULL(), applicable, arguments);
+}
@@ -2,18 +2,213 @@
 
 #include <lone/lisp/garbage_collector.h>
 #include <lone/lisp/heap.h>
+#include <lone/lisp/image.h>
+#include <lone/lisp/profiler.h>
+#include <lone/lisp/value.h>
+#include <lone/lisp/value/table.h>
 
 #include <lone/memory/allocator.h>
+#include <lone/memory/array.h>
+#include <lone/memory/functions.h>
+#include <lone/utilities.h>
+#include <lone/linux.h>
+#include <lone/bits.h>
 
 #include <lone/architecture/garbage_collector.c>
 
-static void lone_lisp_mark_heap_value(struct lone_lisp_heap_value *);
+/* retired buffers are freed once no other marker can be reading them */
+static void lone_lisp_mark_stack_release(struct lone_lisp *lone, struct lone_lisp_mark_stack *stack)
+{
+	struct lone_lisp_mark_buffer *retired, *next;
+
+	if (!stack->buffer) { return; }
+
+	for (retired = stack->buffer->retired; retired; retired = next) {
+		next = retired->retired;
+		lone_deallocate(lone->system, retired);
+	}
+
+	stack->buffer->retired = 0;
+}
+
+/* growing may trigger a cycle, so space is reserved before anything is marked */
+static void lone_lisp_mark_stack_reserve(struct lone_lisp_marker *marker)
+{
+	struct lone_lisp *lone = marker->lone;
+	struct lone_lisp_mark_stack *stack = &marker->stack;
+	struct lone_lisp_mark_buffer *buffer = stack->buffer, *grown;
+	size_t capacity;
+	long i;
+
+	if (buffer && (size_t) (stack->bottom - __atomic_load_n(&stack->top, __ATOMIC_RELAXED)) < buffer->capacity) {
+		return;
+	}
+
+	capacity = buffer? 2 * buffer->capacity : 64;
+
+	grown = lone_allocate(lone->system, sizeof(*grown) + capacity * sizeof(*grown->marks));
+
+	/* the cycle triggered by the allocation may have grown the stack already */
+	if (stack->buffer != buffer) {
+		lone_deallocate(lone->system, grown);
+		lone_lisp_mark_stack_reserve(marker);
+		return;
+	}
+
+	grown->retired = buffer;
+	grown->capacity = capacity;
+
+	for (i = __atomic_load_n(&stack->top, __ATOMIC_RELAXED); i < stack->bottom; ++i) {
+		grown->marks[i & (capacity - 1)] = buffer->marks[i & (buffer->capacity - 1)];
+	}
+
+	__atomic_store_n(&stack->buffer, grown, __ATOMIC_RELEASE);
+
+	if (!lone->garbage_collector.parallel.marking) {
+		lone_lisp_mark_stack_release(lone, stack);
+	}
+}
+
+static void lone_lisp_mark_stack_push(struct lone_lisp_marker *marker,
+		struct lone_lisp_heap_value *value, size_t index)
+{
+	struct lone_lisp_mark_stack *stack = &marker->stack;
+	struct lone_lisp_mark_buffer *buffer;
+
+	lone_lisp_mark_stack_reserve(marker);
+
+	buffer = stack->buffer;
+	buffer->marks[stack->bottom & (buffer->capacity - 1)] = (struct lone_lisp_mark) { .value = value, .index = index };
+
+	/* thieves must see the mark before the new bottom */
+	__atomic_store_n(&stack->bottom, stack->bottom + 1, __ATOMIC_RELEASE);
+}
+
+static bool lone_lisp_mark_stack_is_empty(struct lone_lisp_mark_stack *stack)
+{
+	return stack->bottom <= __atomic_load_n(&stack->top, __ATOMIC_ACQUIRE);
+}
+
+/* only the owner pops, the last mark may be stolen at the same time */
+static bool lone_lisp_mark_stack_pop(struct lone_lisp_marker *marker, struct lone_lisp_mark *mark)
+{
+	struct lone_lisp_mark_stack *stack = &marker->stack;
+	struct lone_lisp_mark_buffer *buffer = stack->buffer;
+	long bottom, top;
+	bool popped;
+
+	if (!marker->lone->garbage_collector.parallel.marking) {
+		if (stack->bottom == stack->top) { return false; }
+		--stack->bottom;
+		*mark = buffer->marks[stack->bottom & (buffer->capacity - 1)];
+		return true;
+	}
+
+	bottom = stack->bottom - 1;
+	__atomic_store_n(&stack->bottom, bottom, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	top = __atomic_load_n(&stack->top, __ATOMIC_RELAXED);
+
+	if (top > bottom) {
+		__atomic_store_n(&stack->bottom, bottom + 1, __ATOMIC_RELAXED);
+		return false;
+	}
+
+	*mark = buffer->marks[bottom & (buffer->capacity - 1)];
+
+	if (top < bottom) { return true; }
+
+	popped = __atomic_compare_exchange_n(&stack->top, &top, top + 1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+	__atomic_store_n(&stack->bottom, bottom + 1, __ATOMIC_RELAXED);
+
+	return popped;
+}
+
+static bool lone_lisp_mark_stack_steal(struct lone_lisp_mark_stack *stack, struct lone_lisp_mark *mark)
+{
+	struct lone_lisp_mark_buffer *buffer;
+	long top, bottom;
+
+	top = __atomic_load_n(&stack->top, __ATOMIC_ACQUIRE);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	bottom = __atomic_load_n(&stack->bottom, __ATOMIC_ACQUIRE);
+
+	if (top >= bottom) { return false; }
+
+	buffer = __atomic_load_n(&stack->buffer, __ATOMIC_ACQUIRE);
+	*mark = buffer->marks[top & (buffer->capacity - 1)];
+
+	return __atomic_compare_exchange_n(&stack->top, &top, top + 1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+}
+
+static struct lone_lisp_heap *lone_lisp_heap_of(struct lone_lisp_heap_value *value)
+{
+	return (struct lone_lisp_heap *) ((uintptr_t) value & ~(LONE_LISP_HEAP_ALIGNMENT - 1));
+}
+
+/* marks live in the bitmaps of the heaps, marking never writes to the values themselves */
+static bool lone_lisp_is_marked(struct lone_lisp_heap_value *value)
+{
+	struct lone_lisp_heap *heap = lone_lisp_heap_of(value);
+	size_t i = (size_t) (value - heap->values);
+
+	return heap->marks[i / 8] & (0x80 >> (i % 8));
+}
+
+/* false if the value was marked already, possibly by another marker at the same time */
+static bool lone_lisp_set_marked(struct lone_lisp_marker *marker, struct lone_lisp_heap_value *value)
+{
+	struct lone_lisp_heap *heap = lone_lisp_heap_of(value);
+	size_t i = (size_t) (value - heap->values);
+	unsigned char bit = (unsigned char) (0x80 >> (i % 8));
+
+	if (marker->lone->garbage_collector.parallel.marking) {
+		if (__atomic_fetch_or(&heap->marks[i / 8], bit, __ATOMIC_RELAXED) & bit) { return false; }
+	} else {
+		if (heap->marks[i / 8] & bit) { return false; }
+		heap->marks[i / 8] |= bit;
+	}
+
+	marker->marked += 1;
+	return true;
+}
 
-static void lone_lisp_mark_value(struct lone_lisp_value value)
+static void lone_lisp_mark_heap_value(struct lone_lisp_marker *, struct lone_lisp_heap_value *);
+
+/* weak tables are cleared once marking is done, markers may come across them at the same time */
+static void lone_lisp_record_weak_table(struct lone_lisp_marker *marker, struct lone_lisp_heap_value *table)
+{
+	struct lone_lisp *lone = marker->lone;
+	bool parallel = lone->garbage_collector.parallel.marking;
+	size_t capacity;
+
+	if (parallel) {
+		while (__atomic_exchange_n(&lone->garbage_collector.weak.lock, 1, __ATOMIC_ACQUIRE)) {
+			linux_sched_yield();
+		}
+	}
+
+	if (lone->garbage_collector.weak.count == lone->garbage_collector.weak.capacity) {
+		capacity = lone->garbage_collector.weak.capacity;
+		capacity = capacity? 2 * capacity : 16;
+		lone->garbage_collector.weak.tables = lone_memory_array(lone->system,
+				lone->garbage_collector.weak.tables, capacity,
+				sizeof(*lone->garbage_collector.weak.tables));
+		lone->garbage_collector.weak.capacity = capacity;
+	}
+
+	lone->garbage_collector.weak.tables[lone->garbage_collector.weak.count++] = table;
+
+	if (parallel) {
+		__atomic_store_n(&lone->garbage_collector.weak.lock, 0, __ATOMIC_RELEASE);
+	}
+}
+
+static void lone_lisp_mark_value(struct lone_lisp_marker *marker, struct lone_lisp_value value)
 {
 	struct lone_lisp_heap_value *actual;
 
-	switch (value.type) {
+	switch (lone_lisp_type_of(value)) {
 	case LONE_LISP_TYPE_NIL:
 	case LONE_LISP_TYPE_INTEGER:
 	case LONE_LISP_TYPE_POINTER:
@@ -25,85 +220,374 @@ static void lone_lisp_mark_value(struct lone_lisp_value value)
 
 	actual = value.as.heap_value;
 
-	lone_lisp_mark_heap_value(actual);
+	lone_lisp_mark_heap_value(marker, actual);
 }
 
-static void lone_lisp_mark_heap_value(struct lone_lisp_heap_value *value)
+/* lists whose cells would be pushed onto the mark stack are followed in place instead */
+static bool lone_lisp_is_unmarked_list(struct lone_lisp_marker *marker, struct lone_lisp_value value)
 {
-	if (!value || !value->live || value->marked) { return; }
+	struct lone_lisp_heap_value *actual;
+
+	if (!lone_lisp_is_heap_value(value)) { return false; }
+
+	actual = value.as.heap_value;
 
-	value->marked = true;
+	return actual->type == LONE_LISP_TYPE_LIST && actual->live && !lone_lisp_is_marked(actual) &&
+	       !(marker->lone->garbage_collector.minor && actual->old);
+}
+
+/* children from the index onwards are marked, returns the number of values examined */
+static size_t lone_lisp_mark_children(struct lone_lisp_marker *marker, struct lone_lisp_heap_value *value, size_t index)
+{
+	size_t i, count, end, work;
 
 	switch (value->type) {
 	case LONE_LISP_TYPE_MODULE:
-		lone_lisp_mark_value(value->as.module.name);
-		lone_lisp_mark_value(value->as.module.environment);
-		lone_lisp_mark_value(value->as.module.exports);
-		break;
+		lone_lisp_mark_value(marker, value->as.module.name);
+		lone_lisp_mark_value(marker, value->as.module.environment);
+		lone_lisp_mark_value(marker, value->as.module.exports);
+		return 1;
 	case LONE_LISP_TYPE_FUNCTION:
-		lone_lisp_mark_value(value->as.function.arguments);
-		lone_lisp_mark_value(value->as.function.code);
-		lone_lisp_mark_value(value->as.function.environment);
-		break;
+		lone_lisp_mark_value(marker, value->as.function.arguments);
+		lone_lisp_mark_value(marker, value->as.function.code);
+		lone_lisp_mark_value(marker, value->as.function.environment);
+		return 1;
 	case LONE_LISP_TYPE_PRIMITIVE:
-		lone_lisp_mark_value(value->as.primitive.name);
-		lone_lisp_mark_value(value->as.primitive.closure);
-		break;
+		lone_lisp_mark_value(marker, value->as.primitive.name);
+		lone_lisp_mark_value(marker, value->as.primitive.closure);
+		return 1;
 	case LONE_LISP_TYPE_LIST:
-		lone_lisp_mark_value(value->as.list.first);
-		lone_lisp_mark_value(value->as.list.rest);
-		break;
+		/* the spine is walked without growing the stack, a chunk at a time, until another marker claims it */
+		for (work = 1; work < LONE_LISP_GARBAGE_COLLECTOR_MARK_CHUNK &&
+		               lone_lisp_is_unmarked_list(marker, value->as.list.rest) &&
+		               lone_lisp_set_marked(marker, value->as.list.rest.as.heap_value); ++work) {
+			lone_lisp_mark_value(marker, value->as.list.first);
+			value = value->as.list.rest.as.heap_value;
+		}
+		lone_lisp_mark_value(marker, value->as.list.first);
+		lone_lisp_mark_value(marker, value->as.list.rest);
+		return work;
 	case LONE_LISP_TYPE_VECTOR:
-		for (size_t i = 0; i < value->as.vector.count; ++i) {
-			lone_lisp_mark_value(value->as.vector.values[i]);
+		count = value->as.vector.count;
+		if (index > count) { index = count; }
+		end = count - index > LONE_LISP_GARBAGE_COLLECTOR_MARK_CHUNK?
+		      index + LONE_LISP_GARBAGE_COLLECTOR_MARK_CHUNK : count;
+		/* elements may have been removed since the last chunk, the rest are marked later */
+		if (end < count) {
+			lone_lisp_mark_stack_push(marker, value, end);
 		}
-		break;
+		for (i = index; i < end; ++i) {
+			lone_lisp_mark_value(marker, value->as.vector.values[i]);
+		}
+		return end > index? end - index : 1;
 	case LONE_LISP_TYPE_TABLE:
-		lone_lisp_mark_value(value->as.table.prototype);
-		for (size_t i = 0; i < value->as.table.count; ++i) {
-			lone_lisp_mark_value(value->as.table.entries[i].key);
-			lone_lisp_mark_value(value->as.table.entries[i].value);
+		count = value->as.table.count;
+		if (index > count) { index = count; }
+		end = count - index > LONE_LISP_GARBAGE_COLLECTOR_MARK_CHUNK?
+		      index + LONE_LISP_GARBAGE_COLLECTOR_MARK_CHUNK : count;
+		if (end < count) {
+			lone_lisp_mark_stack_push(marker, value, end);
 		}
-		break;
+		if (index == 0) {
+			lone_lisp_mark_value(marker, value->as.table.prototype);
+			if (value->weakness != LONE_LISP_TABLE_STRONG) { lone_lisp_record_weak_table(marker, value); }
+		}
+		for (i = index; i < end; ++i) {
+			switch (value->weakness) {
+			case LONE_LISP_TABLE_STRONG:
+				lone_lisp_mark_value(marker, value->as.table.entries[i].key);
+				lone_lisp_mark_value(marker, value->as.table.entries[i].value);
+				break;
+			case LONE_LISP_TABLE_WEAK_KEYS:
+				lone_lisp_mark_value(marker, value->as.table.entries[i].value);
+				break;
+			case LONE_LISP_TABLE_WEAK_VALUES:
+				lone_lisp_mark_value(marker, value->as.table.entries[i].key);
+				break;
+			case LONE_LISP_TABLE_EPHEMERON:
+				/* values are marked along with their keys once all gray values have been marked */
+				break;
+			}
+		}
+		return end > index? end - index : 1;
 	case LONE_LISP_TYPE_SYMBOL:
 	case LONE_LISP_TYPE_TEXT:
 	case LONE_LISP_TYPE_BYTES:
 		/* these types do not contain any other values to mark */
-		break;
+		return 1;
 	}
+
+	return 1;
 }
 
-static void lone_lisp_mark_known_roots(struct lone_lisp *lone)
+/* gray: children are marked once the value is popped off the mark stack */
+static void lone_lisp_mark_heap_value(struct lone_lisp_marker *marker, struct lone_lisp_heap_value *value)
+{
+	struct lone_lisp *lone = marker->lone;
+
+	if (!value || lone_lisp_is_marked(value)) { return; }
+
+	if (!value->live) {
+		/* only the conservative scan may come across dead values */
+		if (LONE_LISP_GARBAGE_COLLECTOR_STRESS && !lone->garbage_collector.conservative) { linux_exit(-1); }
+		return;
+	}
+
+	/* minor cycles assume old values are alive */
+	if (lone->garbage_collector.minor && value->old) { return; }
+
+	lone_lisp_mark_stack_reserve(marker);
+
+	if (lone_lisp_set_marked(marker, value)) {
+		lone_lisp_mark_stack_push(marker, value, 0);
+	}
+}
+
+/* markers with nothing left steal from the others until every one of them is idle */
+static bool lone_lisp_marker_steal(struct lone_lisp_marker *marker, struct lone_lisp_mark *mark)
 {
-	lone_lisp_mark_value(lone->symbol_table);
-	lone_lisp_mark_value(lone->constants.truth);
-	lone_lisp_mark_value(lone->modules.loaded);
-	lone_lisp_mark_value(lone->modules.embedded);
-	lone_lisp_mark_value(lone->modules.null);
-	lone_lisp_mark_value(lone->modules.top_level_environment);
-	lone_lisp_mark_value(lone->modules.path);
+	struct lone_lisp *lone = marker->lone;
+	struct lone_lisp_marker *victim;
+	size_t markers, i;
+	bool idle = false;
+
+	markers = lone->garbage_collector.parallel.threads + 1;
+
+	while (1) {
+		for (i = 1; i < markers; ++i) {
+			victim = lone->garbage_collector.parallel.markers[(marker->id + i) % markers];
+			if (lone_lisp_mark_stack_is_empty(&victim->stack)) { continue; }
+
+			/* idle markers must not be counted while they might find more work */
+			if (idle) {
+				__atomic_sub_fetch(&lone->garbage_collector.parallel.idle, 1, __ATOMIC_SEQ_CST);
+				idle = false;
+			}
+
+			if (lone_lisp_mark_stack_steal(&victim->stack, mark)) { return true; }
+		}
+
+		if (!idle) {
+			__atomic_add_fetch(&lone->garbage_collector.parallel.idle, 1, __ATOMIC_SEQ_CST);
+			idle = true;
+		}
+
+		if (__atomic_load_n(&lone->garbage_collector.parallel.idle, __ATOMIC_SEQ_CST) == markers) {
+			return false;
+		}
+
+		linux_sched_yield();
+	}
 }
 
-static bool lone_points_within_range(void *pointer, void *start, void *end)
+static void lone_lisp_marker_drain(struct lone_lisp_marker *marker)
 {
-	return start <= pointer && pointer < end;
+	struct lone_lisp_mark mark;
+
+	while (lone_lisp_mark_stack_pop(marker, &mark) || lone_lisp_marker_steal(marker, &mark)) {
+		lone_lisp_mark_children(marker, mark.value, mark.index);
+	}
 }
 
-static bool lone_lisp_points_to_heap(struct lone_lisp *lone, void *pointer)
+/* helpers sleep until the next parallel marking phase, helpers beyond the current count sit it out */
+static void lone_lisp_marker_thread(void *argument)
 {
-	struct lone_lisp_heap *heap;
+	struct lone_lisp_marker *marker = argument;
+	struct lone_lisp *lone = marker->lone;
 
-	for (heap = lone->heaps; heap; heap = heap->next) {
-		if (lone_points_within_range(pointer, heap->values, heap->values + LONE_LISP_HEAP_VALUE_COUNT)) {
-			return true;
+	while (1) {
+		while (__atomic_load_n(&lone->garbage_collector.parallel.generation, __ATOMIC_ACQUIRE) == marker->generation) {
+			linux_futex(&lone->garbage_collector.parallel.generation, FUTEX_WAIT_PRIVATE, marker->generation);
+		}
+
+		marker->generation = __atomic_load_n(&lone->garbage_collector.parallel.generation, __ATOMIC_ACQUIRE);
+
+		if (lone->garbage_collector.parallel.stopping) { return; }
+
+		if (marker->id <= lone->garbage_collector.parallel.threads) {
+			lone_lisp_marker_drain(marker);
+		}
+
+		__atomic_add_fetch(&lone->garbage_collector.parallel.finished, 1, __ATOMIC_RELEASE);
+	}
+}
+
+static void lone_lisp_marking_threads_start(struct lone_lisp *lone)
+{
+	struct lone_lisp_marker *marker;
+	size_t started;
+	intptr_t stack;
+
+	started = lone->garbage_collector.parallel.started;
+	if (started >= lone->garbage_collector.parallel.threads) { return; }
+
+	lone->garbage_collector.parallel.markers = lone_memory_array(lone->system,
+			lone->garbage_collector.parallel.markers, lone->garbage_collector.parallel.threads + 1,
+			sizeof(*lone->garbage_collector.parallel.markers));
+	lone->garbage_collector.parallel.markers[0] = &lone->garbage_collector.marker;
+
+	while (started < lone->garbage_collector.parallel.threads) {
+		marker = lone_allocate(lone->system, sizeof(*marker));
+		marker->lone = lone;
+		marker->stack.buffer = 0;
+		marker->stack.top = 0;
+		marker->stack.bottom = 0;
+		marker->marked = 0;
+		marker->id = ++started;
+		marker->generation = lone->garbage_collector.parallel.generation;
+		marker->thread = 0;
+
+		stack = linux_mmap(0, LONE_LISP_GARBAGE_COLLECTOR_THREAD_STACK_SIZE,
+				PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK, -1, 0);
+		if (stack < 0) { linux_exit(-1); }
+
+		marker->thread_stack = (void *) stack;
+		lone->garbage_collector.parallel.markers[marker->id] = marker;
+
+		if (linux_thread_create(marker->thread_stack, LONE_LISP_GARBAGE_COLLECTOR_THREAD_STACK_SIZE,
+				lone_lisp_marker_thread, marker, &marker->thread) < 0) {
+			linux_exit(-1);
+		}
+
+		lone->garbage_collector.parallel.started = started;
+	}
+}
+
+/* the gray values found by scanning the roots are dealt out to the helpers before they wake up */
+static void lone_lisp_mark_distribute_roots(struct lone_lisp *lone)
+{
+	struct lone_lisp_marker *marker = &lone->garbage_collector.marker, *helper;
+	struct lone_lisp_mark_buffer *buffer = marker->stack.buffer;
+	size_t markers = lone->garbage_collector.parallel.threads + 1;
+	struct lone_lisp_mark mark;
+	long i, kept;
+
+	for (i = kept = marker->stack.top; i < marker->stack.bottom; ++i) {
+		mark = buffer->marks[i & (buffer->capacity - 1)];
+		helper = lone->garbage_collector.parallel.markers[(size_t) (i - marker->stack.top) % markers];
+
+		if (helper == marker) {
+			buffer->marks[kept++ & (buffer->capacity - 1)] = mark;
+		} else {
+			lone_lisp_mark_stack_push(helper, mark.value, mark.index);
+		}
+	}
+
+	marker->stack.bottom = kept;
+}
+
+static void lone_lisp_mark_in_parallel(struct lone_lisp *lone)
+{
+	struct lone_lisp_marker *marker;
+	size_t i;
+
+	lone_lisp_marking_threads_start(lone);
+	lone_lisp_mark_distribute_roots(lone);
+
+	lone->garbage_collector.parallel.idle = 0;
+	lone->garbage_collector.parallel.finished = 0;
+	lone->garbage_collector.parallel.marking = true;
+
+	/* helpers allocate while marking */
+	lone->system->memory.threads += lone->garbage_collector.parallel.started;
+
+	__atomic_add_fetch(&lone->garbage_collector.parallel.generation, 1, __ATOMIC_RELEASE);
+	linux_futex(&lone->garbage_collector.parallel.generation, FUTEX_WAKE_PRIVATE, 0x7FFFFFFF);
+
+	lone_lisp_marker_drain(&lone->garbage_collector.marker);
+
+	while (__atomic_load_n(&lone->garbage_collector.parallel.finished, __ATOMIC_ACQUIRE) <
+	       lone->garbage_collector.parallel.started) {
+		linux_sched_yield();
+	}
+
+	lone->system->memory.threads -= lone->garbage_collector.parallel.started;
+	lone->garbage_collector.parallel.marking = false;
+
+	for (i = 0; i <= lone->garbage_collector.parallel.threads; ++i) {
+		marker = lone->garbage_collector.parallel.markers[i];
+		lone_lisp_mark_stack_release(lone, &marker->stack);
+		marker->stack.top = 0;
+		marker->stack.bottom = 0;
+
+		if (marker != &lone->garbage_collector.marker) {
+			lone->garbage_collector.marker.marked += marker->marked;
+			marker->marked = 0;
+		}
+	}
+}
+
+/* incremental slices stop once enough values have been examined, complete drains may be parallel */
+static void lone_lisp_mark_gray_values(struct lone_lisp *lone, size_t limit)
+{
+	struct lone_lisp_marker *marker = &lone->garbage_collector.marker;
+	struct lone_lisp_mark mark;
+	size_t work;
+
+	if (limit == (size_t) -1 && lone->garbage_collector.parallel.threads) {
+		lone_lisp_mark_in_parallel(lone);
+		return;
+	}
+
+	while (limit && lone_lisp_mark_stack_pop(marker, &mark)) {
+		work = lone_lisp_mark_children(marker, mark.value, mark.index);
+		limit -= work < limit? work : limit;
+	}
+}
+
+/* old values given young values since the last cycle are roots of minor cycles */
+static void lone_lisp_mark_remembered_values(struct lone_lisp *lone)
+{
+	struct lone_lisp_marker *marker = &lone->garbage_collector.marker;
+	struct lone_lisp_remembered_value *remembered;
+	struct lone_lisp_heap_value *value;
+	size_t i;
+
+	for (i = 0; i < lone->garbage_collector.remembered.count; ++i) {
+		remembered = &lone->garbage_collector.remembered.values[i];
+		value = remembered->value;
+
+		if (lone->garbage_collector.minor) {
+			if (remembered->slot == (size_t) -1) {
+				lone_lisp_mark_children(marker, value, 0);
+			} else if (remembered->slot < value->as.vector.count) {
+				lone_lisp_mark_value(marker, value->as.vector.values[remembered->slot]);
+			}
 		}
+
+		value->remembered = false;
 	}
 
-	return false;
+	lone->garbage_collector.remembered.count = 0;
+}
+
+static void lone_lisp_mark_known_roots(struct lone_lisp *lone)
+{
+	struct lone_lisp_marker *marker = &lone->garbage_collector.marker;
+
+	lone_lisp_mark_value(marker, lone->symbol_table);
+	lone_lisp_mark_value(marker, lone->constants.truth);
+	lone_lisp_mark_value(marker, lone->modules.loaded);
+	lone_lisp_mark_value(marker, lone->modules.embedded);
+	lone_lisp_mark_value(marker, lone->modules.null);
+	lone_lisp_mark_value(marker, lone->modules.top_level_environment);
+	lone_lisp_mark_value(marker, lone->modules.path);
+}
+
+static void lone_lisp_mark_rooted_values(struct lone_lisp *lone)
+{
+	struct lone_lisp_marker *marker = &lone->garbage_collector.marker;
+	struct lone_lisp_roots *roots = &lone->garbage_collector.roots;
+	size_t i;
+
+	for (i = 0; i < roots->count; ++i) {
+		lone_lisp_mark_value(marker, *roots->values[i]);
+	}
 }
 
 static void lone_lisp_find_and_mark_stack_roots(struct lone_lisp *lone)
 {
+	struct lone_lisp_marker *marker = &lone->garbage_collector.marker;
 	void *bottom = lone->native_stack, *top = __builtin_frame_address(0), *tmp;
 	void **pointer;
 
@@ -116,9 +600,7 @@ static void lone_lisp_find_and_mark_stack_roots(struct lone_lisp *lone)
 	pointer = bottom;
 
 	while (pointer++ < top) {
-		if (lone_lisp_points_to_heap(lone, *pointer)) {
-			lone_lisp_mark_heap_value(*pointer);
-		}
+		lone_lisp_mark_heap_value(marker, lone_lisp_heap_find_value(lone, *pointer));
 	}
 }
 
@@ -128,56 +610,1132 @@ static void lone_lisp_mark_all_reachable_values(struct lone_lisp *lone)
 	lone_save_registers(registers);               /* spill registers on stack */
 
 	lone_lisp_mark_known_roots(lone);             /* precise */
-	lone_lisp_find_and_mark_stack_roots(lone);    /* conservative */
+	lone_lisp_mark_remembered_values(lone);       /* precise */
+	lone_lisp_mark_rooted_values(lone);           /* precise */
+
+	if (lone->garbage_collector.conservative) {
+		lone_lisp_find_and_mark_stack_roots(lone);    /* conservative */
+	}
 }
 
-static void lone_lisp_kill_all_unmarked_values(struct lone_lisp *lone)
+/* minor cycles assume old values are alive, values that are not on the heap never die */
+static bool lone_lisp_survives(struct lone_lisp *lone, struct lone_lisp_value value)
 {
-	struct lone_lisp_heap_value *value;
-	struct lone_lisp_heap *heap;
-	size_t i;
+	struct lone_lisp_heap_value *actual;
 
-	for (heap = lone->heaps; heap; heap = heap->next) {
-		for (i = 0; i < LONE_LISP_HEAP_VALUE_COUNT; ++i) {
-			value = &heap->values[i];
-
-			if (!value->live) { continue; }
-
-			if (!value->marked) {
-				switch (value->type) {
-				case LONE_LISP_TYPE_BYTES:
-				case LONE_LISP_TYPE_TEXT:
-				case LONE_LISP_TYPE_SYMBOL:
-					if (value->should_deallocate_bytes) {
-						lone_deallocate(lone->system, value->as.bytes.pointer);
-					}
-					break;
-				case LONE_LISP_TYPE_VECTOR:
-					lone_deallocate(lone->system, value->as.vector.values);
-					break;
-				case LONE_LISP_TYPE_TABLE:
-					lone_deallocate(lone->system, value->as.table.indexes);
-					lone_deallocate(lone->system, value->as.table.entries);
-					break;
-				case LONE_LISP_TYPE_MODULE:
-				case LONE_LISP_TYPE_FUNCTION:
-				case LONE_LISP_TYPE_PRIMITIVE:
-				case LONE_LISP_TYPE_LIST:
-					/* these types do not own any additional memory */
-					break;
-				}
-
-				value->live = false;
-			}
+	if (!lone_lisp_is_heap_value(value)) { return true; }
+
+	actual = value.as.heap_value;
+
+	return lone_lisp_is_marked(actual) || (lone->garbage_collector.minor && actual->old);
+}
+
+static bool lone_lisp_mark_ephemeron_values(struct lone_lisp *lone)
+{
+	struct lone_lisp_heap_value *table;
+	struct lone_lisp_table_entry *entry;
+	bool marked = false;
+	size_t i, j;
+
+	for (i = 0; i < lone->garbage_collector.weak.count; ++i) {
+		table = lone->garbage_collector.weak.tables[i];
+		if (table->weakness != LONE_LISP_TABLE_EPHEMERON) { continue; }
 
-			value->marked = false;
+		for (j = 0; j < table->as.table.count; ++j) {
+			entry = &table->as.table.entries[j];
+
+			if (lone_lisp_survives(lone, entry->key) && !lone_lisp_survives(lone, entry->value)) {
+				lone_lisp_mark_value(&lone->garbage_collector.marker, entry->value);
+				marked = true;
+			}
 		}
 	}
+
+	return marked;
 }
 
-void lone_lisp_garbage_collector(struct lone_lisp *lone)
+/* surviving entries keep their order, the indexes are rebuilt if any entries were removed */
+static void lone_lisp_clear_weak_table(struct lone_lisp *lone, struct lone_lisp_heap_value *table)
 {
-	lone_lisp_mark_all_reachable_values(lone);
-	lone_lisp_kill_all_unmarked_values(lone);
-	lone_lisp_deallocate_dead_heaps(lone);
+	struct lone_lisp_table *actual = &table->as.table;
+	struct lone_lisp_table_entry *entry;
+	bool weak_keys, weak_values;
+	size_t i, kept;
+
+	weak_keys = table->weakness == LONE_LISP_TABLE_WEAK_KEYS || table->weakness == LONE_LISP_TABLE_EPHEMERON;
+	weak_values = table->weakness == LONE_LISP_TABLE_WEAK_VALUES;
+
+	for (i = kept = 0; i < actual->count; ++i) {
+		entry = &actual->entries[i];
+
+		if (weak_keys && !lone_lisp_survives(lone, entry->key)) { continue; }
+		if (weak_values && !lone_lisp_survives(lone, entry->value)) { continue; }
+
+		actual->entries[kept++] = *entry;
+	}
+
+	if (kept == actual->count) { return; }
+
+	for (i = kept; i < actual->count; ++i) {
+		actual->entries[i].key = lone_lisp_nil();
+		actual->entries[i].value = lone_lisp_nil();
+	}
+
+	actual->count = (lone_u32) kept;
+	lone_lisp_table_rehash(lone, lone_lisp_value_from_heap_value(table));
+}
+
+/* dead values must be gone from weak tables before they are swept */
+static void lone_lisp_clear_weak_tables(struct lone_lisp *lone)
+{
+	size_t i;
+
+	while (lone_lisp_mark_ephemeron_values(lone)) {
+		lone_lisp_mark_gray_values(lone, (size_t) -1);
+	}
+
+	for (i = 0; i < lone->garbage_collector.weak.count; ++i) {
+		lone_lisp_clear_weak_table(lone, lone->garbage_collector.weak.tables[i]);
+	}
+
+	lone->garbage_collector.weak.count = 0;
+}
+
+static void lone_lisp_kill_value(struct lone_lisp *lone,
+		struct lone_lisp_heap *heap, struct lone_lisp_heap_value *value)
+{
+	if (value->sampled) { lone_lisp_profiler_forget_value(lone, value); }
+
+	switch (value->type) {
+	case LONE_LISP_TYPE_BYTES:
+	case LONE_LISP_TYPE_TEXT:
+	case LONE_LISP_TYPE_SYMBOL:
+		if (value->should_deallocate_bytes) {
+			lone_deallocate(lone->system, value->as.bytes.pointer);
+		}
+		break;
+	case LONE_LISP_TYPE_VECTOR:
+		if (!lone_lisp_image_contains(lone, value->as.vector.values)) {
+			lone_deallocate(lone->system, value->as.vector.values);
+		}
+		break;
+	case LONE_LISP_TYPE_TABLE:
+		if (!lone_lisp_image_contains(lone, value->as.table.entries)) {
+			lone_deallocate(lone->system, value->as.table.entries);
+		}
+		break;
+	case LONE_LISP_TYPE_MODULE:
+	case LONE_LISP_TYPE_FUNCTION:
+	case LONE_LISP_TYPE_PRIMITIVE:
+	case LONE_LISP_TYPE_LIST:
+		/* these types do not own any additional memory */
+		break;
+	}
+
+	lone_lisp_heap_kill_value(heap, value);
+}
+
+/* candidates are either the live or the young values, returns the number of young values promoted */
+static size_t lone_lisp_sweep_values(struct lone_lisp *lone,
+		struct lone_lisp_heap *heap, unsigned char *candidates)
+{
+	unsigned char dead, promoted;
+	size_t byte, count;
+
+	for (count = 0, byte = 0; byte < sizeof(heap->marks); ++byte) {
+		dead = candidates[byte] & ~heap->marks[byte];
+		promoted = heap->nursery[byte] & heap->marks[byte];
+
+		for (/* dead */; dead; dead &= dead - 1) {
+			lone_lisp_kill_value(lone, heap, &heap->values[byte * 8 + 7 - __builtin_ctz(dead)]);
+		}
+
+		for (/* promoted */; promoted; promoted &= promoted - 1, ++count) {
+			lone_lisp_heap_promote_value(heap, &heap->values[byte * 8 + 7 - __builtin_ctz(promoted)]);
+		}
+	}
+
+	/* clearing the marks for the next cycle takes a single pass over the bitmap */
+	lone_memory_zero(heap->marks, sizeof(heap->marks));
+
+	return count;
+}
+
+/* threads waiting for a heap see its values swept once it is no longer unswept */
+static void lone_lisp_sweep_heap(struct lone_lisp *lone, struct lone_lisp_heap *heap)
+{
+	lone_lisp_sweep_values(lone, heap, heap->occupied);
+	__atomic_store_n(&heap->unswept, false, __ATOMIC_RELEASE);
+}
+
+/* the sweeper and the interpreter both claim unswept heaps while sweeping in the background */
+static void lone_lisp_sweeper_lock(struct lone_lisp *lone)
+{
+	if (!lone->garbage_collector.sweeper.active) { return; }
+
+	while (__atomic_exchange_n(&lone->garbage_collector.sweeper.lock, 1, __ATOMIC_ACQUIRE)) {
+		linux_sched_yield();
+	}
+}
+
+static void lone_lisp_sweeper_unlock(struct lone_lisp *lone)
+{
+	if (!lone->garbage_collector.sweeper.active) { return; }
+
+	__atomic_store_n(&lone->garbage_collector.sweeper.lock, 0, __ATOMIC_RELEASE);
+}
+
+/* heaps claimed out of order by the write barrier are skipped */
+static struct lone_lisp_heap *lone_lisp_claim_next_unswept_heap(struct lone_lisp *lone)
+{
+	struct lone_lisp_heap *heap;
+
+	lone_lisp_sweeper_lock(lone);
+
+	while ((heap = lone->unswept_heaps)) {
+		lone->unswept_heaps = heap->next_unswept;
+		if (!heap->claimed) { heap->claimed = true; break; }
+	}
+
+	lone_lisp_sweeper_unlock(lone);
+
+	return heap;
+}
+
+static bool lone_lisp_claim_unswept_heap(struct lone_lisp *lone, struct lone_lisp_heap *heap)
+{
+	bool claimed;
+
+	lone_lisp_sweeper_lock(lone);
+	claimed = !heap->claimed;
+	heap->claimed = true;
+	lone_lisp_sweeper_unlock(lone);
+
+	return claimed;
+}
+
+/* swept heaps rejoin the heaps of the interpreter */
+static void lone_lisp_adopt_swept_heap(struct lone_lisp *lone, struct lone_lisp_heap *heap)
+{
+	heap->next = lone->heaps;
+	lone->heaps = heap;
+
+	if (heap->live < LONE_LISP_HEAP_VALUE_COUNT) {
+		heap->next_available = lone->available_heaps;
+		lone->available_heaps = heap;
+	}
+}
+
+static bool lone_lisp_adopt_heaps_swept_by_sweeper(struct lone_lisp *lone)
+{
+	struct lone_lisp_heap *heap, *next;
+
+	heap = __atomic_exchange_n(&lone->garbage_collector.sweeper.swept, 0, __ATOMIC_ACQUIRE);
+	if (!heap) { return false; }
+
+	for (/* heap */; heap; heap = next) {
+		next = heap->next;
+		lone_lisp_adopt_swept_heap(lone, heap);
+	}
+
+	return true;
+}
+
+/* live heaps are handed back to the interpreter, dead heaps are deallocated right away */
+static void lone_lisp_sweeper_thread(void *argument)
+{
+	struct lone_lisp *lone = argument;
+	struct lone_lisp_heap *heap;
+	lone_u32 generation;
+
+	while (1) {
+		while ((generation = __atomic_load_n(&lone->garbage_collector.sweeper.generation, __ATOMIC_ACQUIRE)) ==
+		       lone->garbage_collector.sweeper.finished) {
+			linux_futex(&lone->garbage_collector.sweeper.generation, FUTEX_WAIT_PRIVATE, generation);
+		}
+
+		if (lone->garbage_collector.sweeper.stopping) { return; }
+
+		while ((heap = lone_lisp_claim_next_unswept_heap(lone))) {
+			lone_lisp_sweep_heap(lone, heap);
+
+			if (heap->live) {
+				heap->next = __atomic_load_n(&lone->garbage_collector.sweeper.swept, __ATOMIC_RELAXED);
+				while (!__atomic_compare_exchange_n(&lone->garbage_collector.sweeper.swept,
+						&heap->next, heap, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+			} else {
+				lone_lisp_heap_destroy(lone, heap);
+				lone->garbage_collector.sweeper.released += 1;
+			}
+		}
+
+		lone_memory_trim(lone->system);
+
+		__atomic_store_n(&lone->garbage_collector.sweeper.finished, generation, __ATOMIC_RELEASE);
+		linux_futex(&lone->garbage_collector.sweeper.finished, FUTEX_WAKE_PRIVATE, 1);
+	}
+}
+
+static void lone_lisp_sweeper_start(struct lone_lisp *lone)
+{
+	intptr_t stack;
+
+	if (!lone->garbage_collector.sweeper.stack) {
+		stack = linux_mmap(0, LONE_LISP_GARBAGE_COLLECTOR_THREAD_STACK_SIZE,
+				PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK, -1, 0);
+		if (stack < 0) { linux_exit(-1); }
+
+		lone->garbage_collector.sweeper.stack = (void *) stack;
+		lone->garbage_collector.sweeper.finished = lone->garbage_collector.sweeper.generation;
+
+		if (linux_thread_create(lone->garbage_collector.sweeper.stack, LONE_LISP_GARBAGE_COLLECTOR_THREAD_STACK_SIZE,
+				lone_lisp_sweeper_thread, lone, &lone->garbage_collector.sweeper.thread) < 0) {
+			linux_exit(-1);
+		}
+	}
+
+	lone->garbage_collector.sweeper.active = true;
+	lone->system->memory.threads += 1;
+
+	__atomic_add_fetch(&lone->garbage_collector.sweeper.generation, 1, __ATOMIC_RELEASE);
+	linux_futex(&lone->garbage_collector.sweeper.generation, FUTEX_WAKE_PRIVATE, 1);
+}
+
+/* the interpreter sweeps whatever is left instead of just waiting for the sweeper */
+void lone_lisp_garbage_collector_join_sweeper(struct lone_lisp *lone)
+{
+	struct lone_lisp_heap *heap;
+	lone_u32 finished;
+
+	if (!lone->garbage_collector.sweeper.active) { return; }
+
+	while ((heap = lone_lisp_claim_next_unswept_heap(lone))) {
+		lone_lisp_sweep_heap(lone, heap);
+		lone_lisp_adopt_swept_heap(lone, heap);
+	}
+
+	while ((finished = __atomic_load_n(&lone->garbage_collector.sweeper.finished, __ATOMIC_ACQUIRE)) !=
+	       lone->garbage_collector.sweeper.generation) {
+		linux_futex(&lone->garbage_collector.sweeper.finished, FUTEX_WAIT_PRIVATE, finished);
+	}
+
+	lone_lisp_adopt_heaps_swept_by_sweeper(lone);
+
+	lone->system->memory.threads -= 1;
+	lone->garbage_collector.sweeper.active = false;
+	lone->statistics.heap.pages -= lone->garbage_collector.sweeper.released;
+	lone->garbage_collector.sweeper.released = 0;
+}
+
+/* allocation sweeps heaps one at a time, their dead values become available */
+bool lone_lisp_garbage_collector_sweep_next_heap(struct lone_lisp *lone)
+{
+	struct lone_lisp_heap *heap;
+
+	if (lone->garbage_collector.sweeper.active && lone_lisp_adopt_heaps_swept_by_sweeper(lone)) {
+		return true;
+	}
+
+	heap = lone_lisp_claim_next_unswept_heap(lone);
+	if (!heap) { return false; }
+
+	lone_lisp_sweep_heap(lone, heap);
+	lone_lisp_adopt_swept_heap(lone, heap);
+
+	return true;
+}
+
+static void lone_lisp_sweep_remaining_heaps(struct lone_lisp *lone)
+{
+	lone_lisp_garbage_collector_join_sweeper(lone);
+
+	while (lone_lisp_garbage_collector_sweep_next_heap(lone));
+}
+
+/* minor cycles only mark young values: the marks of young heaps belong to them alone */
+static void lone_lisp_kill_all_unmarked_young_values(struct lone_lisp *lone)
+{
+	struct lone_lisp_heap *heap;
+
+	for (heap = lone->young_heaps; heap; heap = heap->next_young) {
+		lone->garbage_collector.old += lone_lisp_sweep_values(lone, heap, heap->nursery);
+	}
+
+	lone->young_heaps = 0;
+}
+
+static size_t lone_lisp_grow_threshold(size_t survivors, size_t survival, size_t minimum)
+{
+	size_t growth = survivors * survival / 100;
+	return survivors + (growth > minimum? growth : minimum);
+}
+
+/* survival is the percentage of the values examined by the major cycle that are still alive */
+static void lone_lisp_garbage_collector_adapt(struct lone_lisp *lone, size_t live, size_t examined)
+{
+	size_t survival, allocated;
+
+	survival = examined? lone_min(live, examined) * 100 / examined : 100;
+	allocated = lone->system->memory.statistics.allocated;
+
+	lone->garbage_collector.threshold.values = lone_lisp_grow_threshold(live, survival,
+			LONE_LISP_GARBAGE_COLLECTOR_MINIMUM_VALUES);
+	lone->garbage_collector.threshold.bytes = lone_lisp_grow_threshold(allocated, survival,
+			LONE_LISP_GARBAGE_COLLECTOR_MINIMUM_BYTES);
+
+	lone->garbage_collector.old = live;
+}
+
+static lone_u64 lone_lisp_garbage_collector_now(void)
+{
+	struct __kernel_timespec now;
+
+	if (linux_clock_gettime(CLOCK_MONOTONIC, &now) < 0) { linux_exit(-1); }
+
+	return (lone_u64) now.tv_sec * 1000000000 + (lone_u64) now.tv_nsec;
+}
+
+/* bucket i counts pauses shorter than 2ⁱ microseconds, the last one counts all longer pauses */
+static void lone_lisp_garbage_collector_record_pause(struct lone_lisp *lone, lone_u64 started)
+{
+	lone_u64 nanoseconds, microseconds;
+	size_t bucket;
+
+	nanoseconds = lone_lisp_garbage_collector_now() - started;
+
+	for (bucket = 0, microseconds = nanoseconds / 1000; microseconds; microseconds >>= 1) {
+		++bucket;
+	}
+
+	if (bucket >= LONE_LISP_GARBAGE_COLLECTOR_PAUSE_BUCKETS) {
+		bucket = LONE_LISP_GARBAGE_COLLECTOR_PAUSE_BUCKETS - 1;
+	}
+
+	lone->statistics.pauses.count += 1;
+	lone->statistics.pauses.total += nanoseconds;
+	lone->statistics.pauses.histogram[bucket] += 1;
+
+	if (nanoseconds > lone->statistics.pauses.maximum) {
+		lone->statistics.pauses.maximum = nanoseconds;
+	}
+}
+
+static void lone_lisp_garbage_collector_finish_cycle(struct lone_lisp *lone)
+{
+	lone->garbage_collector.allocations = 0;
+	lone->garbage_collector.allocated = lone->system->memory.statistics.allocated;
+	lone->statistics.heap.collections += 1;
+}
+
+/* the heaps are fragmented if few of their values are live once they have been swept */
+static void lone_lisp_garbage_collector_consider_compaction(struct lone_lisp *lone)
+{
+	size_t capacity = lone->statistics.heap.pages * LONE_LISP_HEAP_VALUE_COUNT;
+	struct lone_lisp_heap *heap;
+	size_t live;
+
+	for (live = 0, heap = lone->heaps; heap; heap = heap->next) { live += heap->live; }
+
+	if (lone->statistics.heap.pages > 1 &&
+	    live * 100 < capacity * LONE_LISP_GARBAGE_COLLECTOR_COMPACTION_OCCUPANCY) {
+		lone->garbage_collector.compaction.requested = true;
+	}
+}
+
+/* surviving young values are promoted as they are swept, all of them are counted as old already */
+static void lone_lisp_garbage_collector_start_sweeping(struct lone_lisp *lone, size_t examined)
+{
+	struct lone_lisp_heap *heap;
+
+	for (heap = lone->heaps; heap; heap = heap->next) {
+		heap->unswept = true;
+		heap->claimed = false;
+		heap->next_unswept = heap->next;
+	}
+
+	/* heaps only rejoin the list once they have been swept */
+	lone->unswept_heaps = lone->heaps;
+	lone->heaps = 0;
+	lone->available_heaps = 0;
+	lone->young_heaps = 0;
+	lone->garbage_collector.sweeping = true;
+
+	lone_lisp_garbage_collector_adapt(lone, lone->garbage_collector.marker.marked, examined);
+	lone_lisp_garbage_collector_finish_cycle(lone);
+
+	if (lone->garbage_collector.sweeper.enabled) {
+		lone_lisp_sweeper_start(lone);
+	}
+}
+
+static void lone_lisp_garbage_collector_finish_sweeping(struct lone_lisp *lone)
+{
+	if (!lone->garbage_collector.sweeping) { return; }
+
+	lone_lisp_sweep_remaining_heaps(lone);
+
+	lone->garbage_collector.sweeping = false;
+
+	lone_lisp_deallocate_dead_heaps(lone);
+	lone_memory_trim(lone->system);
+	lone_lisp_garbage_collector_consider_compaction(lone);
+}
+
+static void lone_lisp_garbage_collector_cycle(struct lone_lisp *lone, bool minor)
+{
+	size_t examined;
+
+	/* running out of memory while collecting must not start another cycle */
+	if (lone->garbage_collector.running) { return; }
+	lone->garbage_collector.running = true;
+
+	/* marking reuses the marks left in unswept heaps */
+	lone_lisp_garbage_collector_finish_sweeping(lone);
+
+	lone->garbage_collector.minor = minor;
+	lone->garbage_collector.marker.marked = 0;
+	lone->garbage_collector.weak.count = 0;
+
+	examined = lone->garbage_collector.old + lone->garbage_collector.allocations;
+
+	lone_lisp_mark_all_reachable_values(lone);
+	lone_lisp_mark_gray_values(lone, (size_t) -1);
+	lone_lisp_clear_weak_tables(lone);
+
+	if (minor) {
+		lone_lisp_kill_all_unmarked_young_values(lone);
+		lone_lisp_deallocate_dead_heaps(lone);
+		lone_lisp_garbage_collector_finish_cycle(lone);
+		lone->statistics.heap.minor_collections += 1;
+	} else {
+		lone_lisp_garbage_collector_start_sweeping(lone, examined);
+	}
+
+	lone->garbage_collector.minor = false;
+	lone->garbage_collector.running = false;
+}
+
+static void lone_lisp_garbage_collector_start_marking(struct lone_lisp *lone)
+{
+	if (lone->garbage_collector.running) { return; }
+	lone->garbage_collector.running = true;
+
+	lone_lisp_garbage_collector_finish_sweeping(lone);
+
+	lone->garbage_collector.marker.marked = 0;
+	lone->garbage_collector.weak.count = 0;
+	lone->garbage_collector.incremental.marking = true;
+	lone->garbage_collector.incremental.allocations = 0;
+	lone->garbage_collector.incremental.examined =
+		lone->garbage_collector.old + lone->garbage_collector.allocations;
+
+	lone_lisp_mark_all_reachable_values(lone);
+
+	lone->garbage_collector.running = false;
+}
+
+/* the roots may have changed since marking started: they are marked again before sweeping */
+static void lone_lisp_garbage_collector_finish_marking(struct lone_lisp *lone)
+{
+	lone_lisp_mark_all_reachable_values(lone);
+	lone_lisp_mark_gray_values(lone, (size_t) -1);
+
+	lone->garbage_collector.incremental.marking = false;
+
+	lone_lisp_clear_weak_tables(lone);
+
+	lone_lisp_garbage_collector_start_sweeping(lone, lone->garbage_collector.incremental.examined);
+}
+
+static void lone_lisp_garbage_collector_mark_slice(struct lone_lisp *lone)
+{
+	if (lone->garbage_collector.running) { return; }
+	lone->garbage_collector.running = true;
+
+	/* incremental marking may have been disabled since it started */
+	lone_lisp_mark_gray_values(lone, lone->garbage_collector.incremental.slice?
+			lone->garbage_collector.incremental.slice : (size_t) -1);
+	lone->statistics.heap.slices += 1;
+
+	if (lone_lisp_mark_stack_is_empty(&lone->garbage_collector.marker.stack)) {
+		lone_lisp_garbage_collector_finish_marking(lone);
+	}
+
+	lone->garbage_collector.running = false;
+}
+
+/* survivors are appended to the fresh heaps in the order they are copied */
+struct lone_lisp_compaction {
+	struct lone_lisp_heap *heaps;
+	struct lone_lisp_heap *last;
+};
+
+static struct lone_lisp_heap_value *lone_lisp_compaction_copy(struct lone_lisp *lone,
+		struct lone_lisp_compaction *compaction, struct lone_lisp_heap_value *value)
+{
+	struct lone_lisp_heap *heap = compaction->last;
+	struct lone_lisp_heap_value *copy;
+
+	if (value->forwarded) { return value->as.forwarding; }
+
+	/* precise roots never refer to dead values */
+	if (LONE_LISP_GARBAGE_COLLECTOR_STRESS && !value->live) { linux_exit(-1); }
+
+	if (!heap || heap->live == LONE_LISP_HEAP_VALUE_COUNT) {
+		heap = lone_lisp_heap_create(lone);
+
+		if (compaction->last) {
+			compaction->last->next = heap;
+		} else {
+			compaction->heaps = heap;
+		}
+
+		compaction->last = heap;
+	}
+
+	copy = &heap->values[heap->live];
+	lone_bits_set(heap->occupied, heap->live, true);
+	heap->live += 1;
+
+	*copy = *value;
+	if (copy->sampled) { lone_lisp_profiler_move_value(lone, value, copy); }
+	copy->remembered = false;
+	copy->old = true;
+
+	value->forwarded = true;
+	value->as.forwarding = copy;
+
+	return copy;
+}
+
+static void lone_lisp_compaction_forward(struct lone_lisp *lone,
+		struct lone_lisp_compaction *compaction, struct lone_lisp_value *value)
+{
+	if (!lone_lisp_is_heap_value(*value)) { return; }
+
+	value->as.heap_value = lone_lisp_compaction_copy(lone, compaction, value->as.heap_value);
+}
+
+static void lone_lisp_compaction_forward_children(struct lone_lisp *lone,
+		struct lone_lisp_compaction *compaction, struct lone_lisp_heap_value *value)
+{
+	switch (value->type) {
+	case LONE_LISP_TYPE_MODULE:
+		lone_lisp_compaction_forward(lone, compaction, &value->as.module.name);
+		lone_lisp_compaction_forward(lone, compaction, &value->as.module.environment);
+		lone_lisp_compaction_forward(lone, compaction, &value->as.module.exports);
+		break;
+	case LONE_LISP_TYPE_FUNCTION:
+		lone_lisp_compaction_forward(lone, compaction, &value->as.function.arguments);
+		lone_lisp_compaction_forward(lone, compaction, &value->as.function.code);
+		lone_lisp_compaction_forward(lone, compaction, &value->as.function.environment);
+		break;
+	case LONE_LISP_TYPE_PRIMITIVE:
+		lone_lisp_compaction_forward(lone, compaction, &value->as.primitive.name);
+		lone_lisp_compaction_forward(lone, compaction, &value->as.primitive.closure);
+		break;
+	case LONE_LISP_TYPE_LIST:
+		lone_lisp_compaction_forward(lone, compaction, &value->as.list.first);
+		lone_lisp_compaction_forward(lone, compaction, &value->as.list.rest);
+		break;
+	case LONE_LISP_TYPE_VECTOR:
+		for (size_t i = 0; i < value->as.vector.count; ++i) {
+			lone_lisp_compaction_forward(lone, compaction, &value->as.vector.values[i]);
+		}
+		break;
+	case LONE_LISP_TYPE_TABLE:
+		lone_lisp_compaction_forward(lone, compaction, &value->as.table.prototype);
+		for (size_t i = 0; i < value->as.table.count; ++i) {
+			lone_lisp_compaction_forward(lone, compaction, &value->as.table.entries[i].key);
+			lone_lisp_compaction_forward(lone, compaction, &value->as.table.entries[i].value);
+		}
+		break;
+	case LONE_LISP_TYPE_SYMBOL:
+	case LONE_LISP_TYPE_TEXT:
+	case LONE_LISP_TYPE_BYTES:
+		/* these types do not contain any other values to forward */
+		break;
+	}
+}
+
+static void lone_lisp_compaction_forward_roots(struct lone_lisp *lone, struct lone_lisp_compaction *compaction)
+{
+	struct lone_lisp_roots *roots = &lone->garbage_collector.roots;
+	size_t i;
+
+	lone_lisp_compaction_forward(lone, compaction, &lone->symbol_table);
+	lone_lisp_compaction_forward(lone, compaction, &lone->constants.truth);
+	lone_lisp_compaction_forward(lone, compaction, &lone->modules.loaded);
+	lone_lisp_compaction_forward(lone, compaction, &lone->modules.embedded);
+	lone_lisp_compaction_forward(lone, compaction, &lone->modules.null);
+	lone_lisp_compaction_forward(lone, compaction, &lone->modules.top_level_environment);
+	lone_lisp_compaction_forward(lone, compaction, &lone->modules.path);
+
+	for (i = 0; i < roots->count; ++i) {
+		lone_lisp_compaction_forward(lone, compaction, roots->values[i]);
+	}
+}
+
+/* the heaps grow while they are scanned: copied values are scanned in breadth first order */
+static void lone_lisp_compaction_scan(struct lone_lisp *lone, struct lone_lisp_compaction *compaction)
+{
+	struct lone_lisp_heap *heap;
+	size_t i;
+
+	for (heap = compaction->heaps; heap; heap = heap->next) {
+		for (i = 0; i < heap->live; ++i) {
+			lone_lisp_compaction_forward_children(lone, compaction, &heap->values[i]);
+		}
+	}
+}
+
+/* every key has moved by now, including the elements of list keys */
+static void lone_lisp_compaction_rehash_tables(struct lone_lisp *lone, struct lone_lisp_compaction *compaction)
+{
+	struct lone_lisp_heap *heap;
+	size_t i;
+
+	for (heap = compaction->heaps; heap; heap = heap->next) {
+		for (i = 0; i < heap->live; ++i) {
+			if (heap->values[i].type != LONE_LISP_TYPE_TABLE) { continue; }
+			lone_lisp_table_rehash(lone, lone_lisp_value_from_heap_value(&heap->values[i]));
+		}
+	}
+}
+
+/* values that were not copied are dead, the memory they own is released with their heaps */
+static void lone_lisp_compaction_release(struct lone_lisp *lone, struct lone_lisp_heap *heap)
+{
+	struct lone_lisp_heap *next;
+	size_t i;
+
+	for (; heap; heap = next) {
+		next = heap->next;
+
+		for (i = 0; i < LONE_LISP_HEAP_VALUE_COUNT; ++i) {
+			if (!heap->values[i].live || heap->values[i].forwarded) { continue; }
+			lone_lisp_kill_value(lone, heap, &heap->values[i]);
+		}
+
+		lone_lisp_heap_destroy(lone, heap);
+	}
+}
+
+static void lone_lisp_garbage_collector_compact(struct lone_lisp *lone)
+{
+	struct lone_lisp_compaction compaction = { .heaps = 0, .last = 0 };
+	struct lone_lisp_heap *heap;
+	size_t examined, pages, live;
+
+	examined = lone->garbage_collector.old + lone->garbage_collector.allocations;
+
+	/* unswept heaps are not listed with the others, their dead values must be killed first */
+	lone_lisp_sweep_remaining_heaps(lone);
+
+	/* copying finds every live value by itself: an unfinished incremental cycle is abandoned */
+	lone->garbage_collector.incremental.marking = false;
+	lone->garbage_collector.marker.stack.top = 0;
+	lone->garbage_collector.marker.stack.bottom = 0;
+	lone->garbage_collector.remembered.count = 0;
+	lone->garbage_collector.weak.count = 0;
+
+	lone_lisp_compaction_forward_roots(lone, &compaction);
+	lone_lisp_compaction_scan(lone, &compaction);
+	lone_lisp_compaction_rehash_tables(lone, &compaction);
+	lone_lisp_compaction_release(lone, lone->heaps);
+
+	if (!compaction.heaps) { compaction.heaps = lone_lisp_heap_create(lone); }
+
+	for (pages = 0, live = 0, heap = compaction.heaps; heap; heap = heap->next) {
+		live += heap->live;
+		++pages;
+	}
+
+	lone->heaps = compaction.heaps;
+	lone->young_heaps = 0;
+	lone->garbage_collector.sweeping = false;
+	lone->statistics.heap.pages = pages;
+
+	lone_lisp_deallocate_dead_heaps(lone);
+	lone_memory_trim(lone->system);
+	lone_lisp_garbage_collector_adapt(lone, live, examined);
+	lone_lisp_garbage_collector_finish_cycle(lone);
+	lone->garbage_collector.compaction.requested = false;
+	lone->statistics.heap.compactions += 1;
+}
+
+void lone_lisp_garbage_collector(struct lone_lisp *lone)
+{
+	lone_u64 started;
+
+	if (lone->garbage_collector.running) { return; }
+
+	started = lone_lisp_garbage_collector_now();
+
+	if (lone->garbage_collector.incremental.marking) {
+		lone->garbage_collector.running = true;
+		lone_lisp_garbage_collector_finish_marking(lone);
+		lone->garbage_collector.running = false;
+	} else {
+		lone_lisp_garbage_collector_cycle(lone, false);
+	}
+
+	/* memory is needed right away */
+	lone->garbage_collector.running = true;
+	lone_lisp_garbage_collector_finish_sweeping(lone);
+	lone->garbage_collector.running = false;
+
+	lone_lisp_garbage_collector_record_pause(lone, started);
+}
+
+/* unfinished major cycles examine the young values as well */
+void lone_lisp_garbage_collector_minor(struct lone_lisp *lone)
+{
+	lone_u64 started;
+
+	if (lone->garbage_collector.running) { return; }
+
+	if (lone->garbage_collector.incremental.marking) {
+		lone_lisp_garbage_collector(lone);
+		return;
+	}
+
+	started = lone_lisp_garbage_collector_now();
+	lone_lisp_garbage_collector_cycle(lone, true);
+	lone_lisp_garbage_collector_record_pause(lone, started);
+}
+
+/* incrementally marked cycles only get their first slice, the heaps are swept as they are needed */
+void lone_lisp_garbage_collector_major(struct lone_lisp *lone)
+{
+	lone_u64 started;
+
+	if (lone->garbage_collector.running || lone->garbage_collector.incremental.marking) { return; }
+
+	started = lone_lisp_garbage_collector_now();
+
+	if (lone->garbage_collector.incremental.slice) {
+		lone_lisp_garbage_collector_start_marking(lone);
+		lone_lisp_garbage_collector_mark_slice(lone);
+	} else {
+		lone_lisp_garbage_collector_cycle(lone, false);
+	}
+
+	lone_lisp_garbage_collector_record_pause(lone, started);
+}
+
+void lone_lisp_garbage_collector_on_allocation(struct lone_lisp *lone)
+{
+	size_t allocated = lone->system->memory.statistics.allocated;
+	lone_u64 started;
+	bool major;
+
+	++lone->garbage_collector.allocations;
+
+	if (LONE_LISP_GARBAGE_COLLECTOR_STRESS) {
+		/* values that are not rooted die right away */
+		lone_lisp_garbage_collector(lone);
+		return;
+	}
+
+	if (lone->garbage_collector.incremental.marking) {
+		/* marking must outpace allocation */
+		if (++lone->garbage_collector.incremental.allocations * LONE_LISP_GARBAGE_COLLECTOR_MARKING_RATE <
+		    lone->garbage_collector.incremental.slice) {
+			return;
+		}
+
+		lone->garbage_collector.incremental.allocations = 0;
+
+		started = lone_lisp_garbage_collector_now();
+		lone_lisp_garbage_collector_mark_slice(lone);
+		lone_lisp_garbage_collector_record_pause(lone, started);
+		return;
+	}
+
+	if (lone->garbage_collector.allocations < LONE_LISP_GARBAGE_COLLECTOR_NURSERY_VALUES &&
+	    (allocated <= lone->garbage_collector.allocated ||
+	     allocated - lone->garbage_collector.allocated < LONE_LISP_GARBAGE_COLLECTOR_MINIMUM_BYTES)) {
+		return;
+	}
+
+	major = lone->garbage_collector.old >= lone->garbage_collector.threshold.values ||
+	        allocated >= lone->garbage_collector.threshold.bytes;
+
+	started = lone_lisp_garbage_collector_now();
+
+	if (major && lone->garbage_collector.incremental.slice) {
+		lone_lisp_garbage_collector_start_marking(lone);
+	} else {
+		lone_lisp_garbage_collector_cycle(lone, !major);
+	}
+
+	lone_lisp_garbage_collector_record_pause(lone, started);
+}
+
+/* callers guarantee that no values are referenced by anything but rooted variables */
+void lone_lisp_garbage_collector_safe_point(struct lone_lisp *lone)
+{
+	lone_u64 started;
+
+	if (!LONE_LISP_GARBAGE_COLLECTOR_STRESS && !lone->garbage_collector.compaction.requested) { return; }
+
+	/* conservatively found words might not be values at all and cannot be updated */
+	if (lone->garbage_collector.running || lone->garbage_collector.conservative) { return; }
+
+	started = lone_lisp_garbage_collector_now();
+
+	lone->garbage_collector.running = true;
+	lone_lisp_garbage_collector_compact(lone);
+	lone->garbage_collector.running = false;
+
+	lone_lisp_garbage_collector_record_pause(lone, started);
+}
+
+static void lone_lisp_garbage_collector_remember(struct lone_lisp *lone,
+		struct lone_lisp_heap_value *value, size_t slot)
+{
+	size_t capacity;
+
+	if (lone->garbage_collector.remembered.count == lone->garbage_collector.remembered.capacity) {
+		capacity = lone->garbage_collector.remembered.capacity;
+		capacity = capacity? 2 * capacity : 64;
+		lone->garbage_collector.remembered.values = lone_memory_array(lone->system,
+				lone->garbage_collector.remembered.values, capacity,
+				sizeof(*lone->garbage_collector.remembered.values));
+		lone->garbage_collector.remembered.capacity = capacity;
+	}
+
+	lone->garbage_collector.remembered.values[lone->garbage_collector.remembered.count++] =
+		(struct lone_lisp_remembered_value) { .value = value, .slot = slot };
+}
+
+/* marked values in unswept heaps are promoted once they are swept */
+static bool lone_lisp_is_old_to_young(struct lone_lisp_heap_value *object, struct lone_lisp_value value)
+{
+	return (object->old || lone_lisp_is_marked(object)) && lone_lisp_is_heap_value(value) && !value.as.heap_value->old;
+}
+
+/* black values must never point to white values */
+static void lone_lisp_garbage_collector_shade(struct lone_lisp *lone,
+		struct lone_lisp_heap_value *object, struct lone_lisp_value value)
+{
+	if (!lone->garbage_collector.incremental.marking || !lone_lisp_is_heap_value(value)) { return; }
+
+	lone_lisp_mark_stack_reserve(&lone->garbage_collector.marker);
+
+	/* reserving space may have finished the cycle */
+	if (lone->garbage_collector.incremental.marking && lone_lisp_is_marked(object)) {
+		lone_lisp_mark_heap_value(&lone->garbage_collector.marker, value.as.heap_value);
+	}
+}
+
+/* the sweeper may be writing to the flags of values in unswept heaps */
+static void lone_lisp_garbage_collector_sweep_before_writing(struct lone_lisp *lone,
+		struct lone_lisp_heap_value *object)
+{
+	struct lone_lisp_heap *heap;
+
+	if (!lone->garbage_collector.sweeper.active) { return; }
+
+	heap = lone_lisp_heap_of(object);
+	if (!__atomic_load_n(&heap->unswept, __ATOMIC_ACQUIRE)) { return; }
+
+	if (lone_lisp_claim_unswept_heap(lone, heap)) {
+		lone_lisp_sweep_heap(lone, heap);
+		lone_lisp_adopt_swept_heap(lone, heap);
+		return;
+	}
+
+	while (__atomic_load_n(&heap->unswept, __ATOMIC_ACQUIRE)) {
+		linux_sched_yield();
+	}
+}
+
+void lone_lisp_garbage_collector_write_barrier(struct lone_lisp *lone,
+		struct lone_lisp_value object, struct lone_lisp_value value)
+{
+	struct lone_lisp_heap_value *actual = object.as.heap_value;
+
+	lone_lisp_garbage_collector_sweep_before_writing(lone, actual);
+	lone_lisp_garbage_collector_shade(lone, actual, value);
+
+	if (actual->remembered || !lone_lisp_is_old_to_young(actual, value)) { return; }
+
+	lone_lisp_garbage_collector_remember(lone, actual, (size_t) -1);
+	actual->remembered = true;
+}
+
+void lone_lisp_garbage_collector_write_barrier_at(struct lone_lisp *lone,
+		struct lone_lisp_value vector, size_t i, struct lone_lisp_value value)
+{
+	struct lone_lisp_heap_value *actual = vector.as.heap_value;
+
+	lone_lisp_garbage_collector_sweep_before_writing(lone, actual);
+	lone_lisp_garbage_collector_shade(lone, actual, value);
+
+	if (actual->remembered || !lone_lisp_is_old_to_young(actual, value)) { return; }
+
+	lone_lisp_garbage_collector_remember(lone, actual, i);
+}
+
+size_t lone_lisp_roots_save(struct lone_lisp *lone)
+{
+	return lone->garbage_collector.roots.count;
+}
+
+/* a free slot is always kept: growing may trigger a cycle but rooting must not lose values */
+void lone_lisp_root(struct lone_lisp *lone, struct lone_lisp_value *value)
+{
+	struct lone_lisp_roots *roots = &lone->garbage_collector.roots;
+	size_t capacity;
+
+	roots->values[roots->count++] = value;
+
+	if (roots->count == roots->capacity) {
+		capacity = 2 * roots->capacity;
+		roots->values = lone_memory_array(lone->system, roots->values, capacity, sizeof(*roots->values));
+		roots->capacity = capacity;
+	}
+}
+
+void lone_lisp_roots_restore(struct lone_lisp *lone, size_t roots)
+{
+	lone->garbage_collector.roots.count = roots;
+}
+
+/* memory may run out anywhere, including places where values have not been rooted yet */
+static void lone_lisp_garbage_collector_reclaim(void *context)
+{
+	struct lone_lisp *lone = context;
+	bool conservative = lone->garbage_collector.conservative;
+
+	lone->garbage_collector.conservative = true;
+	lone_lisp_garbage_collector(lone);
+	lone->garbage_collector.conservative = conservative;
+}
+
+void lone_lisp_garbage_collector_initialize(struct lone_lisp *lone)
+{
+	size_t i;
+
+	lone->garbage_collector.running = false;
+	lone->garbage_collector.minor = false;
+	lone->garbage_collector.conservative = LONE_LISP_GARBAGE_COLLECTOR_CONSERVATIVE;
+	lone->garbage_collector.sweeping = false;
+	lone->garbage_collector.old = 0;
+	lone->garbage_collector.allocations = 0;
+	lone->garbage_collector.allocated = lone->system->memory.statistics.allocated;
+	lone->garbage_collector.threshold.values = LONE_LISP_GARBAGE_COLLECTOR_MINIMUM_VALUES;
+	lone->garbage_collector.threshold.bytes = lone->garbage_collector.allocated +
+	                                          LONE_LISP_GARBAGE_COLLECTOR_MINIMUM_BYTES;
+	lone->garbage_collector.remembered.values = 0;
+	lone->garbage_collector.remembered.count = 0;
+	lone->garbage_collector.remembered.capacity = 0;
+	lone->garbage_collector.incremental.slice = LONE_LISP_GARBAGE_COLLECTOR_SLICE_VALUES;
+	lone->garbage_collector.incremental.marking = false;
+	lone->garbage_collector.incremental.allocations = 0;
+	lone->garbage_collector.incremental.examined = 0;
+	lone->garbage_collector.compaction.requested = false;
+	lone->garbage_collector.parallel.threads = LONE_LISP_GARBAGE_COLLECTOR_MARKING_THREADS;
+	lone->garbage_collector.parallel.started = 0;
+	lone->garbage_collector.parallel.markers = 0;
+	lone->garbage_collector.parallel.marking = false;
+	lone->garbage_collector.parallel.stopping = false;
+	lone->garbage_collector.parallel.generation = 0;
+	lone->garbage_collector.parallel.idle = 0;
+	lone->garbage_collector.parallel.finished = 0;
+	lone->garbage_collector.weak.tables = 0;
+	lone->garbage_collector.weak.count = 0;
+	lone->garbage_collector.weak.capacity = 0;
+	lone->garbage_collector.weak.lock = 0;
+	lone->garbage_collector.sweeper.enabled = LONE_LISP_GARBAGE_COLLECTOR_BACKGROUND_SWEEPING;
+	lone->garbage_collector.sweeper.active = false;
+	lone->garbage_collector.sweeper.stopping = false;
+	lone->garbage_collector.sweeper.generation = 0;
+	lone->garbage_collector.sweeper.finished = 0;
+	lone->garbage_collector.sweeper.thread = 0;
+	lone->garbage_collector.sweeper.lock = 0;
+	lone->garbage_collector.sweeper.stack = 0;
+	lone->garbage_collector.sweeper.swept = 0;
+	lone->garbage_collector.sweeper.released = 0;
+	lone->garbage_collector.marker.lone = lone;
+	lone->garbage_collector.marker.stack.buffer = 0;
+	lone->garbage_collector.marker.stack.top = 0;
+	lone->garbage_collector.marker.stack.bottom = 0;
+	lone->garbage_collector.marker.marked = 0;
+	lone->garbage_collector.marker.id = 0;
+	lone->garbage_collector.marker.generation = 0;
+	lone->garbage_collector.roots.count = 0;
+	lone->garbage_collector.roots.capacity = 64;
+	lone->garbage_collector.roots.values = lone_memory_array(lone->system, 0,
+			lone->garbage_collector.roots.capacity, sizeof(*lone->garbage_collector.roots.values));
+	lone->statistics.heap.collections = 0;
+	lone->statistics.heap.minor_collections = 0;
+	lone->statistics.heap.slices = 0;
+	lone->statistics.heap.compactions = 0;
+	lone->statistics.pauses.count = 0;
+	lone->statistics.pauses.total = 0;
+	lone->statistics.pauses.maximum = 0;
+
+	for (i = 0; i < LONE_LISP_GARBAGE_COLLECTOR_PAUSE_BUCKETS; ++i) {
+		lone->statistics.pauses.histogram[i] = 0;
+	}
+
+	lone->system->memory.reclaim.function = lone_lisp_garbage_collector_reclaim;
+	lone->system->memory.reclaim.context = lone;
+}
+
+static void lone_lisp_sweeper_stop(struct lone_lisp *lone)
+{
+	lone_u32 thread;
+
+	lone_lisp_garbage_collector_join_sweeper(lone);
+
+	if (!lone->garbage_collector.sweeper.stack) { return; }
+
+	lone->garbage_collector.sweeper.stopping = true;
+	__atomic_add_fetch(&lone->garbage_collector.sweeper.generation, 1, __ATOMIC_RELEASE);
+	linux_futex(&lone->garbage_collector.sweeper.generation, FUTEX_WAKE_PRIVATE, 1);
+
+	while ((thread = __atomic_load_n(&lone->garbage_collector.sweeper.thread, __ATOMIC_ACQUIRE))) {
+		linux_futex(&lone->garbage_collector.sweeper.thread, FUTEX_WAIT, thread);
+	}
+
+	linux_munmap(lone->garbage_collector.sweeper.stack, LONE_LISP_GARBAGE_COLLECTOR_THREAD_STACK_SIZE);
+	lone->garbage_collector.sweeper.stack = 0;
+	lone->garbage_collector.sweeper.stopping = false;
+}
+
+/* helper threads refer to the interpreter, they must be gone before it is */
+void lone_lisp_garbage_collector_finalize(struct lone_lisp *lone)
+{
+	struct lone_lisp_marker *marker;
+	lone_u32 thread;
+	size_t i;
+
+	lone_lisp_sweeper_stop(lone);
+
+	if (!lone->garbage_collector.parallel.started) { return; }
+
+	lone->garbage_collector.parallel.stopping = true;
+	__atomic_add_fetch(&lone->garbage_collector.parallel.generation, 1, __ATOMIC_RELEASE);
+	linux_futex(&lone->garbage_collector.parallel.generation, FUTEX_WAKE_PRIVATE, 0x7FFFFFFF);
+
+	for (i = 1; i <= lone->garbage_collector.parallel.started; ++i) {
+		marker = lone->garbage_collector.parallel.markers[i];
+
+		while ((thread = __atomic_load_n(&marker->thread, __ATOMIC_ACQUIRE))) {
+			linux_futex(&marker->thread, FUTEX_WAIT, thread);
+		}
+
+		linux_munmap(marker->thread_stack, LONE_LISP_GARBAGE_COLLECTOR_THREAD_STACK_SIZE);
+		if (marker->stack.buffer) { lone_deallocate(lone->system, marker->stack.buffer); }
+		lone_deallocate(lone->system, marker);
+	}
+
+	lone_deallocate(lone->system, lone->garbage_collector.parallel.markers);
+	lone->garbage_collector.parallel.markers = 0;
+	lone->garbage_collector.parallel.started = 0;
+	lone->garbage_collector.parallel.stopping = false;
 }
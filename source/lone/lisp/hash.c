@@ -2,6 +2,7 @@
 
 #include <lone/lisp/hash.h>
 #include <lone/lisp/types.h>
+#include <lone/lisp/value/pointer.h>
 
 #include <lone/hash/fnv_1a.h>
 
@@ -11,22 +12,27 @@ static size_t lone_lisp_hash_heap_value_recursively(struct lone_lisp_heap_value
 
 static size_t lone_lisp_hash_value_recursively(struct lone_lisp_value value, unsigned long hash)
 {
+	enum lone_lisp_value_type type;
+	union lone_lisp_pointer address;
 	struct lone_bytes bytes;
 
-	bytes.pointer = (unsigned char *) &value.type;
-	bytes.count = sizeof(value.type);
+	type = lone_lisp_type_of(value);
+	bytes.pointer = (unsigned char *) &type;
+	bytes.count = sizeof(type);
 	hash = lone_hash_fnv_1a(bytes, hash);
 
-	switch (value.type) {
+	switch (type) {
 	case LONE_LISP_TYPE_NIL:
 		return hash;
 	case LONE_LISP_TYPE_INTEGER:
-		bytes.pointer = (unsigned char *) &value.as.integer;
-		bytes.count = sizeof(value.as.integer);
+		bytes.pointer = (unsigned char *) &value.as.bits;
+		bytes.count = sizeof(value.as.bits);
 		break;
 	case LONE_LISP_TYPE_POINTER:
-		bytes.pointer = (unsigned char *) &value.as.pointer;
-		bytes.count = sizeof(value.as.pointer);
+		/* pointers to the same address are identical whatever their type */
+		address = lone_lisp_pointer_of(value);
+		bytes.pointer = (unsigned char *) &address;
+		bytes.count = sizeof(address);
 		break;
 	case LONE_LISP_TYPE_HEAP_VALUE:
 		return lone_lisp_hash_heap_value_recursively(value.as.heap_value, hash);
@@ -74,3 +80,9 @@ size_t lone_lisp_hash(struct lone_lisp *lone, struct lone_lisp_value value)
 {
 	return lone_lisp_hash_value_recursively(value, lone->system->hash.fnv_1a.offset_basis);
 }
+
+size_t lone_lisp_hash_identity(struct lone_lisp *lone, struct lone_lisp_value value)
+{
+	struct lone_bytes bytes = { sizeof(value.as.bits), (unsigned char *) &value.as.bits };
+	return lone_hash_fnv_1a(bytes, lone->system->hash.fnv_1a.offset_basis);
+}
@@ -1,57 +1,313 @@
 /* SPDX-License-Identifier: AGPL-3.0-or-later */
 
 #include <lone/memory/allocator.h>
+#include <lone/memory/functions.h>
+#include <lone/memory/array.h>
+#include <lone/linux.h>
+#include <lone/bits.h>
 
 #include <lone/lisp/heap.h>
+#include <lone/lisp/image.h>
+#include <lone/lisp/garbage_collector.h>
+#include <lone/lisp/profiler.h>
+
+/* the greatest heap address that is not greater than the given address, or the count */
+static size_t lone_lisp_heap_index_search(struct lone_lisp_heap_index *index, void *address)
+{
+	size_t low = 0, high = index->count, middle;
+
+	while (low < high) {
+		middle = low + (high - low) / 2;
+
+		if ((void *) index->heaps[middle] <= address) {
+			low = middle + 1;
+		} else {
+			high = middle;
+		}
+	}
+
+	return low? low - 1 : index->count;
+}
+
+/* the sweeper deallocates heaps while the interpreter creates them */
+static void lone_lisp_heap_index_lock(struct lone_lisp *lone)
+{
+	if (!lone->garbage_collector.sweeper.active) { return; }
+
+	while (__atomic_exchange_n(&lone->heap_index.lock, 1, __ATOMIC_ACQUIRE)) {
+		linux_sched_yield();
+	}
+}
+
+static void lone_lisp_heap_index_unlock(struct lone_lisp *lone)
+{
+	if (!lone->garbage_collector.sweeper.active) { return; }
+
+	__atomic_store_n(&lone->heap_index.lock, 0, __ATOMIC_RELEASE);
+}
+
+/* growing may trigger a cycle which waits for the sweeper, so it is never done while locked */
+static void lone_lisp_heap_index_grow(struct lone_lisp *lone)
+{
+	struct lone_lisp_heap_index *index = &lone->heap_index;
+	struct lone_lisp_heap **heaps, **old;
+	size_t capacity;
+
+	capacity = index->capacity? 2 * index->capacity : 16;
+	heaps = lone_memory_array(lone->system, 0, capacity, sizeof(*heaps));
+
+	/* the cycle triggered by the allocation may have grown the index already */
+	if (capacity <= index->capacity) {
+		lone_deallocate(lone->system, heaps);
+		return;
+	}
+
+	lone_lisp_heap_index_lock(lone);
+	lone_memory_move(index->heaps, heaps, index->count * sizeof(*heaps));
+	old = index->heaps;
+	index->heaps = heaps;
+	index->capacity = capacity;
+	lone_lisp_heap_index_unlock(lone);
+
+	if (old) { lone_deallocate(lone->system, old); }
+}
+
+static void lone_lisp_heap_index_insert(struct lone_lisp *lone, struct lone_lisp_heap *heap)
+{
+	struct lone_lisp_heap_index *index = &lone->heap_index;
+	size_t i;
+
+	/* the sweeper only ever removes heaps from the index */
+	if (index->count == index->capacity) {
+		lone_lisp_heap_index_grow(lone);
+	}
+
+	lone_lisp_heap_index_lock(lone);
+
+	i = lone_lisp_heap_index_search(index, heap);
+	i = i == index->count? 0 : i + 1;
+
+	lone_memory_move(&index->heaps[i], &index->heaps[i + 1], (index->count - i) * sizeof(*index->heaps));
+	index->heaps[i] = heap;
+	index->count += 1;
+
+	lone_lisp_heap_index_unlock(lone);
+}
+
+static void lone_lisp_heap_index_remove(struct lone_lisp *lone, struct lone_lisp_heap *heap)
+{
+	struct lone_lisp_heap_index *index = &lone->heap_index;
+	size_t i;
+
+	lone_lisp_heap_index_lock(lone);
+
+	i = lone_lisp_heap_index_search(index, heap);
+	index->count -= 1;
+	lone_memory_move(&index->heaps[i + 1], &index->heaps[i], (index->count - i) * sizeof(*index->heaps));
+
+	lone_lisp_heap_index_unlock(lone);
+}
+
+struct lone_lisp_heap *lone_lisp_heap_create(struct lone_lisp *lone)
+{
+	struct lone_lisp_heap *heap;
+
+	/* zero filled: all values and bits dead, the heap of a value is found by masking its address */
+	heap = lone_allocate_aligned(lone->system, sizeof(struct lone_lisp_heap), LONE_LISP_HEAP_ALIGNMENT);
+	lone_lisp_heap_index_insert(lone, heap);
+
+	return heap;
+}
+
+/* heaps of images are already laid out and aligned, their values are old and live */
+void lone_lisp_heap_adopt(struct lone_lisp *lone, struct lone_lisp_heap *heap)
+{
+	lone_lisp_heap_index_insert(lone, heap);
+
+	heap->next = lone->heaps;
+	lone->heaps = heap;
+
+	if (heap->live < LONE_LISP_HEAP_VALUE_COUNT) {
+		heap->next_available = lone->available_heaps;
+		lone->available_heaps = heap;
+	}
+
+	lone->statistics.heap.pages += 1;
+}
+
+/* images are never unmapped, their empty heaps are merely forgotten */
+void lone_lisp_heap_destroy(struct lone_lisp *lone, struct lone_lisp_heap *heap)
+{
+	lone_lisp_heap_index_remove(lone, heap);
+	if (lone_lisp_image_contains(lone, heap)) { return; }
+	lone_deallocate(lone->system, heap);
+}
+
+/* only pointers to the start of values are accepted, finding the heap takes a binary search */
+struct lone_lisp_heap_value *lone_lisp_heap_find_value(struct lone_lisp *lone, void *pointer)
+{
+	struct lone_lisp_heap *heap;
+	size_t i, offset;
+
+	i = lone_lisp_heap_index_search(&lone->heap_index, pointer);
+	if (i == lone->heap_index.count) { return 0; }
+
+	heap = lone->heap_index.heaps[i];
+
+	if (pointer < (void *) heap->values || pointer >= (void *) (heap->values + LONE_LISP_HEAP_VALUE_COUNT)) {
+		return 0;
+	}
+
+	offset = (size_t) ((unsigned char *) pointer - (unsigned char *) heap->values);
+	if (offset % sizeof(struct lone_lisp_heap_value)) { return 0; }
+
+	return &heap->values[offset / sizeof(struct lone_lisp_heap_value)];
+}
 
 struct lone_lisp_heap_value *lone_lisp_heap_allocate_value(struct lone_lisp *lone)
 {
 	struct lone_lisp_heap_value *element;
-	struct lone_lisp_heap *heap, *prev;
-	size_t i;
+	struct lone_lisp_heap *heap;
+	bool sampled;
+	lone_size i;
 
-	for (prev = lone->heaps, heap = prev; heap; prev = heap, heap = heap->next) {
-		for (i = 0; i < LONE_LISP_HEAP_VALUE_COUNT; ++i) {
-			element = &heap->values[i];
+	/* the profiler makes room for its sample before the value exists */
+	sampled = lone->profiler.interval && lone_lisp_profiler_should_sample_value(lone);
 
-			if (!element->live) {
-				goto resurrect;
-			}
-		}
+	lone_lisp_garbage_collector_on_allocation(lone);
+
+	while (!lone->available_heaps) {
+		if (!lone_lisp_garbage_collector_sweep_next_heap(lone)) { break; }
+	}
+
+	heap = lone->available_heaps;
+
+	if (!heap) {
+		heap = lone_lisp_heap_create(lone);
+		heap->next = lone->heaps;
+		heap->next_available = lone->available_heaps;
+		lone->heaps = heap;
+		lone->available_heaps = heap;
+		lone->statistics.heap.pages += 1;
 	}
 
-	heap = lone_allocate(lone->system, sizeof(struct lone_lisp_heap));
-	prev->next = heap;
-	heap->next = 0;
-	element = &heap->values[0];
+	i = lone_bits_find_first_zero(heap->occupied, sizeof(heap->occupied));
+	lone_bits_set(heap->occupied, i, true);
+	lone_bits_set(heap->nursery, i, true);
+	heap->live += 1;
 
-resurrect:
+	if (heap->young++ == 0) {
+		/* young values only die or grow old while collecting, which empties the list */
+		heap->next_young = lone->young_heaps;
+		lone->young_heaps = heap;
+	}
+
+	if (heap->live == LONE_LISP_HEAP_VALUE_COUNT) {
+		/* full heaps become available again when their values die */
+		lone->available_heaps = heap->next_available;
+		heap->next_available = 0;
+	}
+
+	/* values may be marked before their creators initialize them */
+	element = &heap->values[i];
+	lone_memory_zero(element, sizeof(*element));
 	element->live = true;
+	lone->statistics.heap.allocations += 1;
+
+	if (sampled) { lone_lisp_profiler_sample_value(lone, element); }
+
 	return element;
 }
 
+void lone_lisp_heap_kill_value(struct lone_lisp_heap *heap, struct lone_lisp_heap_value *value)
+{
+	lone_size i = (lone_size) (value - heap->values);
+
+	if (!value->old) {
+		lone_bits_set(heap->nursery, i, false);
+		heap->young -= 1;
+	}
+
+	value->live = false;
+	lone_bits_set(heap->occupied, i, false);
+	heap->live -= 1;
+}
+
+void lone_lisp_heap_promote_value(struct lone_lisp_heap *heap, struct lone_lisp_heap_value *value)
+{
+	value->old = true;
+	lone_bits_set(heap->nursery, (lone_size) (value - heap->values), false);
+	heap->young -= 1;
+}
+
 void lone_lisp_deallocate_dead_heaps(struct lone_lisp *lone)
 {
-	struct lone_lisp_heap *prev = lone->heaps, *heap = prev->next;
-	size_t i;
+	struct lone_lisp_heap **link, *heap, **available;
 
-	while (heap) {
-		for (i = 0; i < LONE_LISP_HEAP_VALUE_COUNT; ++i) {
-			if (heap->values[i].live) { /* at least one live object */ goto next_heap; }
+	link = &lone->heaps;
+	available = &lone->available_heaps;
+
+	while ((heap = *link)) {
+		/* the last heap is always kept */
+		if (!heap->live && heap->next) {
+			*link = heap->next;
+			lone_lisp_heap_destroy(lone, heap);
+			lone->statistics.heap.pages -= 1;
+			continue;
+		}
+
+		if (heap->live < LONE_LISP_HEAP_VALUE_COUNT) {
+			*available = heap;
+			available = &heap->next_available;
 		}
 
-		/* no live objects */
-		prev->next = heap->next;
-		lone_deallocate(lone->system, heap);
-		heap = prev->next;
-		continue;
-next_heap:
-		prev = heap;
-		heap = heap->next;
+		link = &heap->next;
 	}
+
+	*available = 0;
 }
 
 void lone_lisp_heap_initialize(struct lone_lisp *lone)
 {
-	lone->heaps = lone_allocate(lone->system, sizeof(struct lone_lisp_heap));
+	lone->heap_index.heaps = 0;
+	lone->heap_index.count = 0;
+	lone->heap_index.capacity = 0;
+	lone->heap_index.lock = 0;
+	lone->heaps = lone_lisp_heap_create(lone);
+	lone->available_heaps = lone->heaps;
+	lone->young_heaps = 0;
+	lone->unswept_heaps = 0;
+	lone->statistics.heap.pages = 1;
+	lone->statistics.heap.allocations = 0;
+}
+
+static void lone_lisp_heap_count_live_values_in(struct lone_lisp_heap *heap, size_t counts[LONE_LISP_HEAP_VALUE_TYPES])
+{
+	size_t i;
+
+	for (i = 0; i < LONE_LISP_HEAP_VALUE_COUNT; ++i) {
+		if (!heap->values[i].live) { continue; }
+		/* unmarked values in unswept heaps are already dead */
+		if (heap->unswept && !lone_bits_get(heap->marks, i)) { continue; }
+		counts[heap->values[i].type] += 1;
+	}
+}
+
+/* swept heaps are listed with the others, unswept heaps are only found by the sweepers */
+void lone_lisp_heap_count_live_values(struct lone_lisp *lone, size_t counts[LONE_LISP_HEAP_VALUE_TYPES])
+{
+	struct lone_lisp_heap *heap;
+	size_t i;
+
+	for (i = 0; i < LONE_LISP_HEAP_VALUE_TYPES; ++i) { counts[i] = 0; }
+
+	lone_lisp_garbage_collector_join_sweeper(lone);
+
+	for (heap = lone->heaps; heap; heap = heap->next) {
+		lone_lisp_heap_count_live_values_in(heap, counts);
+	}
+
+	for (heap = lone->unswept_heaps; heap; heap = heap->next_unswept) {
+		lone_lisp_heap_count_live_values_in(heap, counts);
+	}
 }
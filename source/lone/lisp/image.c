@@ -0,0 +1,589 @@
+/* SPDX-License-Identifier: AGPL-3.0-or-later */
+
+#include <lone/lisp/image.h>
+#include <lone/lisp/heap.h>
+#include <lone/lisp/value.h>
+#include <lone/lisp/garbage_collector.h>
+
+#include <lone/lisp/value/module.h>
+#include <lone/lisp/value/table.h>
+
+#include <lone/memory/allocator.h>
+#include <lone/memory/array.h>
+#include <lone/memory/functions.h>
+
+#include <lone/bits.h>
+#include <lone/linux.h>
+#include <lone/utilities.h>
+
+/* values are laid out in the order they were found, their index gives their place in the image */
+struct lone_lisp_image_slot {
+	struct lone_lisp_heap_value *value;
+	size_t index;
+};
+
+struct lone_lisp_image_writer {
+	struct lone_lisp *lone;
+	struct lone_lisp_heap_value **values;
+	size_t count;
+	size_t capacity;
+	struct lone_lisp_image_slot *slots;      /* indexes of the values by address */
+	size_t slot_count;                       /* power of two */
+	size_t owned;                            /* bytes of memory owned by the values */
+	unsigned char *image;
+	size_t heaps;                            /* offset of the first heap */
+	size_t data;                             /* offset of the next owned memory */
+};
+
+static size_t lone_lisp_image_align(size_t size, size_t alignment)
+{
+	return (size + alignment - 1) & ~(alignment - 1);
+}
+
+static struct lone_lisp_heap *lone_lisp_image_heap(unsigned char *image, size_t heaps, size_t i)
+{
+	return (struct lone_lisp_heap *) (image + heaps + i * LONE_LISP_HEAP_ALIGNMENT);
+}
+
+static size_t lone_lisp_image_owned_size(struct lone_lisp_heap_value *value)
+{
+	size_t size = 0;
+
+	switch (value->type) {
+	case LONE_LISP_TYPE_SYMBOL:
+	case LONE_LISP_TYPE_TEXT:
+	case LONE_LISP_TYPE_BYTES:
+		size = value->as.bytes.count + 1;
+		break;
+	case LONE_LISP_TYPE_VECTOR:
+		size = value->as.vector.count * sizeof(*value->as.vector.values);
+		break;
+	case LONE_LISP_TYPE_TABLE:
+		size = value->as.table.capacity *
+		       (sizeof(struct lone_lisp_table_entry) + sizeof(struct lone_lisp_table_index));
+		break;
+	case LONE_LISP_TYPE_MODULE:
+	case LONE_LISP_TYPE_FUNCTION:
+	case LONE_LISP_TYPE_PRIMITIVE:
+	case LONE_LISP_TYPE_LIST:
+		/* these types do not own any additional memory */
+		size = 0;
+		break;
+	}
+
+	return lone_lisp_image_align(size, LONE_ALIGNMENT);
+}
+
+static struct lone_lisp_image_slot *lone_lisp_image_slot_for(struct lone_lisp_image_writer *writer,
+		struct lone_lisp_heap_value *value)
+{
+	size_t mask = writer->slot_count - 1, i;
+
+	i = (size_t) ((((uintptr_t) value >> 3) * 0x9E3779B97F4A7C15UL) >> 17) & mask;
+
+	while (writer->slots[i].value && writer->slots[i].value != value) {
+		i = (i + 1) & mask;
+	}
+
+	return &writer->slots[i];
+}
+
+static void lone_lisp_image_grow_slots(struct lone_lisp_image_writer *writer)
+{
+	struct lone_lisp_image_slot *slots = writer->slots;
+	size_t count = writer->slot_count, i;
+
+	writer->slot_count = count? 2 * count : 1024;
+	writer->slots = lone_memory_array(writer->lone->system, 0, writer->slot_count, sizeof(*writer->slots));
+
+	for (i = 0; i < count; ++i) {
+		if (!slots[i].value) { continue; }
+		*lone_lisp_image_slot_for(writer, slots[i].value) = slots[i];
+	}
+
+	if (slots) { lone_deallocate(writer->lone->system, slots); }
+}
+
+static void lone_lisp_image_visit(struct lone_lisp_image_writer *writer, struct lone_lisp_value value)
+{
+	struct lone_lisp_image_slot *slot;
+	struct lone_lisp_heap_value *actual;
+
+	if (!lone_lisp_is_heap_value(value)) { return; }
+
+	actual = value.as.heap_value;
+
+	if (2 * (writer->count + 1) > writer->slot_count) {
+		lone_lisp_image_grow_slots(writer);
+	}
+
+	slot = lone_lisp_image_slot_for(writer, actual);
+	if (slot->value) { return; }
+
+	if (writer->count == writer->capacity) {
+		writer->capacity = writer->capacity? 2 * writer->capacity : 1024;
+		writer->values = lone_memory_array(writer->lone->system, writer->values,
+				writer->capacity, sizeof(*writer->values));
+	}
+
+	slot->value = actual;
+	slot->index = writer->count;
+	writer->values[writer->count++] = actual;
+	writer->owned += lone_lisp_image_owned_size(actual);
+}
+
+static void lone_lisp_image_visit_children(struct lone_lisp_image_writer *writer, struct lone_lisp_heap_value *value)
+{
+	size_t i;
+
+	switch (value->type) {
+	case LONE_LISP_TYPE_MODULE:
+		lone_lisp_image_visit(writer, value->as.module.name);
+		lone_lisp_image_visit(writer, value->as.module.environment);
+		lone_lisp_image_visit(writer, value->as.module.exports);
+		break;
+	case LONE_LISP_TYPE_FUNCTION:
+		lone_lisp_image_visit(writer, value->as.function.arguments);
+		lone_lisp_image_visit(writer, value->as.function.code);
+		lone_lisp_image_visit(writer, value->as.function.environment);
+		break;
+	case LONE_LISP_TYPE_PRIMITIVE:
+		lone_lisp_image_visit(writer, value->as.primitive.name);
+		lone_lisp_image_visit(writer, value->as.primitive.closure);
+		break;
+	case LONE_LISP_TYPE_LIST:
+		lone_lisp_image_visit(writer, value->as.list.first);
+		lone_lisp_image_visit(writer, value->as.list.rest);
+		break;
+	case LONE_LISP_TYPE_VECTOR:
+		for (i = 0; i < value->as.vector.count; ++i) {
+			lone_lisp_image_visit(writer, value->as.vector.values[i]);
+		}
+		break;
+	case LONE_LISP_TYPE_TABLE:
+		lone_lisp_image_visit(writer, value->as.table.prototype);
+		for (i = 0; i < value->as.table.count; ++i) {
+			lone_lisp_image_visit(writer, value->as.table.entries[i].key);
+			lone_lisp_image_visit(writer, value->as.table.entries[i].value);
+		}
+		break;
+	case LONE_LISP_TYPE_SYMBOL:
+	case LONE_LISP_TYPE_TEXT:
+	case LONE_LISP_TYPE_BYTES:
+		/* these types do not contain any other values to visit */
+		break;
+	}
+}
+
+static struct lone_lisp_heap_value *lone_lisp_image_copy_of(struct lone_lisp_image_writer *writer, size_t i)
+{
+	struct lone_lisp_heap *heap;
+
+	heap = lone_lisp_image_heap(writer->image, writer->heaps, i / LONE_LISP_HEAP_VALUE_COUNT);
+	return &heap->values[i % LONE_LISP_HEAP_VALUE_COUNT];
+}
+
+static struct lone_lisp_value lone_lisp_image_translate(struct lone_lisp_image_writer *writer, struct lone_lisp_value value)
+{
+	if (!lone_lisp_is_heap_value(value)) { return value; }
+
+	return lone_lisp_value_from_heap_value(
+		lone_lisp_image_copy_of(writer, lone_lisp_image_slot_for(writer, value.as.heap_value)->index)
+	);
+}
+
+static void *lone_lisp_image_own(struct lone_lisp_image_writer *writer, size_t size)
+{
+	void *pointer = writer->image + writer->data;
+	writer->data += lone_lisp_image_align(size, LONE_ALIGNMENT);
+	return pointer;
+}
+
+/* copies start out old and live, the memory they own is part of the image */
+static void lone_lisp_image_copy(struct lone_lisp_image_writer *writer,
+		struct lone_lisp_heap_value *value, struct lone_lisp_heap_value *copy)
+{
+	size_t i;
+
+	copy->live = true;
+	copy->old = true;
+	copy->type = value->type;
+	copy->flags = value->flags;
+	copy->weakness = value->weakness;
+
+	switch (value->type) {
+	case LONE_LISP_TYPE_MODULE:
+		copy->as.module.name = lone_lisp_image_translate(writer, value->as.module.name);
+		copy->as.module.environment = lone_lisp_image_translate(writer, value->as.module.environment);
+		copy->as.module.exports = lone_lisp_image_translate(writer, value->as.module.exports);
+		break;
+	case LONE_LISP_TYPE_FUNCTION:
+		copy->as.function.arguments = lone_lisp_image_translate(writer, value->as.function.arguments);
+		copy->as.function.code = lone_lisp_image_translate(writer, value->as.function.code);
+		copy->as.function.environment = lone_lisp_image_translate(writer, value->as.function.environment);
+		break;
+	case LONE_LISP_TYPE_PRIMITIVE:
+		copy->as.primitive.name = lone_lisp_image_translate(writer, value->as.primitive.name);
+		copy->as.primitive.function = value->as.primitive.function;
+		copy->as.primitive.closure = lone_lisp_image_translate(writer, value->as.primitive.closure);
+		break;
+	case LONE_LISP_TYPE_LIST:
+		copy->as.list.first = lone_lisp_image_translate(writer, value->as.list.first);
+		copy->as.list.rest = lone_lisp_image_translate(writer, value->as.list.rest);
+		break;
+	case LONE_LISP_TYPE_VECTOR:
+		copy->as.vector.count = value->as.vector.count;
+		copy->as.vector.capacity = value->as.vector.count;
+		copy->as.vector.values = lone_lisp_image_own(writer,
+				value->as.vector.count * sizeof(*value->as.vector.values));
+		for (i = 0; i < value->as.vector.count; ++i) {
+			copy->as.vector.values[i] = lone_lisp_image_translate(writer, value->as.vector.values[i]);
+		}
+		break;
+	case LONE_LISP_TYPE_TABLE:
+		copy->as.table.count = value->as.table.count;
+		copy->as.table.capacity = value->as.table.capacity;
+		copy->as.table.prototype = lone_lisp_image_translate(writer, value->as.table.prototype);
+		copy->as.table.entries = lone_lisp_image_own(writer, value->as.table.capacity *
+				(sizeof(struct lone_lisp_table_entry) + sizeof(struct lone_lisp_table_index)));
+		for (i = 0; i < value->as.table.count; ++i) {
+			copy->as.table.entries[i].key = lone_lisp_image_translate(writer, value->as.table.entries[i].key);
+			copy->as.table.entries[i].value = lone_lisp_image_translate(writer, value->as.table.entries[i].value);
+		}
+		break;
+	case LONE_LISP_TYPE_SYMBOL:
+	case LONE_LISP_TYPE_TEXT:
+	case LONE_LISP_TYPE_BYTES:
+		/* the mapping is zero filled, so the bytes stay terminated */
+		copy->as.bytes.count = value->as.bytes.count;
+		copy->as.bytes.pointer = lone_lisp_image_own(writer, value->as.bytes.count + 1);
+		lone_memory_move(value->as.bytes.pointer, copy->as.bytes.pointer, value->as.bytes.count);
+		break;
+	}
+}
+
+/* the preferred address is used unless it is taken, heaps must be aligned to their size wherever they are */
+static unsigned char *lone_lisp_image_place(uintptr_t preferred, size_t size, int file_descriptor, off_t offset)
+{
+	int flags = file_descriptor < 0? MAP_PRIVATE | MAP_ANONYMOUS : MAP_PRIVATE;
+	uintptr_t start;
+	intptr_t result;
+
+	result = linux_mmap((void *) preferred, size, PROT_READ | PROT_WRITE,
+			flags | MAP_FIXED_NOREPLACE, file_descriptor, offset);
+
+	if (result == (intptr_t) preferred) { return (unsigned char *) result; }
+
+	/* older kernels take the address as a mere hint */
+	if (result >= 0) { linux_munmap((void *) result, size); }
+
+	result = linux_mmap(0, size + LONE_LISP_HEAP_ALIGNMENT, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (result < 0) { /* out of address space */ linux_exit(-1); }
+
+	start = lone_lisp_image_align((uintptr_t) result, LONE_LISP_HEAP_ALIGNMENT);
+	if (start > (uintptr_t) result) { linux_munmap((void *) result, start - (uintptr_t) result); }
+	linux_munmap((void *) (start + size), (uintptr_t) result + LONE_LISP_HEAP_ALIGNMENT - start);
+
+	result = linux_mmap((void *) start, size, PROT_READ | PROT_WRITE, flags | MAP_FIXED, file_descriptor, offset);
+	if (result != (intptr_t) start) { /* could not map image */ linux_exit(-1); }
+
+	return (unsigned char *) start;
+}
+
+static void lone_lisp_image_write_all(int file_descriptor, unsigned char *bytes, size_t count)
+{
+	ssize_t written;
+
+	while (count) {
+		written = linux_write(file_descriptor, bytes, count);
+
+		if (written == -EINTR) { continue; }
+		if (written <= 0) { /* could not write image */ linux_exit(-1); }
+
+		bytes += written;
+		count -= (size_t) written;
+	}
+}
+
+void lone_lisp_image_write(struct lone_lisp *lone, int file_descriptor)
+{
+	struct lone_lisp_image_writer writer = { .lone = lone };
+	struct lone_lisp_image_header *header;
+	struct lone_lisp_heap *heap;
+	size_t heap_count, size, i;
+
+	lone_lisp_image_visit(&writer, lone->symbol_table);
+	lone_lisp_image_visit(&writer, lone->constants.truth);
+	lone_lisp_image_visit(&writer, lone->modules.loaded);
+	lone_lisp_image_visit(&writer, lone->modules.top_level_environment);
+
+	/* the values are scanned in the order they were found, breadth first */
+	for (i = 0; i < writer.count; ++i) {
+		lone_lisp_image_visit_children(&writer, writer.values[i]);
+	}
+
+	heap_count = (writer.count + LONE_LISP_HEAP_VALUE_COUNT - 1) / LONE_LISP_HEAP_VALUE_COUNT;
+	writer.data = lone_lisp_image_align(sizeof(*header), LONE_ALIGNMENT);
+	writer.heaps = lone_lisp_image_align(writer.data + writer.owned, LONE_LISP_HEAP_ALIGNMENT);
+	size = writer.heaps + (heap_count - 1) * LONE_LISP_HEAP_ALIGNMENT + sizeof(struct lone_lisp_heap);
+	size = lone_lisp_image_align(size, lone->system->memory.page_size);
+
+	/* laid out where it will be mapped, so that tables are hashed by the addresses of their keys */
+	writer.image = lone_lisp_image_place(LONE_LISP_IMAGE_ADDRESS, size, -1, 0);
+
+	for (i = 0; i < writer.count; ++i) {
+		heap = lone_lisp_image_heap(writer.image, writer.heaps, i / LONE_LISP_HEAP_VALUE_COUNT);
+		lone_lisp_image_copy(&writer, writer.values[i], lone_lisp_image_copy_of(&writer, i));
+		lone_bits_set(heap->occupied, i % LONE_LISP_HEAP_VALUE_COUNT, true);
+		heap->live += 1;
+	}
+
+	/* list keys are hashed by their elements, which must all have been copied */
+	for (i = 0; i < writer.count; ++i) {
+		if (writer.values[i]->type != LONE_LISP_TYPE_TABLE) { continue; }
+		lone_lisp_table_rehash(lone, lone_lisp_value_from_heap_value(lone_lisp_image_copy_of(&writer, i)));
+	}
+
+	header = (struct lone_lisp_image_header *) writer.image;
+	lone_memory_move(LONE_LISP_IMAGE_MAGIC, header->magic, sizeof(header->magic));
+	header->version = LONE_LISP_IMAGE_VERSION;
+	header->value_count = LONE_LISP_HEAP_VALUE_COUNT;
+	header->heap_size = sizeof(struct lone_lisp_heap);
+	header->base = (uintptr_t) writer.image;
+	header->reference = (uintptr_t) lone_lisp_image_load;
+	header->hash = lone->system->hash.fnv_1a.offset_basis;
+	header->size = size;
+	header->heaps = writer.heaps;
+	header->heap_count = heap_count;
+	header->values = writer.count;
+	header->roots.symbol_table = lone_lisp_image_translate(&writer, lone->symbol_table);
+	header->roots.truth = lone_lisp_image_translate(&writer, lone->constants.truth);
+	header->roots.loaded = lone_lisp_image_translate(&writer, lone->modules.loaded);
+	header->roots.top_level_environment = lone_lisp_image_translate(&writer, lone->modules.top_level_environment);
+
+	lone_lisp_image_write_all(file_descriptor, writer.image, size);
+
+	linux_munmap(writer.image, size);
+	lone_deallocate(lone->system, writer.values);
+	lone_deallocate(lone->system, writer.slots);
+}
+
+static bool lone_lisp_image_is_compatible(struct lone_lisp_image_header *header)
+{
+	return header->version == LONE_LISP_IMAGE_VERSION &&
+	       header->value_count == LONE_LISP_HEAP_VALUE_COUNT &&
+	       header->heap_size == sizeof(struct lone_lisp_heap) &&
+	       header->reference == (uintptr_t) lone_lisp_image_load &&
+	       header->base % LONE_LISP_HEAP_ALIGNMENT == 0 &&
+	       header->heaps % LONE_LISP_HEAP_ALIGNMENT == 0 &&
+	       header->heap_count &&
+	       header->heaps + header->heap_count * LONE_LISP_HEAP_ALIGNMENT >= header->size;
+}
+
+/* images may be followed by other data, such as the descriptor of the embedded segment */
+size_t lone_lisp_image_size(struct lone_bytes bytes)
+{
+	struct lone_lisp_image_header *header = (struct lone_lisp_image_header *) bytes.pointer;
+
+	if (bytes.count < sizeof(*header)) { return 0; }
+	if (!lone_memory_is_equal(header->magic, LONE_LISP_IMAGE_MAGIC, sizeof(header->magic))) { return 0; }
+	if (header->size > bytes.count) { /* truncated image */ linux_exit(-1); }
+
+	return header->size;
+}
+
+static void lone_lisp_image_read_header(int file_descriptor, off_t offset, struct lone_lisp_image_header *header)
+{
+	if (linux_lseek(file_descriptor, offset, SEEK_SET) != offset ||
+	    linux_read(file_descriptor, header, sizeof(*header)) != sizeof(*header) ||
+	    !lone_memory_is_equal(header->magic, LONE_LISP_IMAGE_MAGIC, sizeof(header->magic))) {
+		/* not an image */ linux_exit(-1);
+	}
+
+	if (linux_lseek(file_descriptor, 0, SEEK_END) < offset + (off_t) header->size) {
+		/* truncated image */ linux_exit(-1);
+	}
+}
+
+/* images are mapped privately: pages are read in when touched and copied when written */
+struct lone_bytes lone_lisp_image_map(struct lone_lisp *lone, char **environment, lone_elf_native_segment *segment)
+{
+	struct lone_lisp_image_header header;
+	unsigned char *image;
+	struct lone_bytes bytes;
+	int file_descriptor;
+	off_t offset;
+	char *path;
+
+	path = lone_environment_get(environment, LONE_LISP_IMAGE_VARIABLE);
+
+	if (path) {
+		file_descriptor = (int) linux_openat(AT_FDCWD, (unsigned char *) path, O_RDONLY | O_CLOEXEC, 0);
+		if (file_descriptor < 0) { /* image not found */ linux_exit(-1); }
+		offset = 0;
+	} else {
+		bytes = lone_segment_bytes(segment);
+		if (!lone_lisp_image_size(bytes)) { /* no image to map */ return LONE_BYTES_VALUE_NULL(); }
+
+		/* lone-embed places segments at page aligned offsets of the executable */
+		file_descriptor = (int) linux_openat(AT_FDCWD, (unsigned char *) "/proc/self/exe", O_RDONLY | O_CLOEXEC, 0);
+		offset = (off_t) segment->p_offset;
+
+		if (file_descriptor < 0 || offset % (off_t) lone->system->memory.page_size) {
+			/* the image is copied out of the segment instead */
+			if (file_descriptor >= 0) { linux_close(file_descriptor); }
+			lone_memory_move(bytes.pointer, &header, sizeof(header));
+			if (!lone_lisp_image_is_compatible(&header)) { return LONE_BYTES_VALUE_NULL(); }
+			image = lone_lisp_image_place(header.base, header.size, -1, 0);
+			lone_memory_move(bytes.pointer, image, header.size);
+			return LONE_BYTES_VALUE(header.size, image);
+		}
+	}
+
+	lone_lisp_image_read_header(file_descriptor, offset, &header);
+
+	if (!lone_lisp_image_is_compatible(&header)) {
+		/* written by another executable */
+		linux_close(file_descriptor);
+		return LONE_BYTES_VALUE_NULL();
+	}
+
+	image = lone_lisp_image_place(header.base, header.size, file_descriptor, offset);
+	linux_close(file_descriptor);
+
+	return LONE_BYTES_VALUE(header.size, image);
+}
+
+static void lone_lisp_image_relocate_value(struct lone_lisp_value *value, uintptr_t delta)
+{
+	if (lone_lisp_is_heap_value(*value)) { value->as.bits += delta; }
+}
+
+static void lone_lisp_image_relocate_children(struct lone_lisp_heap_value *value, uintptr_t delta)
+{
+	size_t i;
+
+	switch (value->type) {
+	case LONE_LISP_TYPE_MODULE:
+		lone_lisp_image_relocate_value(&value->as.module.name, delta);
+		lone_lisp_image_relocate_value(&value->as.module.environment, delta);
+		lone_lisp_image_relocate_value(&value->as.module.exports, delta);
+		break;
+	case LONE_LISP_TYPE_FUNCTION:
+		lone_lisp_image_relocate_value(&value->as.function.arguments, delta);
+		lone_lisp_image_relocate_value(&value->as.function.code, delta);
+		lone_lisp_image_relocate_value(&value->as.function.environment, delta);
+		break;
+	case LONE_LISP_TYPE_PRIMITIVE:
+		lone_lisp_image_relocate_value(&value->as.primitive.name, delta);
+		lone_lisp_image_relocate_value(&value->as.primitive.closure, delta);
+		break;
+	case LONE_LISP_TYPE_LIST:
+		lone_lisp_image_relocate_value(&value->as.list.first, delta);
+		lone_lisp_image_relocate_value(&value->as.list.rest, delta);
+		break;
+	case LONE_LISP_TYPE_VECTOR:
+		value->as.vector.values = (struct lone_lisp_value *) ((uintptr_t) value->as.vector.values + delta);
+		for (i = 0; i < value->as.vector.count; ++i) {
+			lone_lisp_image_relocate_value(&value->as.vector.values[i], delta);
+		}
+		break;
+	case LONE_LISP_TYPE_TABLE:
+		value->as.table.entries = (struct lone_lisp_table_entry *) ((uintptr_t) value->as.table.entries + delta);
+		lone_lisp_image_relocate_value(&value->as.table.prototype, delta);
+		for (i = 0; i < value->as.table.count; ++i) {
+			lone_lisp_image_relocate_value(&value->as.table.entries[i].key, delta);
+			lone_lisp_image_relocate_value(&value->as.table.entries[i].value, delta);
+		}
+		break;
+	case LONE_LISP_TYPE_SYMBOL:
+	case LONE_LISP_TYPE_TEXT:
+	case LONE_LISP_TYPE_BYTES:
+		value->as.bytes.pointer = (unsigned char *) ((uintptr_t) value->as.bytes.pointer + delta);
+		break;
+	}
+}
+
+static void lone_lisp_image_relocate(struct lone_lisp *lone, unsigned char *image)
+{
+	struct lone_lisp_image_header *header = (struct lone_lisp_image_header *) image;
+	uintptr_t delta = (uintptr_t) image - header->base;
+	struct lone_lisp_heap *heap;
+	size_t i, j;
+
+	for (i = 0; i < header->heap_count; ++i) {
+		heap = lone_lisp_image_heap(image, header->heaps, i);
+		for (j = 0; j < heap->live; ++j) {
+			lone_lisp_image_relocate_children(&heap->values[j], delta);
+		}
+	}
+
+	lone_lisp_image_relocate_value(&header->roots.symbol_table, delta);
+	lone_lisp_image_relocate_value(&header->roots.truth, delta);
+	lone_lisp_image_relocate_value(&header->roots.loaded, delta);
+	lone_lisp_image_relocate_value(&header->roots.top_level_environment, delta);
+
+	header->base = (uintptr_t) image;
+}
+
+/* symbols are hashed by address and every process has its own hash function state */
+static void lone_lisp_image_rehash(struct lone_lisp *lone, unsigned char *image)
+{
+	struct lone_lisp_image_header *header = (struct lone_lisp_image_header *) image;
+	struct lone_lisp_heap *heap;
+	size_t i, j;
+
+	for (i = 0; i < header->heap_count; ++i) {
+		heap = lone_lisp_image_heap(image, header->heaps, i);
+		for (j = 0; j < heap->live; ++j) {
+			if (heap->values[j].type != LONE_LISP_TYPE_TABLE) { continue; }
+			lone_lisp_table_rehash(lone, lone_lisp_value_from_heap_value(&heap->values[j]));
+		}
+	}
+
+	header->hash = lone->system->hash.fnv_1a.offset_basis;
+}
+
+/* replaces the values the interpreter was initialized with, only the module path is kept */
+bool lone_lisp_image_load(struct lone_lisp *lone, struct lone_bytes image)
+{
+	struct lone_lisp_image_header *header;
+	size_t i;
+
+	if (!image.pointer) { /* no image was mapped */ return false; }
+
+	header = (struct lone_lisp_image_header *) image.pointer;
+
+	if (header->base != (uintptr_t) image.pointer) {
+		lone_lisp_image_relocate(lone, image.pointer);
+		lone_lisp_image_rehash(lone, image.pointer);
+	} else if (header->hash != lone->system->hash.fnv_1a.offset_basis) {
+		/* processes started from the same image must not share a hash function state */
+		lone_lisp_image_rehash(lone, image.pointer);
+	}
+
+	lone->image = image;
+
+	for (i = 0; i < header->heap_count; ++i) {
+		lone_lisp_heap_adopt(lone, lone_lisp_image_heap(image.pointer, header->heaps, i));
+	}
+
+	/* collecting the image right away would be a waste of time */
+	lone->garbage_collector.old += header->values;
+	lone->garbage_collector.threshold.values += header->values;
+
+	lone->symbol_table = header->roots.symbol_table;
+	lone->constants.truth = header->roots.truth;
+	lone->modules.loaded = header->roots.loaded;
+	lone->modules.top_level_environment = header->roots.top_level_environment;
+	lone->modules.null = lone_lisp_module_create(lone, lone_lisp_nil());
+
+	return true;
+}
+
+bool lone_lisp_image_contains(struct lone_lisp *lone, void *pointer)
+{
+	unsigned char *address = pointer;
+
+	return address >= lone->image.pointer && address < lone->image.pointer + lone->image.count;
+}
@@ -16,7 +16,7 @@
 #include <lone/lisp/garbage_collector.h>
 #include <lone/lisp/utilities.h>
 
-#include <lone/memory/allocator.h>
+#include <lone/memory/scratch.h>
 
 #include <lone/linux.h>
 
@@ -31,7 +31,7 @@ static struct lone_lisp_value lone_lisp_module_name_to_key(struct lone_lisp *lon
 	struct lone_lisp_heap_value *actual;
 	struct lone_lisp_value head;
 
-	switch (name.type) {
+	switch (lone_lisp_type_of(name)) {
 	case LONE_LISP_TYPE_NIL:
 	case LONE_LISP_TYPE_INTEGER:
 	case LONE_LISP_TYPE_POINTER:
@@ -68,6 +68,7 @@ static bool lone_lisp_module_try_to_load_embedded(struct lone_lisp *lone,
 		struct lone_lisp_value module, struct lone_lisp_value name)
 {
 	struct lone_lisp_value embedded_module;
+	size_t roots;
 
 	if (lone_lisp_is_nil(lone->modules.embedded)) { /* no embedded modules */ return false; }
 
@@ -75,8 +76,12 @@ static bool lone_lisp_module_try_to_load_embedded(struct lone_lisp *lone,
 	if (lone_lisp_is_nil(embedded_module)) { /* embedded module not found */ return false; }
 	if (!lone_lisp_has_bytes(embedded_module)) { /* invalid embedded module */ linux_exit(-1); }
 
+	roots = lone_lisp_roots_save(lone);
+	lone_lisp_root(lone, &name);
 	lone_lisp_module_load_from_bytes(lone, module, embedded_module.as.heap_value->as.bytes);
 	lone_lisp_table_delete(lone, lone->modules.embedded, name);
+	lone_lisp_roots_restore(lone, roots);
+
 	return true;
 }
 
@@ -84,8 +89,12 @@ static struct lone_lisp_value lone_lisp_module_get_or_create(struct lone_lisp *l
 		struct lone_lisp_value name, bool *not_found)
 {
 	struct lone_lisp_value module;
+	size_t roots;
 	bool loaded;
 
+	roots = lone_lisp_roots_save(lone);
+	lone_lisp_root(lone, &name);
+
 	name = lone_lisp_module_name_to_key(lone, name);
 	module = lone_lisp_table_get(lone, lone->modules.loaded, name);
 	if (not_found) {
@@ -103,6 +112,8 @@ static struct lone_lisp_value lone_lisp_module_get_or_create(struct lone_lisp *l
 		}
 	}
 
+	/* modules are rooted by the table of loaded modules */
+	lone_lisp_roots_restore(lone, roots);
 	return module;
 }
 
@@ -115,9 +126,13 @@ static int lone_lisp_module_search(struct lone_lisp *lone, struct lone_lisp_valu
 {
 	struct lone_lisp_value arguments, package, search_path;
 	struct lone_lisp_value slash, ln;
+	struct lone_memory_scratch scratch;
 	unsigned char *path;
 	long result;
-	size_t i;
+	size_t roots, i;
+
+	roots = lone_lisp_roots_save(lone);
+	lone_lisp_root(lone, &symbols);
 
 	symbols = lone_lisp_module_name_to_key(lone, symbols);
 	package = lone_lisp_list_first(symbols);
@@ -125,16 +140,18 @@ static int lone_lisp_module_search(struct lone_lisp *lone, struct lone_lisp_valu
 	slash = lone_lisp_intern_c_string(lone, "/");
 	ln = lone_lisp_intern_c_string(lone, ".ln");
 
+	lone_memory_scratch_initialize(&scratch, lone->system, 0);
+
 	LONE_LISP_VECTOR_FOR_EACH(search_path, lone->modules.path, i) {
 		arguments = lone_lisp_list_build(lone, 3, &search_path, &package, &symbols);
 		arguments = lone_lisp_list_flatten(lone, arguments);
-		arguments = lone_lisp_text_transfer_bytes(lone, lone_lisp_join(lone, slash, arguments, lone_lisp_has_bytes), true);
+		arguments = lone_lisp_text_transfer_bytes(lone, lone_lisp_join_scratch(lone, &scratch, slash, arguments, lone_lisp_has_bytes), false);
 		arguments = lone_lisp_list_build(lone, 2, &arguments, &ln);
-		path = lone_lisp_concatenate(lone, arguments, lone_lisp_has_bytes).pointer;
+		path = lone_lisp_concatenate_scratch(lone, &scratch, arguments, lone_lisp_has_bytes).pointer;
 
-		result = linux_openat(AT_FDCWD, path, O_RDONLY | O_CLOEXEC);
+		result = linux_openat(AT_FDCWD, path, O_RDONLY | O_CLOEXEC, 0);
 
-		lone_deallocate(lone->system, path);
+		lone_memory_scratch_reset(&scratch);
 
 		switch (result) {
 		case -ENOENT:
@@ -148,6 +165,8 @@ static int lone_lisp_module_search(struct lone_lisp *lone, struct lone_lisp_valu
 			linux_exit(-1);
 		}
 
+		lone_memory_scratch_finalize(&scratch);
+		lone_lisp_roots_restore(lone, roots);
 		return (int) result;
 	}
 
@@ -158,6 +177,11 @@ static void lone_lisp_module_load_from_reader(struct lone_lisp *lone,
 		struct lone_lisp_value module, struct lone_lisp_reader *reader)
 {
 	struct lone_lisp_value value;
+	size_t roots;
+
+	roots = lone_lisp_roots_save(lone);
+	lone_lisp_root(lone, &module);
+	++lone->modules.loading;
 
 	while (1) {
 		value = lone_lisp_read(lone, reader);
@@ -165,8 +189,13 @@ static void lone_lisp_module_load_from_reader(struct lone_lisp *lone,
 		if (reader->status.end_of_input) { break; }
 
 		value = lone_lisp_evaluate_in_module(lone, module, value);
+
+		/* imported modules are loaded while their importers are being evaluated */
+		if (lone->modules.loading == 1) { lone_lisp_garbage_collector_safe_point(lone); }
 	}
 
+	--lone->modules.loading;
+	lone_lisp_roots_restore(lone, roots);
 	lone_lisp_reader_finalize(lone, reader);
 	lone_lisp_garbage_collector(lone);
 }
@@ -194,6 +223,10 @@ struct lone_lisp_value lone_lisp_module_load(struct lone_lisp *lone, struct lone
 	struct lone_lisp_value module;
 	bool not_found;
 	int file_descriptor;
+	size_t roots;
+
+	roots = lone_lisp_roots_save(lone);
+	lone_lisp_root(lone, &name);
 
 	module = lone_lisp_module_get_or_create(lone, name, &not_found);
 
@@ -203,6 +236,7 @@ struct lone_lisp_value lone_lisp_module_load(struct lone_lisp *lone, struct lone
 		linux_close(file_descriptor);
 	}
 
+	lone_lisp_roots_restore(lone, roots);
 	return module;
 }
 
@@ -233,7 +267,13 @@ void lone_lisp_module_set_and_export(struct lone_lisp *lone, struct lone_lisp_va
 void lone_lisp_module_set_and_export_c_string(struct lone_lisp *lone,
 		struct lone_lisp_value module, char *symbol, struct lone_lisp_value value)
 {
+	size_t roots;
+
+	roots = lone_lisp_roots_save(lone);
+	lone_lisp_root(lone, &module);
+	lone_lisp_root(lone, &value);
 	lone_lisp_module_set_and_export(lone, module, lone_lisp_intern_c_string(lone, symbol), value);
+	lone_lisp_roots_restore(lone, roots);
 }
 
 void lone_lisp_module_export_primitive(struct lone_lisp *lone,
@@ -271,25 +311,43 @@ struct lone_lisp_import_specification {
 static struct lone_lisp_value lone_prefix_module_name(struct lone_lisp *lone,
 		struct lone_lisp_value module, struct lone_lisp_value symbol)
 {
-	struct lone_lisp_value arguments, separator;
-	struct lone_lisp_heap_value *actual;
+	struct lone_lisp_value arguments, name, separator, prefixed;
+	struct lone_memory_scratch scratch;
+	size_t roots;
 
-	actual = module.as.heap_value;
-	arguments = lone_lisp_list_flatten(lone, lone_lisp_list_build(lone, 2, &actual->as.module.name, &symbol));
+	roots = lone_lisp_roots_save(lone);
+	arguments = lone_lisp_nil();
+	lone_lisp_root(lone, &arguments);
+
+	name = module.as.heap_value->as.module.name;
+	arguments = lone_lisp_list_flatten(lone, lone_lisp_list_build(lone, 2, &name, &symbol));
 	separator = lone_lisp_intern_c_string(lone, ".");
 
-	return lone_lisp_intern_bytes(lone, lone_lisp_join(lone, separator, arguments, lone_lisp_has_bytes), true);
+	/* interning copies the joined bytes */
+	lone_memory_scratch_initialize(&scratch, lone->system, 0);
+	prefixed = lone_lisp_intern_bytes(lone, lone_lisp_join_scratch(lone, &scratch, separator, arguments, lone_lisp_has_bytes), true);
+	lone_memory_scratch_finalize(&scratch);
+
+	lone_lisp_roots_restore(lone, roots);
+	return prefixed;
 }
 
 static void lone_lisp_import_specification(struct lone_lisp *lone, struct lone_lisp_import_specification *spec)
 {
 	struct lone_lisp_value module, environment, exports, symbols, symbol, value;
-	size_t i;
+	size_t roots, i;
 
 	module = spec->module;
 	symbols = spec->symbols;
 	environment = spec->environment;
 	exports = module.as.heap_value->as.module.exports;
+	value = lone_lisp_nil();
+
+	roots = lone_lisp_roots_save(lone);
+	lone_lisp_root(lone, &module);
+	lone_lisp_root(lone, &symbols);
+	lone_lisp_root(lone, &environment);
+	lone_lisp_root(lone, &value);
 
 	/* bind either the exported or the specified symbols: (import (module)), (import (module x f)) */
 	LONE_LISP_VECTOR_FOR_EACH(symbol, symbols, i) {
@@ -307,6 +365,8 @@ static void lone_lisp_import_specification(struct lone_lisp *lone, struct lone_l
 
 		lone_lisp_table_set(lone, environment, symbol, value);
 	}
+
+	lone_lisp_roots_restore(lone, roots);
 }
 
 static void lone_lisp_primitive_import_form(struct lone_lisp *lone,
@@ -315,7 +375,7 @@ static void lone_lisp_primitive_import_form(struct lone_lisp *lone,
 	struct lone_lisp_heap_value *actual;
 	struct lone_lisp_value name;
 
-	switch (argument.type) {
+	switch (lone_lisp_type_of(argument)) {
 	case LONE_LISP_TYPE_NIL:
 		/* nothing to import: (import ()) */ linux_exit(-1);
 	case LONE_LISP_TYPE_INTEGER:
@@ -4,11 +4,13 @@
 
 #include <lone/lisp/module.h>
 #include <lone/lisp/segment.h>
+#include <lone/lisp/garbage_collector.h>
 
 #include <lone/lisp/reader.h>
 #include <lone/lisp/value/list.h>
 #include <lone/lisp/value/table.h>
 #include <lone/lisp/value/symbol.h>
+#include <lone/lisp/value/integer.h>
 
 #include <lone/linux.h>
 
@@ -23,8 +25,8 @@ static struct lone_bytes slice(struct lone_bytes bytes, struct lone_lisp_value p
 	second = lone_lisp_list_rest(pair);
 	if (!lone_lisp_is_integer(second)) { /* unexpected value type */ linux_exit(-1); }
 
-	start = first.as.integer;
-	size = second.as.integer;
+	start = lone_lisp_integer_of(first);
+	size = lone_lisp_integer_of(second);
 	end = start + size;
 
 	if (start >= bytes.count || end >= bytes.count) {
@@ -42,11 +44,15 @@ void lone_lisp_modules_embedded_load(struct lone_lisp *lone, lone_elf_native_seg
 	struct lone_lisp_value descriptor;
 	struct lone_lisp_value symbol, data, module, locations;
 	struct lone_bytes bytes, code;
+	size_t roots;
 
 	descriptor = lone_lisp_segment_read_descriptor(lone, segment);
 
 	if (lone_lisp_is_nil(descriptor)) { /* nothing to load */ return; }
 
+	roots = lone_lisp_roots_save(lone);
+	lone_lisp_root(lone, &descriptor);
+
 	symbol = lone_lisp_intern_c_string(lone, "data");
 	data = lone_lisp_table_get(lone, descriptor, symbol);
 	bytes = data.as.heap_value->as.bytes;
@@ -57,6 +63,9 @@ void lone_lisp_modules_embedded_load(struct lone_lisp *lone, lone_elf_native_seg
 	symbol = lone_lisp_intern_c_string(lone, "run");
 	locations = lone_lisp_table_get(lone, descriptor, symbol);
 
+	/* everything else the descriptor refers to is either rooted or not a heap value */
+	lone_lisp_roots_restore(lone, roots);
+
 	if (lone_lisp_is_nil(locations)) { /* no code to evaluate */ return; }
 
 	code = slice(bytes, locations);
@@ -10,6 +10,7 @@
 #include <lone/lisp/modules/intrinsic/list.h>
 #include <lone/lisp/modules/intrinsic/vector.h>
 #include <lone/lisp/modules/intrinsic/table.h>
+#include <lone/lisp/modules/intrinsic/memory.h>
 
 void lone_lisp_modules_intrinsic_initialize(struct lone_lisp *lone,
 		int argc, char **argv, char **envp,
@@ -23,4 +24,5 @@ void lone_lisp_modules_intrinsic_initialize(struct lone_lisp *lone,
 	lone_lisp_modules_intrinsic_list_initialize(lone);
 	lone_lisp_modules_intrinsic_vector_initialize(lone);
 	lone_lisp_modules_intrinsic_table_initialize(lone);
+	lone_lisp_modules_intrinsic_memory_initialize(lone);
 }
@@ -3,6 +3,7 @@
 #include <lone/lisp/modules/intrinsic/linux.h>
 
 #include <lone/lisp/module.h>
+#include <lone/lisp/garbage_collector.h>
 
 #include <lone/lisp/value/primitive.h>
 #include <lone/lisp/value/list.h>
@@ -21,6 +22,11 @@ static void lone_lisp_auxiliary_value_to_table(struct lone_lisp *lone,
 		struct lone_auxiliary_vector *auxiliary)
 {
 	struct lone_lisp_value key, value;
+	size_t roots;
+
+	roots = lone_lisp_roots_save(lone);
+	lone_lisp_root(lone, &table);
+	lone_lisp_root(lone, &unknowns);
 
 	switch (auxiliary->type) {
 
@@ -203,17 +209,26 @@ static void lone_lisp_auxiliary_value_to_table(struct lone_lisp *lone,
 		key = lone_lisp_integer_create((lone_lisp_integer) auxiliary->type);
 		value = lone_lisp_integer_create(auxiliary->value.as.signed_integer);
 		lone_lisp_table_set(lone, unknowns, key, value);
+		lone_lisp_roots_restore(lone, roots);
 		return;
 	}
 
 	lone_lisp_table_set(lone, table, key, value);
+	lone_lisp_roots_restore(lone, roots);
 }
 
 static struct lone_lisp_value lone_lisp_auxiliary_vector_to_table(struct lone_lisp *lone, struct lone_auxiliary_vector *auxiliary_vector)
 {
-	struct lone_lisp_value table = lone_lisp_table_create(lone, 32, lone_lisp_nil());
-	struct lone_lisp_value unknowns = lone_lisp_table_create(lone, 2, lone_lisp_nil());
-	size_t i;
+	struct lone_lisp_value table, unknowns;
+	size_t roots, i;
+
+	roots = lone_lisp_roots_save(lone);
+	table = unknowns = lone_lisp_nil();
+	lone_lisp_root(lone, &table);
+	lone_lisp_root(lone, &unknowns);
+
+	table = lone_lisp_table_create(lone, 32, lone_lisp_nil());
+	unknowns = lone_lisp_table_create(lone, 2, lone_lisp_nil());
 
 	for (i = 0; auxiliary_vector[i].type != AT_NULL; ++i) {
 		lone_lisp_auxiliary_value_to_table(lone, table, unknowns, &auxiliary_vector[i]);
@@ -223,13 +238,21 @@ static struct lone_lisp_value lone_lisp_auxiliary_vector_to_table(struct lone_li
 		lone_lisp_table_set(lone, table, lone_lisp_intern_c_string(lone, "unknown"), unknowns);
 	}
 
+	lone_lisp_roots_restore(lone, roots);
 	return table;
 }
 
 static struct lone_lisp_value lone_lisp_environment_to_table(struct lone_lisp *lone, char **c_strings)
 {
-	struct lone_lisp_value table = lone_lisp_table_create(lone, 64, lone_lisp_nil()), key, value;
+	struct lone_lisp_value table, key, value;
 	char *c_string_key, *c_string_value, *c_string;
+	size_t roots;
+
+	roots = lone_lisp_roots_save(lone);
+	table = lone_lisp_table_create(lone, 64, lone_lisp_nil());
+	key = lone_lisp_nil();
+	lone_lisp_root(lone, &table);
+	lone_lisp_root(lone, &key);
 
 	for (/* c_strings */; *c_strings; ++c_strings) {
 		c_string = *c_strings;
@@ -249,15 +272,19 @@ static struct lone_lisp_value lone_lisp_environment_to_table(struct lone_lisp *l
 		lone_lisp_table_set(lone, table, key, value);
 	}
 
+	lone_lisp_roots_restore(lone, roots);
 	return table;
 }
 
 static struct lone_lisp_value lone_lisp_arguments_to_vector(struct lone_lisp *lone, int count, char **c_strings)
 {
 	struct lone_lisp_value arguments;
+	size_t roots;
 	int i;
 
+	roots = lone_lisp_roots_save(lone);
 	arguments = lone_lisp_vector_create(lone, (size_t) count);
+	lone_lisp_root(lone, &arguments);
 
 	for (i = 0; i < count; ++i) {
 		lone_lisp_vector_set(lone,
@@ -266,12 +293,13 @@ static struct lone_lisp_value lone_lisp_arguments_to_vector(struct lone_lisp *lo
 		                lone_lisp_text_from_c_string(lone, c_strings[i]));
 	}
 
+	lone_lisp_roots_restore(lone, roots);
 	return arguments;
 }
 
 static void lone_lisp_fill_linux_system_call_table(struct lone_lisp *lone, struct lone_lisp_value linux_system_call_table)
 {
-	size_t i;
+	size_t roots, i;
 
 	static struct linux_system_call {
 		char *symbol;
@@ -283,41 +311,91 @@ static void lone_lisp_fill_linux_system_call_table(struct lone_lisp *lone, struc
 
 	};
 
+	roots = lone_lisp_roots_save(lone);
+	lone_lisp_root(lone, &linux_system_call_table);
+
 	for (i = 0; i < (sizeof(linux_system_calls)/sizeof(linux_system_calls[0])); ++i) {
 		lone_lisp_table_set(lone, linux_system_call_table,
 				lone_lisp_intern_c_string(lone, linux_system_calls[i].symbol),
 				lone_lisp_integer_create(linux_system_calls[i].number));
 	}
+
+	lone_lisp_roots_restore(lone, roots);
+}
+
+static void lone_lisp_linux_set(struct lone_lisp *lone,
+		struct lone_lisp_value module, char *symbol, struct lone_lisp_value value)
+{
+	size_t roots;
+
+	roots = lone_lisp_roots_save(lone);
+	lone_lisp_root(lone, &module);
+	lone_lisp_root(lone, &value);
+	lone_lisp_table_set(lone, module.as.heap_value->as.module.environment,
+			lone_lisp_intern_c_string(lone, symbol), value);
+	lone_lisp_roots_restore(lone, roots);
+}
+
+/* images hold the parameters of the process that wrote them, they are set again once loaded */
+void lone_lisp_modules_intrinsic_linux_bind(struct lone_lisp *lone,
+		int argc, char **argv, char **envp,
+		struct lone_auxiliary_vector *auxv)
+{
+	struct lone_lisp_value module, arguments, environment, auxiliary_vector;
+	size_t roots;
+
+	roots = lone_lisp_roots_save(lone);
+	arguments = environment = auxiliary_vector = lone_lisp_nil();
+	lone_lisp_root(lone, &arguments);
+	lone_lisp_root(lone, &environment);
+	lone_lisp_root(lone, &auxiliary_vector);
+
+	module = lone_lisp_module_for_name(lone, lone_lisp_intern_c_string(lone, "linux"));
+	lone_lisp_root(lone, &module);
+
+	arguments = lone_lisp_arguments_to_vector(lone, argc, argv);
+	environment = lone_lisp_environment_to_table(lone, envp);
+	auxiliary_vector = lone_lisp_auxiliary_vector_to_table(lone, auxv);
+
+	lone_lisp_linux_set(lone, module, "argument-count", lone_lisp_integer_create(argc));
+	lone_lisp_linux_set(lone, module, "arguments", arguments);
+	lone_lisp_linux_set(lone, module, "environment", environment);
+	lone_lisp_linux_set(lone, module, "auxiliary-vector", auxiliary_vector);
+
+	lone_lisp_roots_restore(lone, roots);
 }
 
 void lone_lisp_modules_intrinsic_linux_initialize(struct lone_lisp *lone,
 		int argc, char **argv, char **envp,
 		struct lone_auxiliary_vector *auxv)
 {
-	struct lone_lisp_value name, module, linux_system_call_table, count, arguments, environment, auxiliary_vector;
+	struct lone_lisp_value name, module, linux_system_call_table;
 	struct lone_lisp_function_flags flags;
+	size_t roots;
+
+	roots = lone_lisp_roots_save(lone);
 
 	name = lone_lisp_intern_c_string(lone, "linux");
 	module = lone_lisp_module_for_name(lone, name);
 	linux_system_call_table = lone_lisp_table_create(lone, 1024, lone_lisp_nil());
+	lone_lisp_root(lone, &linux_system_call_table);
 
 	lone_lisp_fill_linux_system_call_table(lone, linux_system_call_table);
 
-	count = lone_lisp_integer_create(argc);
-	arguments = lone_lisp_arguments_to_vector(lone, argc, argv);
-	environment = lone_lisp_environment_to_table(lone, envp);
-	auxiliary_vector = lone_lisp_auxiliary_vector_to_table(lone, auxv);
+	lone_lisp_modules_intrinsic_linux_bind(lone, argc, argv, envp, auxv);
 
-	lone_lisp_module_set_and_export_c_string(lone, module, "argument-count", count);
-	lone_lisp_module_set_and_export_c_string(lone, module, "arguments", arguments);
-	lone_lisp_module_set_and_export_c_string(lone, module, "environment", environment);
-	lone_lisp_module_set_and_export_c_string(lone, module, "auxiliary-vector", auxiliary_vector);
+	lone_lisp_module_export(lone, module, lone_lisp_intern_c_string(lone, "argument-count"));
+	lone_lisp_module_export(lone, module, lone_lisp_intern_c_string(lone, "arguments"));
+	lone_lisp_module_export(lone, module, lone_lisp_intern_c_string(lone, "environment"));
+	lone_lisp_module_export(lone, module, lone_lisp_intern_c_string(lone, "auxiliary-vector"));
 
 	lone_lisp_module_set_and_export_c_string(lone, module, "system-call-table", linux_system_call_table);
 
 	flags = (struct lone_lisp_function_flags) { .evaluate_arguments = true, .evaluate_result = false };
 	lone_lisp_module_export_primitive(lone, module, "system-call",
 			"linux_system_call", lone_lisp_primitive_linux_system_call, linux_system_call_table, flags);
+
+	lone_lisp_roots_restore(lone, roots);
 }
 
 static inline long lone_lisp_value_to_linux_system_call_number(struct lone_lisp *lone,
@@ -325,9 +403,9 @@ static inline long lone_lisp_value_to_linux_system_call_number(struct lone_lisp
 {
 	struct lone_lisp_value number;
 
-	switch (value.type) {
+	switch (lone_lisp_type_of(value)) {
 	case LONE_LISP_TYPE_INTEGER:
-		return value.as.integer;
+		return lone_lisp_integer_of(value);
 	case LONE_LISP_TYPE_NIL:
 	case LONE_LISP_TYPE_POINTER:
 		linux_exit(-1);
@@ -352,9 +430,9 @@ static inline long lone_lisp_value_to_linux_system_call_number(struct lone_lisp
 		linux_exit(-1);
 	}
 
-	switch (number.type) {
+	switch (lone_lisp_type_of(number)) {
 	case LONE_LISP_TYPE_INTEGER:
-		return number.as.integer;
+		return lone_lisp_integer_of(number);
 	case LONE_LISP_TYPE_NIL:
 	case LONE_LISP_TYPE_HEAP_VALUE:
 	case LONE_LISP_TYPE_POINTER:
@@ -368,13 +446,13 @@ static inline long lone_lisp_value_to_linux_system_call_argument(struct lone_lis
 {
 	struct lone_lisp_heap_value *actual;
 
-	switch (value.type) {
+	switch (lone_lisp_type_of(value)) {
 	case LONE_LISP_TYPE_NIL:
 		return 0;
 	case LONE_LISP_TYPE_POINTER:
-		return (long) value.as.pointer.to_void;
+		return (long) lone_lisp_pointer_of(value).to_void;
 	case LONE_LISP_TYPE_INTEGER:
-		return (long) value.as.integer;
+		return (long) lone_lisp_integer_of(value);
 	case LONE_LISP_TYPE_HEAP_VALUE:
 		break;
 	}
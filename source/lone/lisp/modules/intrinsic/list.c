@@ -4,6 +4,7 @@
 
 #include <lone/lisp/module.h>
 #include <lone/lisp/evaluator.h>
+#include <lone/lisp/garbage_collector.h>
 
 #include <lone/lisp/value/primitive.h>
 #include <lone/lisp/value/list.h>
@@ -78,6 +79,7 @@ LONE_LISP_PRIMITIVE(list_rest)
 LONE_LISP_PRIMITIVE(list_map)
 {
 	struct lone_lisp_value function, list, results, head;
+	size_t roots;
 
 	if (lone_lisp_list_destructure(arguments, 2, &function, &list)) {
 		/* wrong number of arguments */ linux_exit(-1);
@@ -87,12 +89,17 @@ LONE_LISP_PRIMITIVE(list_map)
 	if (lone_lisp_is_nil(list)) { /* mapping function to empty list */ return lone_lisp_nil(); }
 	if (!lone_lisp_is_list(list)) { /* can only map functions to lists */ linux_exit(-1); }
 
-	for (results = head = lone_lisp_nil(); !lone_lisp_is_nil(list); list = lone_lisp_list_rest(list)) {
+	roots = lone_lisp_roots_save(lone);
+	results = head = lone_lisp_nil();
+	lone_lisp_root(lone, &results);
+
+	for (/* list */; !lone_lisp_is_nil(list); list = lone_lisp_list_rest(list)) {
 		arguments = lone_lisp_list_create(lone, lone_lisp_list_first(list), lone_lisp_nil());
 		lone_lisp_list_append(lone, &results, &head,
 				lone_lisp_apply(lone, module, environment, function, arguments));
 	}
 
+	lone_lisp_roots_restore(lone, roots);
 	return results;
 }
 
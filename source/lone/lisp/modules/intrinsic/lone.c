@@ -7,6 +7,7 @@
 #include <lone/lisp/printer.h>
 #include <lone/lisp/constants.h>
 #include <lone/lisp/utilities.h>
+#include <lone/lisp/garbage_collector.h>
 
 #include <lone/lisp/value/function.h>
 #include <lone/lisp/value/primitive.h>
@@ -162,12 +163,15 @@ LONE_LISP_PRIMITIVE(lone_if)
 LONE_LISP_PRIMITIVE(lone_let)
 {
 	struct lone_lisp_value bindings, first, second, rest, value, new_environment;
+	size_t roots;
 
 	if (lone_lisp_is_nil(arguments)) { /* no variables to bind: (let) */ linux_exit(-1); }
 	bindings = lone_lisp_list_first(arguments);
 	if (!lone_lisp_is_list(bindings)) { /* expected list but got something else: (let 10) */ linux_exit(-1); }
 
+	roots = lone_lisp_roots_save(lone);
 	new_environment = lone_lisp_table_create(lone, 8, environment);
+	lone_lisp_root(lone, &new_environment);
 
 	while (1) {
 		if (lone_lisp_is_nil(bindings)) { break; }
@@ -187,6 +191,7 @@ LONE_LISP_PRIMITIVE(lone_let)
 		value = lone_lisp_evaluate(lone, module, new_environment, lone_lisp_list_first(arguments));
 	}
 
+	lone_lisp_roots_restore(lone, roots);
 	return value;
 }
 
@@ -238,6 +243,7 @@ LONE_LISP_PRIMITIVE(lone_quasiquote)
 {
 	struct lone_lisp_value form, list, head, current, element, result, first, rest, unquote, splice;
 	bool escaping, splicing;
+	size_t roots;
 
 	if (lone_lisp_list_destructure(arguments, 1, &form)) {
 		/* wrong number of arguments: (quasiquote), (quasiquote x y) */ linux_exit(-1);
@@ -245,7 +251,11 @@ LONE_LISP_PRIMITIVE(lone_quasiquote)
 
 	unquote = lone_lisp_intern_c_string(lone, "unquote");
 	splice = lone_lisp_intern_c_string(lone, "unquote*");
-	list = head = lone_lisp_nil();
+	list = head = result = lone_lisp_nil();
+
+	roots = lone_lisp_roots_save(lone);
+	lone_lisp_root(lone, &list);
+	lone_lisp_root(lone, &result);
 
 	for (current = form; !lone_lisp_is_nil(current); current = lone_lisp_list_rest(current)) {
 		element = lone_lisp_list_first(current);
@@ -295,6 +305,7 @@ LONE_LISP_PRIMITIVE(lone_quasiquote)
 		}
 	}
 
+	lone_lisp_roots_restore(lone, roots);
 	return list;
 }
 
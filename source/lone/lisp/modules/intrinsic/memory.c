@@ -0,0 +1,371 @@
+/* SPDX-License-Identifier: AGPL-3.0-or-later */
+
+#include <lone/lisp/modules/intrinsic/memory.h>
+
+#include <lone/lisp/module.h>
+#include <lone/lisp/heap.h>
+#include <lone/lisp/garbage_collector.h>
+#include <lone/lisp/image.h>
+#include <lone/lisp/profiler.h>
+
+#include <lone/lisp/value/primitive.h>
+#include <lone/lisp/value/table.h>
+#include <lone/lisp/value/vector.h>
+#include <lone/lisp/value/symbol.h>
+#include <lone/lisp/value/integer.h>
+#include <lone/lisp/value/list.h>
+
+#include <lone/memory/allocator.h>
+#include <lone/memory/array.h>
+#include <lone/memory/functions.h>
+
+#include <lone/linux.h>
+
+void lone_lisp_modules_intrinsic_memory_initialize(struct lone_lisp *lone)
+{
+	struct lone_lisp_value name, module;
+	struct lone_lisp_function_flags flags;
+
+	name = lone_lisp_intern_c_string(lone, "memory");
+	module = lone_lisp_module_for_name(lone, name);
+	flags.evaluate_arguments = true;
+	flags.evaluate_result = false;
+
+	lone_lisp_module_export_primitive(lone, module, "statistics",
+			"statistics", lone_lisp_primitive_memory_statistics, module, flags);
+
+	lone_lisp_module_export_primitive(lone, module, "huge-pages",
+			"huge_pages", lone_lisp_primitive_memory_huge_pages, module, flags);
+
+	lone_lisp_module_export_primitive(lone, module, "collect",
+			"collect", lone_lisp_primitive_memory_collect, module, flags);
+
+	lone_lisp_module_export_primitive(lone, module, "incremental",
+			"incremental", lone_lisp_primitive_memory_incremental, module, flags);
+
+	lone_lisp_module_export_primitive(lone, module, "parallel",
+			"parallel", lone_lisp_primitive_memory_parallel, module, flags);
+
+	lone_lisp_module_export_primitive(lone, module, "background-sweeping",
+			"background_sweeping", lone_lisp_primitive_memory_background_sweeping, module, flags);
+
+	lone_lisp_module_export_primitive(lone, module, "compact",
+			"compact", lone_lisp_primitive_memory_compact, module, flags);
+
+	lone_lisp_module_export_primitive(lone, module, "snapshot",
+			"snapshot", lone_lisp_primitive_memory_snapshot, module, flags);
+
+	lone_lisp_module_export_primitive(lone, module, "profile",
+			"profile", lone_lisp_primitive_memory_profile, module, flags);
+
+	lone_lisp_module_export_primitive(lone, module, "profile-report",
+			"profile_report", lone_lisp_primitive_memory_profile_report, module, flags);
+}
+
+static void lone_lisp_memory_statistics_set(struct lone_lisp *lone,
+		struct lone_lisp_value table, char *key, struct lone_lisp_value value)
+{
+	size_t roots;
+
+	roots = lone_lisp_roots_save(lone);
+	lone_lisp_root(lone, &table);
+	lone_lisp_root(lone, &value);
+	lone_lisp_table_set(lone, table, lone_lisp_intern_c_string(lone, key), value);
+	lone_lisp_roots_restore(lone, roots);
+}
+
+static void lone_lisp_memory_statistics_set_count(struct lone_lisp *lone,
+		struct lone_lisp_value table, char *key, size_t count)
+{
+	lone_lisp_memory_statistics_set(lone, table, key, lone_lisp_integer_create((lone_lisp_integer) count));
+}
+
+static struct lone_lisp_value lone_lisp_memory_statistics_heap_live(struct lone_lisp *lone)
+{
+	static char *types[LONE_LISP_HEAP_VALUE_TYPES] = {
+		[LONE_LISP_TYPE_MODULE]    = "module",
+		[LONE_LISP_TYPE_FUNCTION]  = "function",
+		[LONE_LISP_TYPE_PRIMITIVE] = "primitive",
+		[LONE_LISP_TYPE_LIST]      = "list",
+		[LONE_LISP_TYPE_VECTOR]    = "vector",
+		[LONE_LISP_TYPE_TABLE]     = "table",
+		[LONE_LISP_TYPE_SYMBOL]    = "symbol",
+		[LONE_LISP_TYPE_TEXT]      = "text",
+		[LONE_LISP_TYPE_BYTES]     = "bytes",
+	};
+	size_t counts[LONE_LISP_HEAP_VALUE_TYPES], i;
+	struct lone_lisp_value live;
+
+	live = lone_lisp_table_create(lone, 16, lone_lisp_nil());
+	lone_lisp_heap_count_live_values(lone, counts);
+
+	for (i = 0; i < LONE_LISP_HEAP_VALUE_TYPES; ++i) {
+		lone_lisp_memory_statistics_set_count(lone, live, types[i], counts[i]);
+	}
+
+	return live;
+}
+
+static struct lone_lisp_value lone_lisp_memory_statistics_pauses(struct lone_lisp *lone)
+{
+	struct lone_lisp_value pauses, histogram;
+	size_t roots, i;
+
+	roots = lone_lisp_roots_save(lone);
+	histogram = lone_lisp_vector_create(lone, LONE_LISP_GARBAGE_COLLECTOR_PAUSE_BUCKETS);
+	lone_lisp_root(lone, &histogram);
+
+	for (i = 0; i < LONE_LISP_GARBAGE_COLLECTOR_PAUSE_BUCKETS; ++i) {
+		lone_lisp_vector_push(lone, histogram,
+				lone_lisp_integer_create((lone_lisp_integer) lone->statistics.pauses.histogram[i]));
+	}
+
+	pauses = lone_lisp_table_create(lone, 8, lone_lisp_nil());
+	lone_lisp_memory_statistics_set_count(lone, pauses, "count", lone->statistics.pauses.count);
+	lone_lisp_memory_statistics_set_count(lone, pauses, "total", lone->statistics.pauses.total);
+	lone_lisp_memory_statistics_set_count(lone, pauses, "maximum", lone->statistics.pauses.maximum);
+	lone_lisp_memory_statistics_set(lone, pauses, "histogram", histogram);
+
+	lone_lisp_roots_restore(lone, roots);
+	return pauses;
+}
+
+LONE_LISP_PRIMITIVE(memory_statistics)
+{
+	struct lone_system *system = lone->system;
+	struct lone_lisp_value statistics, free, heap;
+	size_t roots;
+
+	if (!lone_lisp_is_nil(arguments)) { /* no arguments expected: (statistics 1) */ linux_exit(-1); }
+
+	/* pages and bytes are still being released in the background */
+	lone_lisp_garbage_collector_join_sweeper(lone);
+
+	roots = lone_lisp_roots_save(lone);
+	free = heap = lone_lisp_nil();
+	lone_lisp_root(lone, &free);
+	lone_lisp_root(lone, &heap);
+
+	free = lone_lisp_table_create(lone, 4, lone_lisp_nil());
+	lone_lisp_memory_statistics_set_count(lone, free, "blocks", system->memory.statistics.free.blocks);
+	lone_lisp_memory_statistics_set_count(lone, free, "bytes", system->memory.statistics.free.bytes);
+	lone_lisp_memory_statistics_set_count(lone, free, "largest", lone_memory_largest_free_block(system));
+
+	heap = lone_lisp_table_create(lone, 4, lone_lisp_nil());
+	lone_lisp_memory_statistics_set_count(lone, heap, "pages", lone->statistics.heap.pages);
+	lone_lisp_memory_statistics_set_count(lone, heap, "allocations", lone->statistics.heap.allocations);
+	lone_lisp_memory_statistics_set_count(lone, heap, "collections", lone->statistics.heap.collections);
+	lone_lisp_memory_statistics_set_count(lone, heap, "minor-collections", lone->statistics.heap.minor_collections);
+	lone_lisp_memory_statistics_set_count(lone, heap, "slices", lone->statistics.heap.slices);
+	lone_lisp_memory_statistics_set_count(lone, heap, "compactions", lone->statistics.heap.compactions);
+	lone_lisp_memory_statistics_set(lone, heap, "pauses", lone_lisp_memory_statistics_pauses(lone));
+	lone_lisp_memory_statistics_set(lone, heap, "live", lone_lisp_memory_statistics_heap_live(lone));
+
+	statistics = lone_lisp_table_create(lone, 16, lone_lisp_nil());
+	lone_lisp_memory_statistics_set_count(lone, statistics, "allocations", system->memory.statistics.allocations);
+	lone_lisp_memory_statistics_set_count(lone, statistics, "deallocations", system->memory.statistics.deallocations);
+	lone_lisp_memory_statistics_set_count(lone, statistics, "allocated", system->memory.statistics.allocated);
+	lone_lisp_memory_statistics_set_count(lone, statistics, "arenas", system->memory.statistics.arenas);
+	lone_lisp_memory_statistics_set_count(lone, statistics, "mapped", system->memory.statistics.mapped);
+	lone_lisp_memory_statistics_set_count(lone, statistics, "trimmed", system->memory.statistics.trimmed);
+	lone_lisp_memory_statistics_set(lone, statistics, "free", free);
+	lone_lisp_memory_statistics_set(lone, statistics, "heap", heap);
+
+	lone_lisp_roots_restore(lone, roots);
+	return statistics;
+}
+
+LONE_LISP_PRIMITIVE(memory_huge_pages)
+{
+	struct lone_system *system = lone->system;
+	struct lone_lisp_value enable;
+
+	if (!lone_lisp_is_nil(arguments)) {
+		enable = lone_lisp_list_first(arguments);
+		arguments = lone_lisp_list_rest(arguments);
+		if (!lone_lisp_is_nil(arguments)) { /* too many arguments: (huge-pages true 1) */ linux_exit(-1); }
+
+		/* only arenas mapped from now on are affected */
+		system->memory.huge_pages = !lone_lisp_is_nil(enable);
+	}
+
+	return lone_lisp_boolean_for(lone, system->memory.huge_pages);
+}
+
+LONE_LISP_PRIMITIVE(memory_collect)
+{
+	struct lone_lisp_value generation;
+
+	if (lone_lisp_is_nil(arguments)) {
+		/* everything unreachable is gone once it returns */
+		lone_lisp_garbage_collector(lone);
+		return lone_lisp_nil();
+	}
+
+	generation = lone_lisp_list_first(arguments);
+	arguments = lone_lisp_list_rest(arguments);
+	if (!lone_lisp_is_nil(arguments)) { /* too many arguments: (collect 'minor 1) */ linux_exit(-1); }
+
+	if (lone_lisp_is_equal(generation, lone_lisp_intern_c_string(lone, "minor"))) {
+		lone_lisp_garbage_collector_minor(lone);
+	} else if (lone_lisp_is_equal(generation, lone_lisp_intern_c_string(lone, "major"))) {
+		/* collects the way the garbage collector would have, marking and sweeping may not be done yet */
+		lone_lisp_garbage_collector_major(lone);
+	} else {
+		/* unknown generation: (collect 'old) */ linux_exit(-1);
+	}
+
+	return lone_lisp_nil();
+}
+
+LONE_LISP_PRIMITIVE(memory_incremental)
+{
+	struct lone_lisp_value slice;
+
+	if (!lone_lisp_is_nil(arguments)) {
+		slice = lone_lisp_list_first(arguments);
+		arguments = lone_lisp_list_rest(arguments);
+		if (!lone_lisp_is_nil(arguments)) { /* too many arguments: (incremental 1024 1) */ linux_exit(-1); }
+
+		if (lone_lisp_is_nil(slice)) {
+			lone->garbage_collector.incremental.slice = 0;
+		} else if (lone_lisp_is_integer(slice) && lone_lisp_integer_of(slice) > 0) {
+			lone->garbage_collector.incremental.slice = (size_t) lone_lisp_integer_of(slice);
+		} else {
+			/* expected maximum number of values marked per slice: (incremental 0) */ linux_exit(-1);
+		}
+	}
+
+	if (!lone->garbage_collector.incremental.slice) { return lone_lisp_nil(); }
+
+	return lone_lisp_integer_create((lone_lisp_integer) lone->garbage_collector.incremental.slice);
+}
+
+LONE_LISP_PRIMITIVE(memory_parallel)
+{
+	struct lone_lisp_value threads;
+
+	if (!lone_lisp_is_nil(arguments)) {
+		threads = lone_lisp_list_first(arguments);
+		arguments = lone_lisp_list_rest(arguments);
+		if (!lone_lisp_is_nil(arguments)) { /* too many arguments: (parallel 4 1) */ linux_exit(-1); }
+
+		/* helper threads are created by the next marking phase and kept around */
+		if (lone_lisp_is_nil(threads)) {
+			lone->garbage_collector.parallel.threads = 0;
+		} else if (lone_lisp_is_integer(threads) && lone_lisp_integer_of(threads) > 0) {
+			lone->garbage_collector.parallel.threads = (size_t) lone_lisp_integer_of(threads);
+		} else {
+			/* expected number of helper threads that mark along with the interpreter: (parallel 0) */ linux_exit(-1);
+		}
+	}
+
+	if (!lone->garbage_collector.parallel.threads) { return lone_lisp_nil(); }
+
+	return lone_lisp_integer_create((lone_lisp_integer) lone->garbage_collector.parallel.threads);
+}
+
+LONE_LISP_PRIMITIVE(memory_background_sweeping)
+{
+	struct lone_lisp_value enable;
+
+	if (!lone_lisp_is_nil(arguments)) {
+		enable = lone_lisp_list_first(arguments);
+		arguments = lone_lisp_list_rest(arguments);
+		if (!lone_lisp_is_nil(arguments)) { /* too many arguments: (background-sweeping true 1) */ linux_exit(-1); }
+
+		/* the sweeper thread is created by the next major cycle and kept around */
+		lone->garbage_collector.sweeper.enabled = !lone_lisp_is_nil(enable);
+	}
+
+	return lone_lisp_boolean_for(lone, lone->garbage_collector.sweeper.enabled);
+}
+
+LONE_LISP_PRIMITIVE(memory_compact)
+{
+	if (!lone_lisp_is_nil(arguments)) { /* too many arguments: (compact 1) */ linux_exit(-1); }
+
+	/* values cannot move while primitives are running */
+	lone->garbage_collector.compaction.requested = true;
+
+	return lone_lisp_nil();
+}
+
+LONE_LISP_PRIMITIVE(memory_snapshot)
+{
+	struct lone_lisp_value path;
+	unsigned char *c_path;
+	long file_descriptor;
+
+	if (lone_lisp_is_nil(arguments)) { /* no path given: (snapshot) */ linux_exit(-1); }
+	path = lone_lisp_list_first(arguments);
+	arguments = lone_lisp_list_rest(arguments);
+	if (!lone_lisp_is_nil(arguments)) { /* too many arguments: (snapshot "image" 1) */ linux_exit(-1); }
+	if (!lone_lisp_is_text(path)) { /* path is not text: (snapshot 1) */ linux_exit(-1); }
+
+	/* zero filled, the path is terminated */
+	c_path = lone_memory_array(lone->system, 0, path.as.heap_value->as.bytes.count + 1, 1);
+	lone_memory_move(path.as.heap_value->as.bytes.pointer, c_path, path.as.heap_value->as.bytes.count);
+
+	file_descriptor = linux_openat(AT_FDCWD, c_path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	lone_deallocate(lone->system, c_path);
+	if (file_descriptor < 0) { /* could not create image */ linux_exit(-1); }
+
+	lone_lisp_image_write(lone, (int) file_descriptor);
+	linux_close((int) file_descriptor);
+
+	return lone_lisp_nil();
+}
+
+LONE_LISP_PRIMITIVE(memory_profile)
+{
+	struct lone_lisp_value interval;
+
+	if (!lone_lisp_is_nil(arguments)) {
+		interval = lone_lisp_list_first(arguments);
+		arguments = lone_lisp_list_rest(arguments);
+		if (!lone_lisp_is_nil(arguments)) { /* too many arguments: (profile 4096 1) */ linux_exit(-1); }
+
+		/* samples already taken are kept when profiling stops */
+		if (lone_lisp_is_nil(interval)) {
+			lone_lisp_profiler_stop(lone);
+		} else if (lone_lisp_is_equal(interval, lone->constants.truth)) {
+			lone_lisp_profiler_start(lone, LONE_LISP_PROFILER_INTERVAL);
+		} else if (lone_lisp_is_integer(interval) && lone_lisp_integer_of(interval) > 0) {
+			lone_lisp_profiler_start(lone, (size_t) lone_lisp_integer_of(interval));
+		} else {
+			/* expected number of bytes allocated between samples: (profile 0) */ linux_exit(-1);
+		}
+	}
+
+	if (!lone->profiler.interval) { return lone_lisp_nil(); }
+
+	return lone_lisp_integer_create((lone_lisp_integer) lone->profiler.interval);
+}
+
+LONE_LISP_PRIMITIVE(memory_profile_report)
+{
+	struct lone_lisp_value file_descriptor, format;
+	enum lone_lisp_profiler_format profiler_format = LONE_LISP_PROFILER_TABLE;
+
+	if (lone_lisp_is_nil(arguments)) { /* no file descriptor given: (profile-report) */ linux_exit(-1); }
+	file_descriptor = lone_lisp_list_first(arguments);
+	arguments = lone_lisp_list_rest(arguments);
+	if (!lone_lisp_is_integer(file_descriptor)) { /* file descriptor is not an integer: (profile-report "1") */ linux_exit(-1); }
+
+	if (!lone_lisp_is_nil(arguments)) {
+		format = lone_lisp_list_first(arguments);
+		arguments = lone_lisp_list_rest(arguments);
+		if (!lone_lisp_is_nil(arguments)) { /* too many arguments: (profile-report 1 'table 1) */ linux_exit(-1); }
+
+		if (lone_lisp_is_equal(format, lone_lisp_intern_c_string(lone, "folded"))) {
+			profiler_format = LONE_LISP_PROFILER_FOLDED;
+		} else if (!lone_lisp_is_equal(format, lone_lisp_intern_c_string(lone, "table"))) {
+			/* unknown report format: (profile-report 1 'graph) */ linux_exit(-1);
+		}
+	}
+
+	lone_lisp_profiler_report(lone, (int) lone_lisp_integer_of(file_descriptor), profiler_format);
+
+	return lone_lisp_nil();
+}
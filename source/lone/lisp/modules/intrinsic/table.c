@@ -38,6 +38,9 @@ void lone_lisp_modules_intrinsic_table_initialize(struct lone_lisp *lone)
 
 	lone_lisp_module_export_primitive(lone, module, "count",
 			"table_count", lone_lisp_primitive_table_count, module, flags);
+
+	lone_lisp_module_export_primitive(lone, module, "weak",
+			"table_weak", lone_lisp_primitive_table_weak, module, flags);
 }
 
 LONE_LISP_PRIMITIVE(table_get)
@@ -116,3 +119,25 @@ LONE_LISP_PRIMITIVE(table_count)
 
 	return lone_lisp_integer_create(lone_lisp_table_count(table));
 }
+
+LONE_LISP_PRIMITIVE(table_weak)
+{
+	enum lone_lisp_table_weakness weakness;
+	struct lone_lisp_value mode;
+
+	if (lone_lisp_list_destructure(arguments, 1, &mode)) {
+		/* wrong number of arguments */ linux_exit(-1);
+	}
+
+	if (lone_lisp_is_identical(mode, lone_lisp_intern_c_string(lone, "keys"))) {
+		weakness = LONE_LISP_TABLE_WEAK_KEYS;
+	} else if (lone_lisp_is_identical(mode, lone_lisp_intern_c_string(lone, "values"))) {
+		weakness = LONE_LISP_TABLE_WEAK_VALUES;
+	} else if (lone_lisp_is_identical(mode, lone_lisp_intern_c_string(lone, "ephemeron"))) {
+		weakness = LONE_LISP_TABLE_EPHEMERON;
+	} else {
+		/* keys, values or ephemeron not given: (weak 'strong) */ linux_exit(-1);
+	}
+
+	return lone_lisp_table_create_weak(lone, 16, weakness);
+}
@@ -41,7 +41,7 @@ LONE_LISP_PRIMITIVE(text_to_symbol)
 		/* wrong number of arguments */ linux_exit(-1);
 	}
 
-	if (text.type != LONE_LISP_TYPE_HEAP_VALUE || text.as.heap_value->type != LONE_LISP_TYPE_TEXT) {
+	if (!lone_lisp_is_heap_value(text) || text.as.heap_value->type != LONE_LISP_TYPE_TEXT) {
 		/* argument not a text value: (to-symbol 123) */ linux_exit(-1);
 	}
 
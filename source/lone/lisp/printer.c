@@ -5,6 +5,7 @@
 #include <lone/lisp/value/list.h>
 #include <lone/lisp/value/vector.h>
 #include <lone/lisp/value/table.h>
+#include <lone/lisp/value/integer.h>
 #include <lone/lisp/value/pointer.h>
 
 #include <lone/memory/allocator.h>
@@ -45,8 +46,8 @@ static void lone_lisp_print_integer(int fd, long n)
 
 static void lone_lisp_print_pointer(struct lone_lisp *lone, struct lone_lisp_value pointer, int fd)
 {
-	if (pointer.pointer_type == LONE_TO_UNKNOWN) {
-		lone_lisp_print_integer(fd, (intptr_t) pointer.as.pointer.to_void);
+	if (lone_lisp_pointer_type_of(pointer) == LONE_TO_UNKNOWN) {
+		lone_lisp_print_integer(fd, (intptr_t) lone_lisp_pointer_of(pointer).to_void);
 	} else {
 		lone_lisp_print(lone, lone_lisp_pointer_dereference(pointer), fd);
 	}
@@ -181,12 +182,12 @@ void lone_lisp_print(struct lone_lisp *lone, struct lone_lisp_value value, int f
 {
 	struct lone_lisp_heap_value *actual;
 
-	switch (value.type) {
+	switch (lone_lisp_type_of(value)) {
 	case LONE_LISP_TYPE_NIL:
 		linux_write(fd, "nil", 3);
 		return;
 	case LONE_LISP_TYPE_INTEGER:
-		lone_lisp_print_integer(fd, value.as.integer);
+		lone_lisp_print_integer(fd, lone_lisp_integer_of(value));
 		return;
 	case LONE_LISP_TYPE_POINTER:
 		lone_lisp_print_pointer(lone, value, fd);
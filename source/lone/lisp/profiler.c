@@ -0,0 +1,647 @@
+/* SPDX-License-Identifier: AGPL-3.0-or-later */
+
+#include <lone/lisp/profiler.h>
+#include <lone/lisp/garbage_collector.h>
+#include <lone/lisp/value.h>
+
+#include <lone/memory/allocator.h>
+#include <lone/memory/array.h>
+#include <lone/memory/functions.h>
+
+#include <lone/utilities.h>
+#include <lone/linux.h>
+
+#define LONE_LISP_PROFILER_MEMORY (LONE_LISP_PROFILER_KINDS - 1)
+
+/* the sweeper reports the death of the values it sweeps while the interpreter samples others */
+static void lone_lisp_profiler_lock(struct lone_lisp *lone)
+{
+	while (__atomic_exchange_n(&lone->profiler.lock, 1, __ATOMIC_ACQUIRE)) {
+		linux_sched_yield();
+	}
+}
+
+static void lone_lisp_profiler_unlock(struct lone_lisp *lone)
+{
+	__atomic_store_n(&lone->profiler.lock, 0, __ATOMIC_RELEASE);
+}
+
+static size_t lone_lisp_profiler_hash(uintptr_t x, uintptr_t y)
+{
+	return (size_t) ((((x >> 3) ^ (y * 31)) * 0x9E3779B97F4A7C15UL) >> 17);
+}
+
+static size_t lone_lisp_profiler_frame_slot(struct lone_lisp *lone, size_t parent, unsigned char *name)
+{
+	struct lone_lisp_profiler *profiler = &lone->profiler;
+	size_t mask = profiler->frames.slot_count - 1, i, frame;
+
+	i = lone_lisp_profiler_hash((uintptr_t) name, parent) & mask;
+
+	while ((frame = profiler->frames.slots[i])) {
+		frame -= 1;
+		if (profiler->frames.list[frame].parent == parent &&
+		    profiler->frames.list[frame].name.pointer == name) { break; }
+		i = (i + 1) & mask;
+	}
+
+	return i;
+}
+
+/* aligned allocations are never sampled, the profiler does not observe itself */
+static void *lone_lisp_profiler_allocate(struct lone_lisp *lone, size_t count, size_t size)
+{
+	return lone_allocate_aligned(lone->system, lone_memory_array_size_in_bytes(count, size), LONE_ALIGNMENT);
+}
+
+/* only the interpreter creates frames, the lock keeps the sweeper away while the list moves */
+static void lone_lisp_profiler_grow_frames(struct lone_lisp *lone)
+{
+	struct lone_lisp_profiler *profiler = &lone->profiler;
+	struct lone_lisp_profiler_frame *list, *old_list;
+	size_t capacity, *slots, *old_slots, i;
+
+	capacity = profiler->frames.capacity? 2 * profiler->frames.capacity : 64;
+	list = lone_lisp_profiler_allocate(lone, capacity, sizeof(*list));
+	slots = lone_lisp_profiler_allocate(lone, 2 * capacity, sizeof(*slots));
+
+	lone_lisp_profiler_lock(lone);
+
+	old_list = profiler->frames.list;
+	old_slots = profiler->frames.slots;
+
+	if (old_list) { lone_memory_move(old_list, list, profiler->frames.count * sizeof(*list)); }
+
+	profiler->frames.list = list;
+	profiler->frames.capacity = capacity;
+	profiler->frames.slots = slots;
+	profiler->frames.slot_count = 2 * capacity;
+
+	lone_lisp_profiler_unlock(lone);
+
+	for (i = 1; i < profiler->frames.count; ++i) {
+		slots[lone_lisp_profiler_frame_slot(lone, list[i].parent, list[i].name.pointer)] = i + 1;
+	}
+
+	if (old_list) { lone_deallocate(lone->system, old_list); }
+	if (old_slots) { lone_deallocate(lone->system, old_slots); }
+}
+
+/* the top level frame is never looked up, its name is only printed */
+static size_t lone_lisp_profiler_frame_for(struct lone_lisp *lone, size_t parent, struct lone_bytes name)
+{
+	struct lone_lisp_profiler *profiler = &lone->profiler;
+	struct lone_lisp_profiler_frame *frame;
+	size_t slot;
+
+	slot = lone_lisp_profiler_frame_slot(lone, parent, name.pointer);
+	if (profiler->frames.slots[slot]) { return profiler->frames.slots[slot] - 1; }
+
+	if (profiler->frames.count == profiler->frames.capacity) {
+		lone_lisp_profiler_grow_frames(lone);
+		slot = lone_lisp_profiler_frame_slot(lone, parent, name.pointer);
+	}
+
+	/* frames past the count are never read by the sweeper */
+	frame = &profiler->frames.list[profiler->frames.count];
+	lone_memory_zero(frame, sizeof(*frame));
+	frame->parent = parent;
+	frame->name = name;
+	profiler->frames.slots[slot] = profiler->frames.count + 1;
+
+	lone_lisp_profiler_lock(lone);
+	profiler->frames.count += 1;
+	lone_lisp_profiler_unlock(lone);
+
+	return profiler->frames.count - 1;
+}
+
+static size_t lone_lisp_profiler_sample_slot(struct lone_lisp *lone, void *pointer)
+{
+	struct lone_lisp_profiler *profiler = &lone->profiler;
+	size_t mask = profiler->samples.slot_count - 1, i;
+
+	i = lone_lisp_profiler_hash((uintptr_t) pointer, 0) & mask;
+
+	while (profiler->samples.slots[i].pointer && profiler->samples.slots[i].pointer != pointer) {
+		i = (i + 1) & mask;
+	}
+
+	return i;
+}
+
+/* ╭────────────────────────────────────────────────────────────────────────╮
+   │                                                                        │
+   │    The lock is never held across calls to the allocator. Allocating    │
+   │    may reclaim memory by collecting garbage, and the collector and     │
+   │    the sweeper report the values that die to the profiler. Room for    │
+   │    another sample is made with the lock released, and the table is     │
+   │    only replaced if no other thread replaced it in the meantime.       │
+   │                                                                        │
+   ╰────────────────────────────────────────────────────────────────────────╯ */
+static void lone_lisp_profiler_reserve(struct lone_lisp *lone)
+{
+	struct lone_lisp_profiler *profiler = &lone->profiler;
+	struct lone_lisp_profiler_sample *slots, *old;
+	size_t slot_count, old_count, i;
+
+	while (2 * (profiler->samples.count + 1) > profiler->samples.slot_count) {
+		old_count = profiler->samples.slot_count;
+		slot_count = old_count? 2 * old_count : 256;
+
+		lone_lisp_profiler_unlock(lone);
+		slots = lone_lisp_profiler_allocate(lone, slot_count, sizeof(*slots));
+		lone_lisp_profiler_lock(lone);
+
+		if (profiler->samples.slot_count != old_count) {
+			/* deallocating never collects garbage */
+			lone_deallocate(lone->system, slots);
+			continue;
+		}
+
+		old = profiler->samples.slots;
+		profiler->samples.slots = slots;
+		profiler->samples.slot_count = slot_count;
+
+		for (i = 0; i < old_count; ++i) {
+			if (!old[i].pointer) { continue; }
+			slots[lone_lisp_profiler_sample_slot(lone, old[i].pointer)] = old[i];
+		}
+
+		if (old) { lone_deallocate(lone->system, old); }
+	}
+}
+
+/* room must have been reserved */
+static void lone_lisp_profiler_record(struct lone_lisp *lone, void *pointer, size_t size, bool value)
+{
+	struct lone_lisp_profiler *profiler = &lone->profiler;
+	struct lone_lisp_profiler_sample *sample;
+
+	sample = &profiler->samples.slots[lone_lisp_profiler_sample_slot(lone, pointer)];
+	sample->pointer = pointer;
+	sample->frame = profiler->frame;
+	sample->bytes = size > profiler->interval? size : profiler->interval;
+	sample->value = value;
+	profiler->samples.count += 1;
+}
+
+/* linear probing: entries that follow the removed one are shifted back, tombstones are not needed */
+static struct lone_lisp_profiler_sample lone_lisp_profiler_remove(struct lone_lisp *lone, void *pointer)
+{
+	struct lone_lisp_profiler *profiler = &lone->profiler;
+	struct lone_lisp_profiler_sample removed, *slots = profiler->samples.slots;
+	size_t mask = profiler->samples.slot_count - 1, i, j, home;
+
+	i = lone_lisp_profiler_sample_slot(lone, pointer);
+	removed = slots[i];
+	if (!removed.pointer) { return removed; }
+
+	for (j = (i + 1) & mask; slots[j].pointer; j = (j + 1) & mask) {
+		home = lone_lisp_profiler_hash((uintptr_t) slots[j].pointer, 0) & mask;
+
+		/* entries whose home lies cyclically between the hole and themselves stay */
+		if (((j - home) & mask) < ((j - i) & mask)) { continue; }
+
+		slots[i] = slots[j];
+		i = j;
+	}
+
+	slots[i].pointer = 0;
+	profiler->samples.count -= 1;
+
+	return removed;
+}
+
+static void lone_lisp_profiler_count_death(struct lone_lisp *lone,
+		struct lone_lisp_profiler_sample sample, size_t kind)
+{
+	struct lone_lisp_profiler_frame *frame;
+
+	if (!sample.pointer) { return; }
+
+	frame = &lone->profiler.frames.list[sample.frame];
+	frame->dead[kind].samples += 1;
+	frame->dead[kind].bytes += sample.bytes;
+}
+
+static bool lone_lisp_profiler_on_allocation(void *context, void *pointer, size_t size)
+{
+	struct lone_lisp *lone = context;
+
+	if (lone->profiler.reporting || !lone->profiler.interval) { return false; }
+
+	lone_lisp_profiler_lock(lone);
+	lone_lisp_profiler_reserve(lone);
+	lone_lisp_profiler_record(lone, pointer, size, false);
+	lone_lisp_profiler_unlock(lone);
+
+	return true;
+}
+
+static void lone_lisp_profiler_on_deallocation(void *context, void *pointer)
+{
+	struct lone_lisp *lone = context;
+
+	lone_lisp_profiler_lock(lone);
+	lone_lisp_profiler_count_death(lone, lone_lisp_profiler_remove(lone, pointer), LONE_LISP_PROFILER_MEMORY);
+	lone_lisp_profiler_unlock(lone);
+}
+
+void lone_lisp_profiler_initialize(struct lone_lisp *lone)
+{
+	struct lone_system *system = lone->system;
+
+	lone_memory_zero(&lone->profiler, sizeof(lone->profiler));
+
+	system->memory.sampler.allocated = lone_lisp_profiler_on_allocation;
+	system->memory.sampler.deallocated = lone_lisp_profiler_on_deallocation;
+	system->memory.sampler.context = lone;
+}
+
+/* samples taken before profiling was stopped are kept until they die */
+void lone_lisp_profiler_start(struct lone_lisp *lone, size_t interval)
+{
+	struct lone_lisp_profiler *profiler = &lone->profiler;
+
+	if (!interval) { /* samples must stand for some bytes */ linux_exit(-1); }
+
+	if (!profiler->frames.count) {
+		lone_lisp_profiler_grow_frames(lone);
+		profiler->frames.list[0].name = LONE_BYTES_VALUE_FROM_LITERAL("top-level");
+		profiler->frames.count = 1;
+	}
+
+	/* periodic allocation patterns would always be sampled at the same point otherwise */
+	if (!profiler->random) {
+		profiler->random = lone->system->hash.fnv_1a.offset_basis;
+		lone->system->memory.sampler.random = ~profiler->random;
+	}
+
+	profiler->interval = interval;
+	profiler->countdown = lone_random_interval(&profiler->random, interval);
+	lone->system->memory.sampler.interval = interval;
+	lone->system->memory.sampler.countdown = lone_random_interval(&lone->system->memory.sampler.random, interval);
+}
+
+void lone_lisp_profiler_stop(struct lone_lisp *lone)
+{
+	lone->system->memory.sampler.interval = 0;
+	lone->profiler.interval = 0;
+}
+
+/* symbols used to apply functions name their frames, primitives name themselves */
+size_t lone_lisp_profiler_enter(struct lone_lisp *lone, struct lone_bytes name, struct lone_lisp_value applicable)
+{
+	struct lone_lisp_profiler *profiler = &lone->profiler;
+	size_t parent = profiler->frame;
+
+	if (!profiler->interval) { return parent; }
+
+	if (!name.pointer) {
+		if (lone_lisp_is_primitive(applicable)) {
+			name = applicable.as.heap_value->as.primitive.name.as.heap_value->as.bytes;
+		} else {
+			name = LONE_BYTES_VALUE_FROM_LITERAL("lambda");
+		}
+	}
+
+	profiler->frame = lone_lisp_profiler_frame_for(lone, parent, name);
+
+	return parent;
+}
+
+void lone_lisp_profiler_leave(struct lone_lisp *lone, size_t frame)
+{
+	lone->profiler.frame = frame;
+}
+
+/* values are sampled like memory, each one counts as the bytes it occupies in its heap */
+bool lone_lisp_profiler_should_sample_value(struct lone_lisp *lone)
+{
+	struct lone_lisp_profiler *profiler = &lone->profiler;
+
+	if (sizeof(struct lone_lisp_heap_value) < profiler->countdown) {
+		profiler->countdown -= sizeof(struct lone_lisp_heap_value);
+		return false;
+	}
+
+	profiler->countdown = lone_random_interval(&profiler->random, profiler->interval);
+
+	/* room is made before the value is allocated, the collections it may cause cannot see it */
+	lone_lisp_profiler_lock(lone);
+	lone_lisp_profiler_reserve(lone);
+	lone_lisp_profiler_unlock(lone);
+
+	return true;
+}
+
+/* helper threads that marked while the value was allocated may have taken the room, the sample is dropped then */
+void lone_lisp_profiler_sample_value(struct lone_lisp *lone, struct lone_lisp_heap_value *value)
+{
+	struct lone_lisp_profiler *profiler = &lone->profiler;
+
+	lone_lisp_profiler_lock(lone);
+
+	if (2 * (profiler->samples.count + 1) <= profiler->samples.slot_count) {
+		lone_lisp_profiler_record(lone, value, sizeof(*value), true);
+		value->sampled = true;
+	}
+
+	lone_lisp_profiler_unlock(lone);
+}
+
+void lone_lisp_profiler_forget_value(struct lone_lisp *lone, struct lone_lisp_heap_value *value)
+{
+	lone_lisp_profiler_lock(lone);
+	lone_lisp_profiler_count_death(lone, lone_lisp_profiler_remove(lone, value), value->type);
+	lone_lisp_profiler_unlock(lone);
+}
+
+/* the sample is removed before it is added back, the table never needs to grow */
+void lone_lisp_profiler_move_value(struct lone_lisp *lone,
+		struct lone_lisp_heap_value *from, struct lone_lisp_heap_value *to)
+{
+	struct lone_lisp_profiler_sample sample;
+
+	lone_lisp_profiler_lock(lone);
+
+	sample = lone_lisp_profiler_remove(lone, from);
+
+	if (sample.pointer) {
+		sample.pointer = to;
+		lone->profiler.samples.slots[lone_lisp_profiler_sample_slot(lone, to)] = sample;
+		lone->profiler.samples.count += 1;
+	}
+
+	lone_lisp_profiler_unlock(lone);
+}
+
+/* ╭────────────────────────────────────────────────────────────────────────╮
+   │                                                                        │
+   │    Reports are assembled in memory and written out in one go.          │
+   │    Both formats count the samples that are alive right after a         │
+   │    full collection. Tables add up the frames that share a name and     │
+   │    list them by the bytes they keep alive; folded stacks name every    │
+   │    frame from the top level down followed by the type of the values    │
+   │    and the bytes they keep alive.                                      │
+   │                                                                        │
+   ╰────────────────────────────────────────────────────────────────────────╯ */
+
+struct lone_lisp_profiler_count {
+	size_t samples;
+	size_t bytes;
+};
+
+struct lone_lisp_profiler_row {
+	size_t frame;
+	size_t kind;
+	struct lone_lisp_profiler_count live;
+	struct lone_lisp_profiler_count allocated;
+};
+
+struct lone_lisp_profiler_text {
+	unsigned char *bytes;
+	size_t count;
+	size_t capacity;
+};
+
+static char *lone_lisp_profiler_kinds[LONE_LISP_PROFILER_KINDS] = {
+	[LONE_LISP_TYPE_MODULE]     = "module",
+	[LONE_LISP_TYPE_FUNCTION]   = "function",
+	[LONE_LISP_TYPE_PRIMITIVE]  = "primitive",
+	[LONE_LISP_TYPE_LIST]       = "list",
+	[LONE_LISP_TYPE_VECTOR]     = "vector",
+	[LONE_LISP_TYPE_TABLE]      = "table",
+	[LONE_LISP_TYPE_SYMBOL]     = "symbol",
+	[LONE_LISP_TYPE_TEXT]       = "text",
+	[LONE_LISP_TYPE_BYTES]      = "bytes",
+	[LONE_LISP_PROFILER_MEMORY] = "memory",
+};
+
+static void lone_lisp_profiler_append(struct lone_lisp *lone,
+		struct lone_lisp_profiler_text *text, void *bytes, size_t count)
+{
+	if (text->count + count > text->capacity) {
+		text->capacity = 2 * (text->count + count) + 256;
+		text->bytes = lone_memory_array(lone->system, text->bytes, text->capacity, 1);
+	}
+
+	lone_memory_move(bytes, text->bytes + text->count, count);
+	text->count += count;
+}
+
+static void lone_lisp_profiler_append_c_string(struct lone_lisp *lone,
+		struct lone_lisp_profiler_text *text, char *c_string, size_t width)
+{
+	size_t count = 0;
+
+	while (c_string[count]) { ++count; }
+	lone_lisp_profiler_append(lone, text, c_string, count);
+	for (/* count */; count < width; ++count) { lone_lisp_profiler_append(lone, text, " ", 1); }
+}
+
+/* numbers are aligned to the right of their columns */
+static void lone_lisp_profiler_append_number(struct lone_lisp *lone,
+		struct lone_lisp_profiler_text *text, size_t number, size_t width)
+{
+	char digits[LONE_DECIMAL_DIGITS_PER_LONG];
+	size_t count = 0;
+
+	do {
+		digits[sizeof(digits) - ++count] = (char) ('0' + number % 10);
+		number /= 10;
+	} while (number);
+
+	for (/* count */; width > count; --width) { lone_lisp_profiler_append(lone, text, " ", 1); }
+	lone_lisp_profiler_append(lone, text, digits + sizeof(digits) - count, count);
+}
+
+static void lone_lisp_profiler_append_stack(struct lone_lisp *lone,
+		struct lone_lisp_profiler_text *text, size_t frame)
+{
+	struct lone_lisp_profiler_frame *list = lone->profiler.frames.list;
+
+	if (frame) {
+		lone_lisp_profiler_append_stack(lone, text, list[frame].parent);
+		lone_lisp_profiler_append(lone, text, ";", 1);
+	}
+
+	lone_lisp_profiler_append(lone, text, list[frame].name.pointer, list[frame].name.count);
+}
+
+static bool lone_lisp_profiler_row_precedes(struct lone_lisp_profiler_row *a, struct lone_lisp_profiler_row *b)
+{
+	if (a->live.bytes != b->live.bytes) { return a->live.bytes > b->live.bytes; }
+	return a->allocated.bytes > b->allocated.bytes;
+}
+
+static bool lone_lisp_profiler_same_name(struct lone_bytes a, struct lone_bytes b)
+{
+	return a.count == b.count && lone_memory_is_equal(a.pointer, b.pointer, a.count);
+}
+
+/* frames that share a name are counted as the first one in tables */
+static void lone_lisp_profiler_total(struct lone_lisp *lone, struct lone_lisp_profiler_row *totals,
+		struct lone_lisp_profiler_count *live, size_t frames, enum lone_lisp_profiler_format format)
+{
+	struct lone_lisp_profiler_frame *list = lone->profiler.frames.list;
+	struct lone_lisp_profiler_count *count;
+	struct lone_lisp_profiler_row *total;
+	size_t f, g, kind;
+
+	for (f = 0; f < frames; ++f) {
+		g = f;
+
+		if (format == LONE_LISP_PROFILER_TABLE) {
+			for (g = 0; g < f && !lone_lisp_profiler_same_name(list[g].name, list[f].name); ++g);
+		}
+
+		for (kind = 0; kind < LONE_LISP_PROFILER_KINDS; ++kind) {
+			total = &totals[g * LONE_LISP_PROFILER_KINDS + kind];
+			count = &live[f * LONE_LISP_PROFILER_KINDS + kind];
+
+			total->frame = g;
+			total->kind = kind;
+			total->live.samples += count->samples;
+			total->live.bytes += count->bytes;
+			total->allocated.samples += count->samples + list[f].dead[kind].samples;
+			total->allocated.bytes += count->bytes + list[f].dead[kind].bytes;
+		}
+	}
+}
+
+/* insertion sort keeps rows that tie in the order of their frames */
+static size_t lone_lisp_profiler_sort(struct lone_lisp_profiler_row *rows,
+		struct lone_lisp_profiler_row *totals, size_t count, enum lone_lisp_profiler_format format)
+{
+	struct lone_lisp_profiler_row row;
+	size_t n, g, i;
+
+	for (n = 0, i = 0; i < count; ++i) {
+		row = totals[i];
+		if (!row.allocated.samples) { continue; }
+		if (format == LONE_LISP_PROFILER_FOLDED && !row.live.samples) { continue; }
+
+		for (g = n++; g && lone_lisp_profiler_row_precedes(&row, &rows[g - 1]); --g) {
+			rows[g] = rows[g - 1];
+		}
+
+		rows[g] = row;
+	}
+
+	return n;
+}
+
+static void lone_lisp_profiler_write(int file_descriptor, unsigned char *bytes, size_t count)
+{
+	ssize_t written;
+
+	while (count) {
+		written = linux_write(file_descriptor, bytes, count);
+
+		if (written == -EINTR) { continue; }
+		if (written <= 0) { /* could not write report */ linux_exit(-1); }
+
+		bytes += written;
+		count -= (size_t) written;
+	}
+}
+
+/* only the interpreter creates frames, their names and parents can be read without the lock */
+void lone_lisp_profiler_report(struct lone_lisp *lone, int file_descriptor, enum lone_lisp_profiler_format format)
+{
+	struct lone_lisp_profiler *profiler = &lone->profiler;
+	struct lone_lisp_profiler_text text = { 0, 0, 0 };
+	struct lone_lisp_profiler_row *rows, *totals;
+	struct lone_lisp_profiler_count *live, *count;
+	struct lone_lisp_profiler_sample *sample;
+	size_t frames, kind, i, n;
+
+	if (!profiler->frames.count) { return; }
+
+	/* samples are alive if they survived a collection, which is not sampled */
+	profiler->reporting = true;
+	lone_lisp_garbage_collector(lone);
+
+	frames = profiler->frames.count;
+	live = lone_memory_array(lone->system, 0, frames * LONE_LISP_PROFILER_KINDS, sizeof(*live));
+	totals = lone_memory_array(lone->system, 0, frames * LONE_LISP_PROFILER_KINDS, sizeof(*totals));
+	rows = lone_memory_array(lone->system, 0, frames * LONE_LISP_PROFILER_KINDS, sizeof(*rows));
+
+	lone_lisp_profiler_lock(lone);
+
+	for (i = 0; i < profiler->samples.slot_count; ++i) {
+		sample = &profiler->samples.slots[i];
+		if (!sample->pointer) { continue; }
+
+		kind = sample->value? ((struct lone_lisp_heap_value *) sample->pointer)->type : LONE_LISP_PROFILER_MEMORY;
+		count = &live[sample->frame * LONE_LISP_PROFILER_KINDS + kind];
+		count->samples += 1;
+		count->bytes += sample->bytes;
+	}
+
+	lone_lisp_profiler_total(lone, totals, live, frames, format);
+
+	lone_lisp_profiler_unlock(lone);
+
+	n = lone_lisp_profiler_sort(rows, totals, frames * LONE_LISP_PROFILER_KINDS, format);
+
+	switch (format) {
+	case LONE_LISP_PROFILER_TABLE:
+		lone_lisp_profiler_append_c_string(lone, &text,
+				"  live bytes  live  allocated bytes  allocated  type       function\n", 0);
+
+		for (i = 0; i < n; ++i) {
+			lone_lisp_profiler_append_number(lone, &text, rows[i].live.bytes, 12);
+			lone_lisp_profiler_append_number(lone, &text, rows[i].live.samples, 6);
+			lone_lisp_profiler_append_number(lone, &text, rows[i].allocated.bytes, 17);
+			lone_lisp_profiler_append_number(lone, &text, rows[i].allocated.samples, 11);
+			lone_lisp_profiler_append(lone, &text, "  ", 2);
+			lone_lisp_profiler_append_c_string(lone, &text, lone_lisp_profiler_kinds[rows[i].kind], 11);
+			lone_lisp_profiler_append(lone, &text, profiler->frames.list[rows[i].frame].name.pointer,
+					profiler->frames.list[rows[i].frame].name.count);
+			lone_lisp_profiler_append(lone, &text, "\n", 1);
+		}
+		break;
+	case LONE_LISP_PROFILER_FOLDED:
+		for (i = 0; i < n; ++i) {
+			lone_lisp_profiler_append_stack(lone, &text, rows[i].frame);
+			lone_lisp_profiler_append(lone, &text, ";", 1);
+			lone_lisp_profiler_append_c_string(lone, &text, lone_lisp_profiler_kinds[rows[i].kind], 0);
+			lone_lisp_profiler_append(lone, &text, " ", 1);
+			lone_lisp_profiler_append_number(lone, &text, rows[i].live.bytes, 0);
+			lone_lisp_profiler_append(lone, &text, "\n", 1);
+		}
+		break;
+	}
+
+	lone_lisp_profiler_write(file_descriptor, text.bytes, text.count);
+
+	lone_deallocate(lone->system, live);
+	lone_deallocate(lone->system, totals);
+	lone_deallocate(lone->system, rows);
+	if (text.bytes) { lone_deallocate(lone->system, text.bytes); }
+
+	profiler->reporting = false;
+}
+
+static bool lone_lisp_profiler_is_c_string(char *a, char *b)
+{
+	while (*a && *a == *b) { ++a; ++b; }
+	return *a == *b;
+}
+
+void lone_lisp_profiler_report_to_file(struct lone_lisp *lone, char *path, char *format)
+{
+	long file_descriptor;
+
+	file_descriptor = linux_openat(AT_FDCWD, (unsigned char *) path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if (file_descriptor < 0) { /* could not create report */ linux_exit(-1); }
+
+	lone_lisp_profiler_report(lone, (int) file_descriptor,
+			format && lone_lisp_profiler_is_c_string(format, "folded")?
+				LONE_LISP_PROFILER_FOLDED : LONE_LISP_PROFILER_TABLE);
+
+	linux_close((int) file_descriptor);
+}
@@ -9,7 +9,9 @@
 #include <lone/lisp/value/symbol.h>
 #include <lone/lisp/value/integer.h>
 
-#include <lone/memory/allocator.h>
+#include <lone/lisp/garbage_collector.h>
+
+#include <lone/memory/scratch.h>
 
 #include <lone/linux.h>
 
@@ -17,6 +19,7 @@ void lone_lisp_reader_for_bytes(struct lone_lisp *lone,
 		struct lone_lisp_reader *reader, struct lone_bytes bytes)
 {
 	reader->file_descriptor = -1;
+	lone_memory_scratch_initialize(&reader->scratch, lone->system, 0);
 	reader->buffer.bytes = bytes;
 	reader->buffer.position.read = 0;
 	reader->buffer.position.write = bytes.count;
@@ -28,8 +31,9 @@ void lone_lisp_reader_for_file_descriptor(struct lone_lisp *lone,
 		struct lone_lisp_reader *reader, size_t buffer_size, int file_descriptor)
 {
 	reader->file_descriptor = file_descriptor;
+	lone_memory_scratch_initialize(&reader->scratch, lone->system, buffer_size);
 	reader->buffer.bytes.count = buffer_size;
-	reader->buffer.bytes.pointer = lone_allocate(lone->system, buffer_size);
+	reader->buffer.bytes.pointer = lone_memory_scratch_allocate(&reader->scratch, buffer_size);
 	reader->buffer.position.read = 0;
 	reader->buffer.position.write = 0;
 	reader->status.error = false;
@@ -38,9 +42,7 @@ void lone_lisp_reader_for_file_descriptor(struct lone_lisp *lone,
 
 void lone_lisp_reader_finalize(struct lone_lisp *lone, struct lone_lisp_reader *reader)
 {
-	if (reader->file_descriptor != -1) {
-		lone_deallocate(lone->system, reader->buffer.bytes.pointer);
-	}
+	lone_memory_scratch_finalize(&reader->scratch);
 }
 
 static size_t lone_lisp_reader_fill_buffer(struct lone_lisp *lone, struct lone_lisp_reader *reader)
@@ -56,7 +58,12 @@ static size_t lone_lisp_reader_fill_buffer(struct lone_lisp *lone, struct lone_l
 	}
 
 	while (1) {
-		read_result = linux_read(reader->file_descriptor, buffer + position, size);
+		if (position == allocated) {
+			buffer = lone_memory_scratch_reallocate(&reader->scratch, buffer, allocated, allocated + size);
+			allocated += size;
+		}
+
+		read_result = linux_read(reader->file_descriptor, buffer + position, allocated - position);
 
 		if (read_result < 0) {
 			linux_exit(-1);
@@ -66,10 +73,7 @@ static size_t lone_lisp_reader_fill_buffer(struct lone_lisp *lone, struct lone_l
 		total_read += bytes_read;
 		position += bytes_read;
 
-		if (bytes_read == size) {
-			allocated += size;
-			buffer = lone_reallocate(lone->system, buffer, allocated);
-		} else {
+		if (position < allocated) {
 			break;
 		}
 	}
@@ -408,9 +412,11 @@ static struct lone_lisp_value lone_lisp_parse(struct lone_lisp *, struct lone_li
 static struct lone_lisp_value lone_lisp_parse_vector(struct lone_lisp *lone, struct lone_lisp_reader *reader)
 {
 	struct lone_lisp_value vector, value;
-	size_t i;
+	size_t roots, i;
 
+	roots = lone_lisp_roots_save(lone);
 	vector = lone_lisp_vector_create(lone, 32);
+	lone_lisp_root(lone, &vector);
 	i = 0;
 
 	while (1) {
@@ -431,9 +437,11 @@ static struct lone_lisp_value lone_lisp_parse_vector(struct lone_lisp *lone, str
 		lone_lisp_vector_set_value_at(lone, vector, i++, value);
 	}
 
+	lone_lisp_roots_restore(lone, roots);
 	return vector;
 
 error:
+	lone_lisp_roots_restore(lone, roots);
 	reader->status.error = true;
 	return lone_lisp_nil();
 }
@@ -441,8 +449,13 @@ error:
 static struct lone_lisp_value lone_lisp_parse_table(struct lone_lisp *lone, struct lone_lisp_reader *reader)
 {
 	struct lone_lisp_value table, key, value;
+	size_t roots;
 
+	roots = lone_lisp_roots_save(lone);
 	table = lone_lisp_table_create(lone, 32, lone_lisp_nil());
+	key = lone_lisp_nil();
+	lone_lisp_root(lone, &table);
+	lone_lisp_root(lone, &key);
 
 	while (1) {
 		key = lone_lisp_lex(lone, reader);
@@ -476,9 +489,11 @@ static struct lone_lisp_value lone_lisp_parse_table(struct lone_lisp *lone, stru
 		lone_lisp_table_set(lone, table, key, value);
 	}
 
+	lone_lisp_roots_restore(lone, roots);
 	return table;
 
 error:
+	lone_lisp_roots_restore(lone, roots);
 	reader->status.error = true;
 	return lone_lisp_nil();
 }
@@ -488,8 +503,11 @@ static struct lone_lisp_value lone_lisp_parse_list(struct lone_lisp *lone,
 {
 	struct lone_lisp_value first, head, next;
 	bool at_least_one;
+	size_t roots;
 
+	roots = lone_lisp_roots_save(lone);
 	first = head = lone_lisp_nil();
+	lone_lisp_root(lone, &first);
 	at_least_one = false;
 
 	while (1) {
@@ -508,6 +526,7 @@ static struct lone_lisp_value lone_lisp_parse_list(struct lone_lisp *lone,
 					break;
 				} else {
 					/* empty list: () */
+					lone_lisp_roots_restore(lone, roots);
 					return lone_lisp_nil();
 				}
 
@@ -542,9 +561,11 @@ static struct lone_lisp_value lone_lisp_parse_list(struct lone_lisp *lone,
 		at_least_one = true;
 	}
 
+	lone_lisp_roots_restore(lone, roots);
 	return first;
 
 error:
+	lone_lisp_roots_restore(lone, roots);
 	reader->status.error = true;
 	return lone_lisp_nil();
 }
@@ -581,7 +602,7 @@ static struct lone_lisp_value lone_lisp_parse(struct lone_lisp *lone,
 	if (reader->status.end_of_input) { return lone_lisp_nil(); }
 
 	/* lexer has already parsed atoms */
-	switch (token.type) {
+	switch (lone_lisp_type_of(token)) {
 	case LONE_LISP_TYPE_NIL:
 	case LONE_LISP_TYPE_INTEGER:
 	case LONE_LISP_TYPE_POINTER:
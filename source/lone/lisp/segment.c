@@ -4,6 +4,8 @@
 
 #include <lone/lisp/segment.h>
 #include <lone/lisp/reader.h>
+#include <lone/lisp/garbage_collector.h>
+#include <lone/lisp/image.h>
 
 #include <lone/lisp/value/bytes.h>
 #include <lone/lisp/value/symbol.h>
@@ -16,10 +18,15 @@ struct lone_lisp_value lone_lisp_segment_read_descriptor(struct lone_lisp *lone,
 	struct lone_bytes bytes;
 	struct lone_lisp_value descriptor, symbol, data;
 	struct lone_lisp_reader reader;
-	size_t offset;
+	size_t roots, offset;
 
 	bytes = lone_segment_bytes(segment);
 
+	/* heap images precede the descriptor */
+	offset = lone_lisp_image_size(bytes);
+	bytes.pointer += offset;
+	bytes.count -= offset;
+
 	if (bytes.count == 0) {
 		/* empty lone segment */ return lone_lisp_nil();
 	}
@@ -30,10 +37,14 @@ struct lone_lisp_value lone_lisp_segment_read_descriptor(struct lone_lisp *lone,
 		/* corrupt or invalid segment */ linux_exit(-1);
 	}
 
+	roots = lone_lisp_roots_save(lone);
+	lone_lisp_root(lone, &descriptor);
+
 	offset = reader.buffer.position.read;
 	symbol = lone_lisp_intern_c_string(lone, "data");
 	data = lone_lisp_bytes_transfer(lone, bytes.pointer + offset, bytes.count - offset, false);
 	lone_lisp_table_set(lone, descriptor, symbol, data);
 
+	lone_lisp_roots_restore(lone, roots);
 	return descriptor;
 }
@@ -3,12 +3,14 @@
 #include <lone/lisp/types.h>
 
 #include <lone/lisp/value/vector.h>
+#include <lone/lisp/value/integer.h>
+#include <lone/lisp/value/pointer.h>
 
 #include <lone/linux.h>
 
 struct lone_lisp_value lone_lisp_nil(void)
 {
-	return (struct lone_lisp_value) { .type = LONE_LISP_TYPE_NIL };
+	return (struct lone_lisp_value) { .as.bits = 0 };
 }
 
 struct lone_lisp_value lone_lisp_boolean_for(struct lone_lisp *lisp, bool value)
@@ -16,13 +18,26 @@ struct lone_lisp_value lone_lisp_boolean_for(struct lone_lisp *lisp, bool value)
 	if (value) {
 		return lisp->constants.truth;
 	} else {
-		return (struct lone_lisp_value) { .type = LONE_LISP_TYPE_NIL };
+		return lone_lisp_nil();
+	}
+}
+
+enum lone_lisp_value_type lone_lisp_type_of(struct lone_lisp_value value)
+{
+	if (value.as.bits & LONE_LISP_INTEGER_TAG) {
+		return LONE_LISP_TYPE_INTEGER;
+	} else if (value.as.bits & LONE_LISP_POINTER_TAG) {
+		return LONE_LISP_TYPE_POINTER;
+	} else if (value.as.bits) {
+		return LONE_LISP_TYPE_HEAP_VALUE;
+	} else {
+		return LONE_LISP_TYPE_NIL;
 	}
 }
 
 bool lone_lisp_has_same_type(struct lone_lisp_value x, struct lone_lisp_value y)
 {
-	if (x.type == y.type) {
+	if (lone_lisp_type_of(x) == lone_lisp_type_of(y)) {
 		if (lone_lisp_is_heap_value(x) && lone_lisp_is_heap_value(y)) {
 			if (x.as.heap_value->type == y.as.heap_value->type) {
 				return true;
@@ -39,17 +54,17 @@ bool lone_lisp_has_same_type(struct lone_lisp_value x, struct lone_lisp_value y)
 
 bool lone_lisp_is_register_value(struct lone_lisp_value value)
 {
-	return value.type != LONE_LISP_TYPE_HEAP_VALUE;
+	return !lone_lisp_is_heap_value(value);
 }
 
 bool lone_lisp_is_register_value_of_type(struct lone_lisp_value value, enum lone_lisp_value_type register_value_type)
 {
-	return lone_lisp_is_register_value(value) && value.type == register_value_type;
+	return lone_lisp_type_of(value) == register_value_type;
 }
 
 bool lone_lisp_is_heap_value(struct lone_lisp_value value)
 {
-	return value.type == LONE_LISP_TYPE_HEAP_VALUE;
+	return value.as.bits && !(value.as.bits & LONE_LISP_TAG_MASK);
 }
 
 bool lone_lisp_is_heap_value_of_type(struct lone_lisp_value value, enum lone_lisp_heap_value_type heap_value_type)
@@ -134,19 +149,15 @@ bool lone_lisp_is_pointer(struct lone_lisp_value value)
 
 bool lone_lisp_is_identical(struct lone_lisp_value x, struct lone_lisp_value y)
 {
-	if (lone_lisp_has_same_type(x, y)) {
-		switch (x.type) {
-		case LONE_LISP_TYPE_NIL:
-			return true;
-		case LONE_LISP_TYPE_HEAP_VALUE:
-			return x.as.heap_value == y.as.heap_value;
-		case LONE_LISP_TYPE_INTEGER:
-			return x.as.integer == y.as.integer;
-		case LONE_LISP_TYPE_POINTER:
-			return x.as.pointer.to_void == y.as.pointer.to_void;
-		}
-	} else {
-		return false;
+	switch (lone_lisp_type_of(x)) {
+	case LONE_LISP_TYPE_NIL:
+	case LONE_LISP_TYPE_HEAP_VALUE:
+	case LONE_LISP_TYPE_INTEGER:
+		return x.as.bits == y.as.bits;
+	case LONE_LISP_TYPE_POINTER:
+		/* pointers of different types to the same address are identical */
+		return lone_lisp_is_pointer(y) &&
+		       lone_lisp_pointer_of(x).to_void == lone_lisp_pointer_of(y).to_void;
 	}
 }
 
@@ -154,7 +165,7 @@ bool lone_lisp_is_equivalent(struct lone_lisp_value x, struct lone_lisp_value y)
 {
 	if (!lone_lisp_has_same_type(x, y)) { return false; }
 
-	switch (x.type) {
+	switch (lone_lisp_type_of(x)) {
 	case LONE_LISP_TYPE_NIL:
 	case LONE_LISP_TYPE_INTEGER:
 	case LONE_LISP_TYPE_POINTER:
@@ -210,7 +221,7 @@ bool lone_lisp_is_equal(struct lone_lisp_value x, struct lone_lisp_value y)
 {
 	if (!lone_lisp_has_same_type(x, y)) { return false; }
 
-	switch (x.type) {
+	switch (lone_lisp_type_of(x)) {
 	case LONE_LISP_TYPE_NIL:
 	case LONE_LISP_TYPE_INTEGER:
 	case LONE_LISP_TYPE_POINTER:
@@ -247,7 +258,7 @@ static bool integers(struct lone_lisp_value x, struct lone_lisp_value y)
 bool lone_lisp_integer_is_less_than(struct lone_lisp_value x, struct lone_lisp_value y)
 {
 	if (integers(x, y)) {
-		return x.as.integer < y.as.integer;
+		return lone_lisp_integer_of(x) < lone_lisp_integer_of(y);
 	} else {
 		/* can't compare incompatible or non-integers integers */ linux_exit(-1);
 	}
@@ -256,7 +267,7 @@ bool lone_lisp_integer_is_less_than(struct lone_lisp_value x, struct lone_lisp_v
 bool lone_lisp_integer_is_less_than_or_equal_to(struct lone_lisp_value x, struct lone_lisp_value y)
 {
 	if (integers(x, y)) {
-		return x.as.integer <= y.as.integer;
+		return lone_lisp_integer_of(x) <= lone_lisp_integer_of(y);
 	} else {
 		/* can't compare incompatible or non-integers integers */ linux_exit(-1);
 	}
@@ -265,7 +276,7 @@ bool lone_lisp_integer_is_less_than_or_equal_to(struct lone_lisp_value x, struct
 bool lone_lisp_integer_is_greater_than(struct lone_lisp_value x, struct lone_lisp_value y)
 {
 	if (integers(x, y)) {
-		return x.as.integer > y.as.integer;
+		return lone_lisp_integer_of(x) > lone_lisp_integer_of(y);
 	} else {
 		/* can't compare incompatible or non-integers integers */ linux_exit(-1);
 	}
@@ -274,7 +285,7 @@ bool lone_lisp_integer_is_greater_than(struct lone_lisp_value x, struct lone_lis
 bool lone_lisp_integer_is_greater_than_or_equal_to(struct lone_lisp_value x, struct lone_lisp_value y)
 {
 	if (integers(x, y)) {
-		return x.as.integer >= y.as.integer;
+		return lone_lisp_integer_of(x) >= lone_lisp_integer_of(y);
 	} else {
 		/* can't compare incompatible or non-integers integers */ linux_exit(-1);
 	}
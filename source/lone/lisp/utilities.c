@@ -6,6 +6,7 @@
 #include <lone/lisp/value/list.h>
 
 #include <lone/memory/allocator.h>
+#include <lone/memory/scratch.h>
 #include <lone/memory/functions.h>
 
 #include <lone/linux.h>
@@ -39,7 +40,7 @@ struct lone_lisp_value lone_lisp_apply_comparator(struct lone_lisp *lone,
 	return lone_lisp_true(lone);
 }
 
-struct lone_bytes lone_lisp_join(struct lone_lisp *lone,
+static struct lone_bytes lone_lisp_join_into(struct lone_lisp *lone, struct lone_memory_scratch *scratch,
 		struct lone_lisp_value separator, struct lone_lisp_value arguments,
 		lone_lisp_predicate_function is_valid)
 {
@@ -72,7 +73,9 @@ struct lone_bytes lone_lisp_join(struct lone_lisp *lone,
 		}
 	}
 
-	joined = lone_allocate_uninitialized(lone->system, total + 1);
+	joined = scratch?
+		  lone_memory_scratch_allocate_uninitialized(scratch, total + 1)
+		: lone_allocate_uninitialized(lone->system, total + 1);
 
 	for (head = arguments; !lone_lisp_is_nil(head); head = lone_lisp_list_rest(head)) {
 		argument = lone_lisp_list_first(head);
@@ -97,8 +100,28 @@ struct lone_bytes lone_lisp_join(struct lone_lisp *lone,
 	return (struct lone_bytes) { .count = total, .pointer = joined };
 }
 
+struct lone_bytes lone_lisp_join(struct lone_lisp *lone,
+		struct lone_lisp_value separator, struct lone_lisp_value arguments,
+		lone_lisp_predicate_function is_valid)
+{
+	return lone_lisp_join_into(lone, 0, separator, arguments, is_valid);
+}
+
 struct lone_bytes lone_lisp_concatenate(struct lone_lisp *lone,
 		struct lone_lisp_value arguments, lone_lisp_predicate_function is_valid)
 {
 	return lone_lisp_join(lone, lone_lisp_nil(), arguments, is_valid);
 }
+
+struct lone_bytes lone_lisp_join_scratch(struct lone_lisp *lone, struct lone_memory_scratch *scratch,
+		struct lone_lisp_value separator, struct lone_lisp_value arguments,
+		lone_lisp_predicate_function is_valid)
+{
+	return lone_lisp_join_into(lone, scratch, separator, arguments, is_valid);
+}
+
+struct lone_bytes lone_lisp_concatenate_scratch(struct lone_lisp *lone, struct lone_memory_scratch *scratch,
+		struct lone_lisp_value arguments, lone_lisp_predicate_function is_valid)
+{
+	return lone_lisp_join_scratch(lone, scratch, lone_lisp_nil(), arguments, is_valid);
+}
@@ -5,8 +5,5 @@
 
 struct lone_lisp_value lone_lisp_value_from_heap_value(struct lone_lisp_heap_value *heap_value)
 {
-	return (struct lone_lisp_value) {
-		.type = LONE_LISP_TYPE_HEAP_VALUE,
-		.as.heap_value = heap_value
-	};
+	return (struct lone_lisp_value) { .as.heap_value = heap_value };
 }
@@ -5,11 +5,16 @@
 struct lone_lisp_value lone_lisp_integer_create(lone_lisp_integer integer)
 {
 	return (struct lone_lisp_value) {
-		.type = LONE_LISP_TYPE_INTEGER,
-		.as.integer = integer
+		.as.bits = ((uintptr_t) integer << 1) | LONE_LISP_INTEGER_TAG
 	};
 }
 
+lone_lisp_integer lone_lisp_integer_of(struct lone_lisp_value integer)
+{
+	/* arithmetic shift restores the sign */
+	return ((lone_lisp_integer) integer.as.bits) >> 1;
+}
+
 struct lone_lisp_value lone_lisp_integer_parse(struct lone_lisp *lone, unsigned char *digits, size_t count)
 {
 	size_t i = 0;
@@ -5,6 +5,7 @@
 #include <lone/lisp/value/vector.h>
 
 #include <lone/lisp/heap.h>
+#include <lone/lisp/garbage_collector.h>
 
 #include <lone/memory/allocator.h>
 #include <lone/memory/functions.h>
@@ -14,10 +15,19 @@
 struct lone_lisp_value lone_lisp_list_create(struct lone_lisp *lone,
 		struct lone_lisp_value first, struct lone_lisp_value rest)
 {
-	struct lone_lisp_heap_value *actual = lone_lisp_heap_allocate_value(lone);
+	struct lone_lisp_heap_value *actual;
+	size_t roots;
+
+	roots = lone_lisp_roots_save(lone);
+	lone_lisp_root(lone, &first);
+	lone_lisp_root(lone, &rest);
+
+	actual = lone_lisp_heap_allocate_value(lone);
 	actual->type = LONE_LISP_TYPE_LIST;
 	actual->as.list.first = first;
 	actual->as.list.rest = rest;
+
+	lone_lisp_roots_restore(lone, roots);
 	return lone_lisp_value_from_heap_value(actual);
 }
 
@@ -56,6 +66,7 @@ struct lone_lisp_value lone_lisp_list_set_first(struct lone_lisp *lone,
 	} else if (!lone_lisp_is_list(value)) {
 		/* expected a list value */ linux_exit(-1);
 	} else {
+		lone_lisp_garbage_collector_write_barrier(lone, value, first);
 		return value.as.heap_value->as.list.first = first;
 	}
 }
@@ -68,6 +79,7 @@ struct lone_lisp_value lone_lisp_list_set_rest(struct lone_lisp *lone,
 	} else if (!lone_lisp_is_list(value)) {
 		/* expected a list value */ linux_exit(-1);
 	} else {
+		lone_lisp_garbage_collector_write_barrier(lone, value, rest);
 		return value.as.heap_value->as.list.rest = rest;
 	}
 }
@@ -91,22 +103,35 @@ struct lone_lisp_value lone_lisp_list_build(struct lone_lisp *lone, size_t count
 {
 	struct lone_lisp_value list, head;
 	va_list arguments;
-	size_t i;
+	size_t roots, i;
+
+	roots = lone_lisp_roots_save(lone);
+	list = head = lone_lisp_nil();
+	lone_lisp_root(lone, &list);
 
 	va_start(arguments, count);
+	for (i = 0; i < count; ++i) {
+		lone_lisp_root(lone, va_arg(arguments, struct lone_lisp_value *));
+	}
+	va_end(arguments);
 
-	for (i = 0, list = head = lone_lisp_nil(); i < count; ++i) {
+	va_start(arguments, count);
+	for (i = 0; i < count; ++i) {
 		lone_lisp_list_append(lone, &list, &head, *va_arg(arguments, struct lone_lisp_value *));
 	}
-
 	va_end(arguments);
 
+	lone_lisp_roots_restore(lone, roots);
 	return list;
 }
 
 struct lone_lisp_value lone_lisp_list_to_vector(struct lone_lisp *lone, struct lone_lisp_value list)
 {
 	struct lone_lisp_value vector;
+	size_t roots;
+
+	roots = lone_lisp_roots_save(lone);
+	lone_lisp_root(lone, &list);
 
 	vector = lone_lisp_vector_create(lone, 16);
 
@@ -114,12 +139,20 @@ struct lone_lisp_value lone_lisp_list_to_vector(struct lone_lisp *lone, struct l
 		lone_lisp_vector_push(lone, vector, lone_lisp_list_first(list));
 	}
 
+	lone_lisp_roots_restore(lone, roots);
 	return vector;
 }
 
 struct lone_lisp_value lone_lisp_list_flatten(struct lone_lisp *lone, struct lone_lisp_value list)
 {
 	struct lone_lisp_value flattened, head, flat_head, return_head, first;
+	size_t roots;
+
+	roots = lone_lisp_roots_save(lone);
+	return_head = lone_lisp_nil();
+	lone_lisp_root(lone, &list);
+	lone_lisp_root(lone, &flattened);
+	lone_lisp_root(lone, &return_head);
 
 	for (head = list, flattened = flat_head = lone_lisp_nil(); !lone_lisp_is_nil(head); head = lone_lisp_list_rest(head)) {
 		first = lone_lisp_list_first(head);
@@ -136,6 +169,7 @@ struct lone_lisp_value lone_lisp_list_flatten(struct lone_lisp *lone, struct lon
 		}
 	}
 
+	lone_lisp_roots_restore(lone, roots);
 	return flattened;
 }
 
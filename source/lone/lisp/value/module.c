@@ -5,13 +5,30 @@
 #include <lone/lisp/value/vector.h>
 #include <lone/lisp/value/table.h>
 #include <lone/lisp/heap.h>
+#include <lone/lisp/garbage_collector.h>
 
 struct lone_lisp_value lone_lisp_module_create(struct lone_lisp *lone, struct lone_lisp_value name)
 {
-	struct lone_lisp_heap_value *actual = lone_lisp_heap_allocate_value(lone);
+	struct lone_lisp_value environment, exports;
+	struct lone_lisp_heap_value *actual;
+	size_t roots;
+
+	roots = lone_lisp_roots_save(lone);
+	environment = exports = lone_lisp_nil();
+	lone_lisp_root(lone, &name);
+	lone_lisp_root(lone, &environment);
+	lone_lisp_root(lone, &exports);
+
+	/* created first: values must not allocate after their own allocation */
+	environment = lone_lisp_table_create(lone, 64, lone->modules.top_level_environment);
+	exports = lone_lisp_vector_create(lone, 16);
+
+	actual = lone_lisp_heap_allocate_value(lone);
 	actual->type = LONE_LISP_TYPE_MODULE;
 	actual->as.module.name = name;
-	actual->as.module.environment = lone_lisp_table_create(lone, 64, lone->modules.top_level_environment);
-	actual->as.module.exports = lone_lisp_vector_create(lone, 16);
+	actual->as.module.environment = environment;
+	actual->as.module.exports = exports;
+
+	lone_lisp_roots_restore(lone, roots);
 	return lone_lisp_value_from_heap_value(actual);
 }
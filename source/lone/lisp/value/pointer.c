@@ -8,35 +8,50 @@
 struct lone_lisp_value lone_lisp_pointer_create(void *pointer, enum lone_lisp_pointer_type pointer_type)
 {
 	return (struct lone_lisp_value) {
-		.type = LONE_LISP_TYPE_POINTER,
-		.pointer_type = pointer_type,
-		.as.pointer.to_void = pointer
+		.as.bits = ((uintptr_t) pointer << LONE_LISP_POINTER_SHIFT) |
+		           ((uintptr_t) pointer_type << LONE_LISP_POINTER_TYPE_SHIFT) |
+		           LONE_LISP_POINTER_TAG
 	};
 }
 
+union lone_lisp_pointer lone_lisp_pointer_of(struct lone_lisp_value pointer)
+{
+	return (union lone_lisp_pointer) { .to_void = (void *) (pointer.as.bits >> LONE_LISP_POINTER_SHIFT) };
+}
+
+enum lone_lisp_pointer_type lone_lisp_pointer_type_of(struct lone_lisp_value pointer)
+{
+	return (pointer.as.bits >> LONE_LISP_POINTER_TYPE_SHIFT) &
+	       ((1UL << (LONE_LISP_POINTER_SHIFT - LONE_LISP_POINTER_TYPE_SHIFT)) - 1);
+}
+
 struct lone_lisp_value lone_lisp_pointer_dereference(struct lone_lisp_value pointer)
 {
+	union lone_lisp_pointer address;
+
 	if (!lone_lisp_is_pointer(pointer)) {
 		/* can't dereference this value */ linux_exit(-1);
 	}
 
-	switch (pointer.pointer_type) {
+	address = lone_lisp_pointer_of(pointer);
+
+	switch (lone_lisp_pointer_type_of(pointer)) {
 	case LONE_TO_U8:
-		return lone_lisp_integer_create(*pointer.as.pointer.to_u8);
+		return lone_lisp_integer_create(*address.to_u8);
 	case LONE_TO_S8:
-		return lone_lisp_integer_create(*pointer.as.pointer.to_s8);
+		return lone_lisp_integer_create(*address.to_s8);
 	case LONE_TO_U16:
-		return lone_lisp_integer_create(*pointer.as.pointer.to_u16);
+		return lone_lisp_integer_create(*address.to_u16);
 	case LONE_TO_S16:
-		return lone_lisp_integer_create(*pointer.as.pointer.to_s16);
+		return lone_lisp_integer_create(*address.to_s16);
 	case LONE_TO_U32:
-		return lone_lisp_integer_create(*pointer.as.pointer.to_u32);
+		return lone_lisp_integer_create(*address.to_u32);
 	case LONE_TO_S32:
-		return lone_lisp_integer_create(*pointer.as.pointer.to_s32);
+		return lone_lisp_integer_create(*address.to_s32);
 	case LONE_TO_U64:
-		return lone_lisp_integer_create(*pointer.as.pointer.to_u64);
+		return lone_lisp_integer_create(*address.to_u64);
 	case LONE_TO_S64:
-		return lone_lisp_integer_create(*pointer.as.pointer.to_s64);
+		return lone_lisp_integer_create(*address.to_s64);
 	case LONE_TO_UNKNOWN:
 		/* cannot dereference pointer to unknown type */ linux_exit(-1);
 	}
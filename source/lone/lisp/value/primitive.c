@@ -5,16 +5,27 @@
 #include <lone/lisp/value/symbol.h>
 
 #include <lone/lisp/heap.h>
+#include <lone/lisp/garbage_collector.h>
 
 struct lone_lisp_value lone_lisp_primitive_create(struct lone_lisp *lone,
 		char *name, lone_lisp_primitive_function function,
 		struct lone_lisp_value closure, struct lone_lisp_function_flags flags)
 {
-	struct lone_lisp_heap_value *actual = lone_lisp_heap_allocate_value(lone);
+	struct lone_lisp_heap_value *actual;
+	struct lone_lisp_value symbol;
+	size_t roots;
+
+	roots = lone_lisp_roots_save(lone);
+	lone_lisp_root(lone, &closure);
+
+	symbol = lone_lisp_intern_c_string(lone, name);
+	actual = lone_lisp_heap_allocate_value(lone);
 	actual->type = LONE_LISP_TYPE_PRIMITIVE;
-	actual->as.primitive.name = lone_lisp_intern_c_string(lone, name);
+	actual->as.primitive.name = symbol;
 	actual->as.primitive.function = function;
 	actual->as.primitive.closure = closure;
-	actual->as.primitive.flags = flags;
+	actual->flags = flags;
+
+	lone_lisp_roots_restore(lone, roots);
 	return lone_lisp_value_from_heap_value(actual);
 }
@@ -3,6 +3,7 @@
 #include <lone/lisp/value/symbol.h>
 #include <lone/lisp/value/bytes.h>
 #include <lone/lisp/value/table.h>
+#include <lone/lisp/garbage_collector.h>
 
 #include <lone/memory/functions.h>
 
@@ -32,11 +33,15 @@ struct lone_lisp_value lone_lisp_intern(struct lone_lisp *lone,
 		unsigned char *bytes, size_t count, bool should_deallocate)
 {
 	struct lone_lisp_value key, value;
+	size_t roots;
 
+	roots = lone_lisp_roots_save(lone);
 	key = should_deallocate?
 		  lone_lisp_bytes_copy(lone, bytes, count)
 		: lone_lisp_bytes_transfer(lone, bytes, count, should_deallocate);
 
+	lone_lisp_root(lone, &key);
+
 	value = lone_lisp_table_get(lone, lone->symbol_table, key);
 
 	if (lone_lisp_is_nil(value)) {
@@ -47,6 +52,7 @@ struct lone_lisp_value lone_lisp_intern(struct lone_lisp *lone,
 		lone_lisp_table_set(lone, lone->symbol_table, key, value);
 	}
 
+	lone_lisp_roots_restore(lone, roots);
 	return value;
 }
 
@@ -63,5 +69,14 @@ struct lone_lisp_value lone_lisp_intern_c_string(struct lone_lisp *lone, char *c
 
 struct lone_lisp_value lone_lisp_intern_text(struct lone_lisp *lone, struct lone_lisp_value text)
 {
-	return lone_lisp_intern_bytes(lone, text.as.heap_value->as.bytes, true);
+	struct lone_lisp_value symbol;
+	size_t roots;
+
+	/* the bytes are copied again after the key is allocated */
+	roots = lone_lisp_roots_save(lone);
+	lone_lisp_root(lone, &text);
+	symbol = lone_lisp_intern_bytes(lone, text.as.heap_value->as.bytes, true);
+	lone_lisp_roots_restore(lone, roots);
+
+	return symbol;
 }
@@ -5,26 +5,59 @@
 #include <lone/lisp/value.h>
 #include <lone/lisp/value/table.h>
 #include <lone/lisp/heap.h>
+#include <lone/lisp/image.h>
+#include <lone/lisp/garbage_collector.h>
 
 #include <lone/memory/allocator.h>
 #include <lone/memory/array.h>
+#include <lone/memory/functions.h>
+
+/* entries and indexes share one allocation, the indexes follow the entries */
+static struct lone_lisp_table_entry *lone_lisp_table_allocate(struct lone_lisp *lone, size_t capacity)
+{
+	return lone_memory_array(lone->system, 0, capacity,
+			sizeof(struct lone_lisp_table_entry) + sizeof(struct lone_lisp_table_index));
+}
+
+static struct lone_lisp_table_index *lone_lisp_table_indexes(struct lone_lisp_table_entry *entries, size_t capacity)
+{
+	return (struct lone_lisp_table_index *) (entries + capacity);
+}
 
 struct lone_lisp_value lone_lisp_table_create(struct lone_lisp *lone,
 		size_t capacity, struct lone_lisp_value prototype)
 {
-	struct lone_lisp_heap_value *heap_value = lone_lisp_heap_allocate_value(lone);
-	struct lone_lisp_table *actual = &heap_value->as.table;
+	struct lone_lisp_heap_value *heap_value;
+	struct lone_lisp_table *actual;
+	size_t roots;
+
+	roots = lone_lisp_roots_save(lone);
+	lone_lisp_root(lone, &prototype);
+	heap_value = lone_lisp_heap_allocate_value(lone);
+	lone_lisp_roots_restore(lone, roots);
 
+	actual = &heap_value->as.table;
 	heap_value->type = LONE_LISP_TYPE_TABLE;
+	heap_value->weakness = LONE_LISP_TABLE_STRONG;
 	actual->prototype = prototype;
 	actual->count = 0;
-	actual->capacity = capacity;
-	actual->indexes = lone_memory_array(lone->system, 0, actual->capacity, sizeof(*actual->indexes));
-	actual->entries = lone_memory_array(lone->system, 0, actual->capacity, sizeof(*actual->entries));
+	actual->capacity = (lone_u32) capacity;
+	actual->entries = lone_lisp_table_allocate(lone, capacity);
 
 	return lone_lisp_value_from_heap_value(heap_value);
 }
 
+struct lone_lisp_value lone_lisp_table_create_weak(struct lone_lisp *lone,
+		size_t capacity, enum lone_lisp_table_weakness weakness)
+{
+	struct lone_lisp_value table;
+
+	table = lone_lisp_table_create(lone, capacity, lone_lisp_nil());
+	table.as.heap_value->weakness = weakness;
+
+	return table;
+}
+
 size_t lone_lisp_table_count(struct lone_lisp_value table)
 {
 	return table.as.heap_value->as.table.count;
@@ -40,31 +73,59 @@ static double lone_lisp_table_load_factor(struct lone_lisp_value table, unsigned
 	return count / capacity;
 }
 
-static unsigned long lone_lisp_table_compute_hash_for(struct lone_lisp *lone,
+/* weakly held keys die one object at a time, equal objects must not share their entries */
+static bool lone_lisp_table_is_keyed_by_identity(struct lone_lisp_value table)
+{
+	switch (table.as.heap_value->weakness) {
+	case LONE_LISP_TABLE_WEAK_KEYS:
+	case LONE_LISP_TABLE_EPHEMERON:
+		return true;
+	case LONE_LISP_TABLE_STRONG:
+	case LONE_LISP_TABLE_WEAK_VALUES:
+		return false;
+	}
+
+	return false;
+}
+
+static unsigned long lone_lisp_table_compute_hash_for(struct lone_lisp *lone, bool identity,
 		struct lone_lisp_value key, size_t capacity)
 {
-	return lone_lisp_hash(lone, key) % capacity;
+	if (identity) {
+		return lone_lisp_hash_identity(lone, key) % capacity;
+	} else {
+		return lone_lisp_hash(lone, key) % capacity;
+	}
 }
 
-static size_t lone_lisp_table_entry_find_index_for(struct lone_lisp *lone, struct lone_lisp_value key,
-		struct lone_lisp_table_index *indexes, struct lone_lisp_table_entry *entries,
-		size_t capacity)
+static bool lone_lisp_table_keys_match(bool identity, struct lone_lisp_value x, struct lone_lisp_value y)
+{
+	if (identity) {
+		return lone_lisp_is_identical(x, y);
+	} else {
+		return lone_lisp_is_equal(x, y);
+	}
+}
+
+static size_t lone_lisp_table_entry_find_index_for(struct lone_lisp *lone, bool identity,
+		struct lone_lisp_value key, struct lone_lisp_table_index *indexes,
+		struct lone_lisp_table_entry *entries, size_t capacity)
 {
-	size_t i = lone_lisp_table_compute_hash_for(lone, key, capacity);
+	size_t i = lone_lisp_table_compute_hash_for(lone, identity, key, capacity);
 
-	while (indexes[i].used && !lone_lisp_is_equal(entries[indexes[i].index].key, key)) {
+	while (indexes[i].used && !lone_lisp_table_keys_match(identity, entries[indexes[i].index].key, key)) {
 		i = (i + 1) % capacity;
 	}
 
 	return i;
 }
 
-static bool lone_lisp_table_entry_set(struct lone_lisp *lone,
+static bool lone_lisp_table_entry_set(struct lone_lisp *lone, bool identity,
 		struct lone_lisp_table_index *indexes, struct lone_lisp_table_entry *entries,
 		size_t capacity, size_t index_if_new_entry,
 		struct lone_lisp_value key, struct lone_lisp_value value)
 {
-	size_t i = lone_lisp_table_entry_find_index_for(lone, key, indexes, entries, capacity);
+	size_t i = lone_lisp_table_entry_find_index_for(lone, identity, key, indexes, entries, capacity);
 
 	if (indexes[i].used) {
 		entries[indexes[i].index].value = value;
@@ -81,39 +142,62 @@ static bool lone_lisp_table_entry_set(struct lone_lisp *lone,
 static void lone_lisp_table_resize(struct lone_lisp *lone, struct lone_lisp_value table, size_t new_capacity)
 {
 	struct lone_lisp_table *actual;
-	struct lone_lisp_table_index *old_indexes, *new_indexes;
-	struct lone_lisp_table_entry *old_entries, *new_entries;
-	size_t old_capacity;
+	struct lone_lisp_table_index *new_indexes;
+	struct lone_lisp_table_entry *new_entries;
 	size_t i;
 
 	actual = &table.as.heap_value->as.table;
 
-	old_capacity = actual->capacity;
-	old_entries  = actual->entries;
-	old_indexes  = actual->indexes;
-
-	new_indexes = lone_memory_array(lone->system,           0, new_capacity, sizeof(*new_indexes));
-	new_entries = lone_memory_array(lone->system, old_entries, new_capacity, sizeof(*new_entries));
-
-	for (i = 0; i < old_capacity; ++i) {
-		if (old_indexes[i].used) {
-			lone_lisp_table_entry_set(
-				lone,
-				new_indexes,
-				new_entries,
-				new_capacity,
-				old_indexes[i].index,
-				new_entries[old_indexes[i].index].key,
-				new_entries[old_indexes[i].index].value
-			);
-		}
+	new_entries = lone_lisp_table_allocate(lone, new_capacity);
+	new_indexes = lone_lisp_table_indexes(new_entries, new_capacity);
+
+	lone_memory_move(actual->entries, new_entries, actual->count * sizeof(*new_entries));
+
+	for (i = 0; i < actual->count; ++i) {
+		lone_lisp_table_entry_set(
+			lone,
+			lone_lisp_table_is_keyed_by_identity(table),
+			new_indexes,
+			new_entries,
+			new_capacity,
+			i,
+			new_entries[i].key,
+			new_entries[i].value
+		);
 	}
 
-	lone_deallocate(lone->system, old_indexes);
+	if (!lone_lisp_image_contains(lone, actual->entries)) {
+		lone_deallocate(lone->system, actual->entries);
+	}
 
-	actual->indexes = new_indexes;
 	actual->entries = new_entries;
-	actual->capacity = new_capacity;
+	actual->capacity = (lone_u32) new_capacity;
+}
+
+/* hashes of keys may change when values move, entries stay where they are */
+void lone_lisp_table_rehash(struct lone_lisp *lone, struct lone_lisp_value table)
+{
+	struct lone_lisp_table_index *indexes;
+	struct lone_lisp_table *actual;
+	size_t i;
+
+	actual = &table.as.heap_value->as.table;
+	indexes = lone_lisp_table_indexes(actual->entries, actual->capacity);
+
+	lone_memory_zero(indexes, actual->capacity * sizeof(*indexes));
+
+	for (i = 0; i < actual->count; ++i) {
+		lone_lisp_table_entry_set(
+			lone,
+			lone_lisp_table_is_keyed_by_identity(table),
+			indexes,
+			actual->entries,
+			actual->capacity,
+			i,
+			actual->entries[i].key,
+			actual->entries[i].value
+		);
+	}
 }
 
 void lone_lisp_table_set(struct lone_lisp *lone, struct lone_lisp_value table,
@@ -130,7 +214,8 @@ void lone_lisp_table_set(struct lone_lisp *lone, struct lone_lisp_value table,
 
 	is_new_table_entry = lone_lisp_table_entry_set(
 		lone,
-		actual->indexes,
+		lone_lisp_table_is_keyed_by_identity(table),
+		lone_lisp_table_indexes(actual->entries, actual->capacity),
 		actual->entries,
 		actual->capacity,
 		actual->count,
@@ -141,6 +226,9 @@ void lone_lisp_table_set(struct lone_lisp *lone, struct lone_lisp_value table,
 	if (is_new_table_entry) {
 		++actual->count;
 	}
+
+	lone_lisp_garbage_collector_write_barrier(lone, table, key);
+	lone_lisp_garbage_collector_write_barrier(lone, table, value);
 }
 
 struct lone_lisp_value lone_lisp_table_get(struct lone_lisp *lone,
@@ -152,11 +240,12 @@ struct lone_lisp_value lone_lisp_table_get(struct lone_lisp *lone,
 	size_t capacity, i;
 
 	actual = &table.as.heap_value->as.table;
-	indexes = actual->indexes;
 	entries = actual->entries;
 	capacity = actual->capacity;
+	indexes = lone_lisp_table_indexes(entries, capacity);
 
-	i = lone_lisp_table_entry_find_index_for(lone, key, indexes, entries, capacity);
+	i = lone_lisp_table_entry_find_index_for(lone, lone_lisp_table_is_keyed_by_identity(table),
+			key, indexes, entries, capacity);
 
 	if (indexes[i].used) {
 		return entries[indexes[i].index].value;
@@ -177,12 +266,13 @@ void lone_lisp_table_delete(struct lone_lisp *lone,
 	size_t i, j, k, l;
 
 	actual = &table.as.heap_value->as.table;
-	indexes = actual->indexes;
 	entries = actual->entries;
 	capacity = actual->capacity;
 	count = actual->count;
+	indexes = lone_lisp_table_indexes(entries, capacity);
 
-	i = lone_lisp_table_entry_find_index_for(lone, key, indexes, entries, capacity);
+	i = lone_lisp_table_entry_find_index_for(lone, lone_lisp_table_is_keyed_by_identity(table),
+			key, indexes, entries, capacity);
 
 	if (!indexes[i].used) { return; }
 
@@ -192,7 +282,8 @@ void lone_lisp_table_delete(struct lone_lisp *lone,
 	while (1) {
 		j = (j + 1) % capacity;
 		if (!indexes[j].used) { break; }
-		k = lone_lisp_table_compute_hash_for(lone, entries[indexes[j].index].key, capacity);
+		k = lone_lisp_table_compute_hash_for(lone, lone_lisp_table_is_keyed_by_identity(table),
+				entries[indexes[j].index].key, capacity);
 		if ((j > i && (k <= i || k > j)) || (j < i && (k <= i && k > j))) {
 			indexes[i].used = indexes[j].used;
 			indexes[i].index = indexes[j].index;
@@ -208,6 +299,10 @@ void lone_lisp_table_delete(struct lone_lisp *lone,
 		if (i >= l && i < count - 1) {
 			entries[i].key = entries[i + 1].key;
 			entries[i].value = entries[i + 1].value;
+
+			/* shifted entries may move behind a partially marked chunk */
+			lone_lisp_garbage_collector_write_barrier(lone, table, entries[i].key);
+			lone_lisp_garbage_collector_write_barrier(lone, table, entries[i].value);
 		}
 
 		if (indexes[i].used && indexes[i].index >= l) {
@@ -215,8 +310,9 @@ void lone_lisp_table_delete(struct lone_lisp *lone,
 		}
 	}
 
-	entries[count].key = lone_lisp_nil();
-	entries[count].value = lone_lisp_nil();
+	/* the indexes follow the entries: only the vacated entry may be cleared */
+	entries[count - 1].key = lone_lisp_nil();
+	entries[count - 1].value = lone_lisp_nil();
 
 	--actual->count;
 }
@@ -3,9 +3,13 @@
 #include <lone/lisp/value.h>
 #include <lone/lisp/value/vector.h>
 #include <lone/lisp/value/list.h>
+#include <lone/lisp/value/integer.h>
 #include <lone/lisp/heap.h>
+#include <lone/lisp/image.h>
+#include <lone/lisp/garbage_collector.h>
 
 #include <lone/memory/array.h>
+#include <lone/memory/functions.h>
 
 #include <lone/linux.h>
 
@@ -30,9 +34,19 @@ size_t lone_lisp_vector_count(struct lone_lisp_value vector)
 void lone_lisp_vector_resize(struct lone_lisp *lone, struct lone_lisp_value vector, size_t new_capacity)
 {
 	struct lone_lisp_vector *actual = &vector.as.heap_value->as.vector;
-
-	actual->capacity = new_capacity;
-	actual->values = lone_memory_array(lone->system, actual->values, actual->capacity, sizeof(*actual->values));
+	struct lone_lisp_value *values;
+
+	if (lone_lisp_image_contains(lone, actual->values)) {
+		/* values loaded from images are copied out of them */
+		values = lone_memory_array(lone->system, 0, new_capacity, sizeof(*values));
+		lone_memory_move(actual->values, values,
+				(actual->count < new_capacity? actual->count : new_capacity) * sizeof(*values));
+		actual->values = values;
+		actual->capacity = new_capacity;
+	} else {
+		actual->capacity = new_capacity;
+		actual->values = lone_memory_array(lone->system, actual->values, actual->capacity, sizeof(*actual->values));
+	}
 
 	if (actual->count > new_capacity) {
 		/* vector has shrunk, truncate count */
@@ -57,7 +71,7 @@ struct lone_lisp_value lone_lisp_vector_get(struct lone_lisp *lone,
 		struct lone_lisp_value vector, struct lone_lisp_value index)
 {
 	if (!lone_lisp_is_integer(index)) { /* only integer indexes supported */ linux_exit(-1); }
-	return lone_lisp_vector_get_value_at(vector, index.as.integer);
+	return lone_lisp_vector_get_value_at(vector, lone_lisp_integer_of(index));
 }
 
 void lone_lisp_vector_set_value_at(struct lone_lisp *lone, struct lone_lisp_value vector,
@@ -72,14 +86,16 @@ void lone_lisp_vector_set_value_at(struct lone_lisp *lone, struct lone_lisp_valu
 	}
 
 	actual->values[i] = value;
-	if (++i > actual->count) { actual->count = i; }
+	if (i >= actual->count) { actual->count = i + 1; }
+
+	lone_lisp_garbage_collector_write_barrier_at(lone, vector, i, value);
 }
 
 void lone_lisp_vector_set(struct lone_lisp *lone, struct lone_lisp_value vector,
 		struct lone_lisp_value index, struct lone_lisp_value value)
 {
 	if (!lone_lisp_is_integer(index)) { /* only integer indexes supported */ linux_exit(-1); }
-	lone_lisp_vector_set_value_at(lone, vector, index.as.integer, value);
+	lone_lisp_vector_set_value_at(lone, vector, lone_lisp_integer_of(index), value);
 }
 
 void lone_lisp_vector_push(struct lone_lisp *lone,
@@ -112,8 +128,20 @@ void lone_lisp_vector_push_all(struct lone_lisp *lone,
 
 struct lone_lisp_value lone_lisp_vector_build(struct lone_lisp *lone, size_t count, ...)
 {
-	struct lone_lisp_value vector = lone_lisp_vector_create(lone, count);
+	struct lone_lisp_value vector;
 	va_list arguments;
+	size_t roots, i;
+
+	roots = lone_lisp_roots_save(lone);
+
+	va_start(arguments, count);
+	for (i = 0; i < count; ++i) {
+		lone_lisp_root(lone, va_arg(arguments, struct lone_lisp_value *));
+	}
+	va_end(arguments);
+
+	vector = lone_lisp_vector_create(lone, count);
+	lone_lisp_roots_restore(lone, roots);
 
 	va_start(arguments, count);
 	lone_lisp_vector_push_va_list(lone, vector, count, arguments);
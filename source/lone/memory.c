@@ -3,11 +3,31 @@
 #include <lone/definitions.h>
 #include <lone/types.h>
 #include <lone/memory.h>
+#include <lone/memory/arena.h>
+#include <lone/memory/functions.h>
 
-void lone_memory_initialize(struct lone_system *system, struct lone_bytes initial_static_memory)
+void lone_memory_initialize(struct lone_system *system, struct lone_bytes initial_static_memory, size_t page_size)
 {
-	system->memory = (struct lone_memory *) __builtin_assume_aligned(initial_static_memory.pointer, LONE_ALIGNMENT);
-	system->memory->prev = system->memory->next = 0;
-	system->memory->free = 1;
-	system->memory->size = initial_static_memory.count - sizeof(struct lone_memory);
+	system->memory.blocks = 0;
+	system->memory.arenas = 0;
+	system->memory.free.occupied = 0;
+	lone_memory_zero(&system->memory.statistics, sizeof(system->memory.statistics));
+	system->memory.page_size = page_size? page_size : LONE_MEMORY_PAGE_SIZE;
+	system->memory.huge_pages = LONE_MEMORY_HUGE_PAGES;
+	system->memory.reclaim.function = 0;
+	system->memory.reclaim.context = 0;
+	system->memory.sampler.allocated = 0;
+	system->memory.sampler.deallocated = 0;
+	system->memory.sampler.context = 0;
+	system->memory.sampler.interval = 0;
+	system->memory.sampler.countdown = 0;
+	system->memory.sampler.random = 0;
+	system->memory.threads = 0;
+	system->memory.lock = 0;
+
+	for (size_t i = 0; i < LONE_MEMORY_SIZE_CLASSES; ++i) {
+		system->memory.free.lists[i] = 0;
+	}
+
+	lone_memory_arena_initialize(system, initial_static_memory, false);
 }
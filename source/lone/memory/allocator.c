@@ -4,6 +4,7 @@
 #include <lone/types.h>
 #include <lone/linux.h>
 #include <lone/memory/allocator.h>
+#include <lone/memory/arena.h>
 #include <lone/memory/functions.h>
 #include <lone/utilities.h>
 
@@ -25,52 +26,322 @@ size_t __attribute__((const)) lone_align(size_t size, size_t alignment)
 	return lone_next_power_of_2_multiple(size, alignment);
 }
 
-static void lone_memory_split(struct lone_memory *block, size_t used)
+/* the lock is only taken while other threads may be allocating, the count never changes under it */
+static void lone_memory_lock(struct lone_system *system)
+{
+	if (!system->memory.threads) { return; }
+
+	while (__atomic_exchange_n(&system->memory.lock, 1, __ATOMIC_ACQUIRE)) {
+		linux_sched_yield();
+	}
+}
+
+static void lone_memory_unlock(struct lone_system *system)
+{
+	if (!system->memory.threads) { return; }
+
+	__atomic_store_n(&system->memory.lock, 0, __ATOMIC_RELEASE);
+}
+
+static size_t __attribute__((const)) lone_memory_size_class(size_t size)
+{
+	size_t class, exact_limit = LONE_MEMORY_EXACT_SIZE_CLASSES * LONE_ALIGNMENT;
+
+	if (size <= exact_limit) {
+		return size? (size - 1) / LONE_ALIGNMENT : 0;
+	}
+
+	/* classes beyond the exact limit span powers of two */
+	class = LONE_MEMORY_EXACT_SIZE_CLASSES
+	      + (__builtin_clzl(exact_limit) - __builtin_clzl(size));
+
+	return lone_min(class, LONE_MEMORY_SIZE_CLASSES - 1);
+}
+
+static void lone_memory_free_list_insert(struct lone_system *system, struct lone_memory *block)
+{
+	size_t class = lone_memory_size_class(block->size);
+	struct lone_memory *head = system->memory.free.lists[class];
+
+	block->prev_free = 0;
+	block->next_free = head;
+	if (head) { head->prev_free = block; }
+
+	system->memory.free.lists[class] = block;
+	system->memory.free.occupied |= 1UL << class;
+
+	system->memory.statistics.free.blocks += 1;
+	system->memory.statistics.free.bytes += block->size;
+}
+
+static void lone_memory_free_list_remove(struct lone_system *system, struct lone_memory *block)
+{
+	size_t class = lone_memory_size_class(block->size);
+
+	if (block->prev_free) {
+		block->prev_free->next_free = block->next_free;
+	} else {
+		system->memory.free.lists[class] = block->next_free;
+		if (!block->next_free) { system->memory.free.occupied &= ~(1UL << class); }
+	}
+
+	if (block->next_free) { block->next_free->prev_free = block->prev_free; }
+
+	block->prev_free = block->next_free = 0;
+
+	system->memory.statistics.free.blocks -= 1;
+	system->memory.statistics.free.bytes -= block->size;
+}
+
+static struct lone_memory *lone_memory_free_list_search(struct lone_system *system, size_t size)
+{
+	size_t class = lone_memory_size_class(size);
+	unsigned long larger;
+	struct lone_memory *block;
+
+	if (class < LONE_MEMORY_EXACT_SIZE_CLASSES) {
+		/* every block in an exact size class fits */
+		block = system->memory.free.lists[class];
+		if (block) { return block; }
+	} else {
+		/* blocks in the same range may still be too small */
+		for (block = system->memory.free.lists[class]; block; block = block->next_free) {
+			if (block->size >= size) { return block; }
+		}
+	}
+
+	/* any block in a larger size class fits */
+	larger = system->memory.free.occupied & ~((2UL << class) - 1);
+	if (!larger) { return 0; }
+
+	return system->memory.free.lists[__builtin_ctzl(larger)];
+}
+
+static void lone_memory_split(struct lone_system *system, struct lone_memory *block, size_t used)
 {
 	size_t excess = block->size - used;
 
-	/* split block if there's enough space to allocate at least 1 byte */
-	if (excess >= sizeof(struct lone_memory) + 1) {
+	/* split block if there's enough space to allocate at least one aligned unit */
+	if (excess >= sizeof(struct lone_memory) + LONE_ALIGNMENT) {
 		struct lone_memory *new = (struct lone_memory *) __builtin_assume_aligned(block->pointer + used, LONE_ALIGNMENT);
 		new->next = block->next;
 		new->prev = block;
-		new->free = 1;
+		new->free = true;
+		new->mapped = false;
 		new->size = excess - sizeof(struct lone_memory);
+		if (new->next) { new->next->prev = new; }
 		block->next = new;
-		block->size -= excess + sizeof(struct lone_memory);
+		block->size = used;
+		lone_memory_release(system, new);
+		/* pages of the rest of a trimmed block are still returned */
+		new->trimmed = block->trimmed;
 	}
 }
 
+static bool lone_memory_is_adjacent(struct lone_memory *block, struct lone_memory *next)
+{
+	return block->pointer + block->size == (unsigned char *) next;
+}
+
+static bool lone_memory_can_coalesce(struct lone_memory *block, struct lone_memory *next)
+{
+	/* blocks in different arenas are linked but not contiguous */
+	return block && next && block->free && next->free && lone_memory_is_adjacent(block, next);
+}
+
 static void lone_memory_coalesce(struct lone_memory *block)
 {
-	struct lone_memory *next;
+	struct lone_memory *next = block->next;
+
+	block->size += next->size + sizeof(struct lone_memory);
+	next = block->next = next->next;
+	if (next) { next->prev = block; }
+}
+
+void lone_memory_release(struct lone_system *system, struct lone_memory *block)
+{
+	block->free = true;
+	block->trimmed = false;
+
+	if (lone_memory_can_coalesce(block, block->next)) {
+		lone_memory_free_list_remove(system, block->next);
+		lone_memory_coalesce(block);
+	}
+
+	if (lone_memory_can_coalesce(block->prev, block)) {
+		block = block->prev;
+		lone_memory_free_list_remove(system, block);
+		lone_memory_coalesce(block);
+		block->trimmed = false;
+	}
+
+	lone_memory_free_list_insert(system, block);
+}
+
+static size_t lone_memory_needed_size(size_t requested_size, size_t alignment)
+{
+	size_t needed_size;
+
+	if (alignment < LONE_ALIGNMENT) { alignment = LONE_ALIGNMENT; }
+	needed_size = lone_align(requested_size, alignment);
+	if (!needed_size) { needed_size = alignment; }
+
+	return needed_size;
+}
+
+static bool lone_memory_grow_in_place(struct lone_system *system, struct lone_memory *block, size_t needed_size)
+{
+	struct lone_memory *next = block->next;
+	size_t old_size = block->size;
+
+	if (!next || !next->free || !lone_memory_is_adjacent(block, next)) { return false; }
+	if (block->size + sizeof(struct lone_memory) + next->size < needed_size) { return false; }
+
+	/* absorb the free neighbor and give back whatever is left over */
+	lone_memory_free_list_remove(system, next);
+	lone_memory_coalesce(block);
+	lone_memory_split(system, block, needed_size);
+
+	lone_memory_zero(block->pointer + old_size, block->size - old_size);
+
+	return true;
+}
+
+static void lone_memory_shrink_in_place(struct lone_system *system, struct lone_memory *block, size_t needed_size, size_t requested_size)
+{
+	lone_memory_split(system, block, needed_size);
+	lone_memory_zero(block->pointer + requested_size, block->size - requested_size);
+}
+
+static bool lone_memory_is_large(size_t size)
+{
+	return size >= LONE_MEMORY_LARGE_SIZE;
+}
+
+static size_t lone_memory_mapped_size(struct lone_system *system, size_t size)
+{
+	return lone_align(sizeof(struct lone_memory) + size, system->memory.page_size);
+}
+
+static struct lone_memory *lone_memory_map(struct lone_system *system, size_t size)
+{
+	struct lone_memory *block;
+	intptr_t memory;
+
+	memory = linux_mmap(0, lone_memory_mapped_size(system, size), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (memory < 0 && lone_memory_reclaim(system)) {
+		memory = linux_mmap(0, lone_memory_mapped_size(system, size), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	}
+	if (memory < 0) { /* out of memory */ linux_exit(-1); }
+
+	/* anonymous mappings are zero filled */
+	block = (struct lone_memory *) memory;
+	block->prev = block->next = 0;
+	block->prev_free = block->next_free = 0;
+	block->free = false;
+	block->mapped = true;
+	block->trimmed = false;
+	block->size = size;
+
+	system->memory.statistics.mapped += lone_memory_mapped_size(system, size);
+
+	return block;
+}
+
+static struct lone_memory *lone_memory_remap(struct lone_system *system, struct lone_memory *block, size_t size)
+{
+	size_t old_size, new_size;
+	intptr_t memory;
 
-	if (block && block->free) {
-		next = block->next;
-		if (next && next->free) {
-			block->size += next->size + sizeof(struct lone_memory);
-			next = block->next = next->next;
-			if (next) { next->prev = block; }
+	old_size = lone_memory_mapped_size(system, block->size);
+	new_size = lone_memory_mapped_size(system, size);
+
+	if (new_size != old_size) {
+		memory = linux_mremap(block, old_size, new_size, MREMAP_MAYMOVE);
+		if (memory < 0 && lone_memory_reclaim(system)) {
+			memory = linux_mremap(block, old_size, new_size, MREMAP_MAYMOVE);
 		}
+		if (memory < 0) { /* out of memory */ linux_exit(-1); }
+		block = (struct lone_memory *) memory;
+		system->memory.statistics.mapped += new_size - old_size;
+	}
+
+	block->size = size;
+
+	return block;
+}
+
+static void lone_memory_unmap(struct lone_system *system, struct lone_memory *block)
+{
+	system->memory.statistics.mapped -= lone_memory_mapped_size(system, block->size);
+	linux_munmap(block, lone_memory_mapped_size(system, block->size));
+}
+
+static size_t lone_memory_alignment_padding(size_t alignment)
+{
+	/* room for the largest gap between a block and the aligned address after it */
+	return alignment > LONE_ALIGNMENT? alignment + sizeof(struct lone_memory) + LONE_ALIGNMENT : 0;
+}
+
+static struct lone_memory *lone_memory_align(struct lone_system *system, struct lone_memory *block, size_t alignment)
+{
+	struct lone_memory *aligned;
+	unsigned char *pointer;
+
+	pointer = (unsigned char *) lone_align((uintptr_t) block->pointer, alignment);
+	if (pointer == block->pointer) { return block; }
+
+	/* the memory before the aligned address must hold a free block of its own */
+	while ((size_t) (pointer - block->pointer) < sizeof(struct lone_memory) + LONE_ALIGNMENT) {
+		pointer += alignment;
 	}
+
+	aligned = ((struct lone_memory *) __builtin_assume_aligned(pointer, LONE_ALIGNMENT)) - 1;
+	aligned->next = block->next;
+	aligned->prev = block;
+	aligned->prev_free = aligned->next_free = 0;
+	aligned->free = false;
+	aligned->mapped = false;
+	aligned->trimmed = block->trimmed;
+	aligned->size = block->size - (size_t) (pointer - block->pointer);
+	if (aligned->next) { aligned->next->prev = aligned; }
+	block->next = aligned;
+	block->size = (size_t) ((unsigned char *) aligned - block->pointer);
+	lone_memory_release(system, block);
+
+	return aligned;
 }
 
 static struct lone_memory * lone_memory_find_free_block(struct lone_system *system, size_t requested_size, size_t alignment)
 {
-	size_t needed_size = requested_size + sizeof(struct lone_memory);
+	size_t needed_size, padding;
 	struct lone_memory *block;
 
-	needed_size = lone_align(needed_size, alignment);
+	/* addresses are aligned, sizes only need to be multiples of the minimum alignment */
+	needed_size = lone_memory_needed_size(requested_size, LONE_ALIGNMENT);
+	padding = lone_memory_alignment_padding(alignment);
 
-	for (block = system->memory; block; block = block->next) {
-		if (block->free && block->size >= needed_size)
-			break;
+	lone_memory_lock(system);
+
+	if (!padding && lone_memory_is_large(needed_size)) {
+		block = lone_memory_map(system, needed_size);
+	} else {
+		block = lone_memory_free_list_search(system, needed_size + padding);
+		if (!block) { block = lone_memory_arena_map(system, needed_size + padding); }
+
+		lone_memory_free_list_remove(system, block);
+		block->free = false;
+		block = lone_memory_align(system, block, alignment);
+		lone_memory_split(system, block, needed_size);
+		block->trimmed = false;
 	}
 
-	if (!block) { linux_exit(-1); }
+	block->sampled = false;
+
+	system->memory.statistics.allocations += 1;
+	system->memory.statistics.allocated += block->size;
 
-	block->free = 0;
-	lone_memory_split(block, needed_size);
+	lone_memory_unlock(system);
 
 	return block;
 }
@@ -78,7 +349,7 @@ static struct lone_memory * lone_memory_find_free_block(struct lone_system *syst
 void * lone_allocate_aligned(struct lone_system *system, size_t requested_size, size_t alignment)
 {
 	struct lone_memory *block = lone_memory_find_free_block(system, requested_size, alignment);
-	lone_memory_zero(block->pointer, block->size);
+	if (!block->mapped) { lone_memory_zero(block->pointer, block->size); }
 	return block->pointer;
 }
 
@@ -86,38 +357,235 @@ void * lone_allocate_aligned_uninitialized(struct lone_system *system, size_t re
 {
 	struct lone_memory *block = lone_memory_find_free_block(system, requested_size, alignment);
 	/* zero fill any extra memory allocated due to alignment requirements */
-	lone_memory_zero(block->pointer + requested_size, block->size - requested_size);
+	if (!block->mapped) { lone_memory_zero(block->pointer + requested_size, block->size - requested_size); }
 	return block->pointer;
 }
 
+/* a sample is taken whenever the bytes allocated since the last one reach a random interval */
+static void *lone_memory_sample(struct lone_system *system, void *pointer)
+{
+	struct lone_memory *block = ((struct lone_memory *) pointer) - 1;
+	bool due;
+
+	if (!system->memory.sampler.interval) { return pointer; }
+
+	lone_memory_lock(system);
+
+	due = block->size >= system->memory.sampler.countdown;
+
+	if (due) {
+		system->memory.sampler.countdown = lone_random_interval(&system->memory.sampler.random,
+				system->memory.sampler.interval);
+	} else {
+		system->memory.sampler.countdown -= block->size;
+	}
+
+	lone_memory_unlock(system);
+
+	/* the sampler may allocate memory of its own */
+	if (due) {
+		block->sampled = system->memory.sampler.allocated(system->memory.sampler.context, pointer, block->size);
+	}
+
+	return pointer;
+}
+
 void * lone_allocate(struct lone_system *system, size_t requested_size)
 {
-	return lone_allocate_aligned(system, requested_size, LONE_ALIGNMENT);
+	return lone_memory_sample(system, lone_allocate_aligned(system, requested_size, LONE_ALIGNMENT));
 }
 
 void * lone_allocate_uninitialized(struct lone_system *system, size_t requested_size)
 {
-	return lone_allocate_aligned_uninitialized(system, requested_size, LONE_ALIGNMENT);
+	return lone_memory_sample(system, lone_allocate_aligned_uninitialized(system, requested_size, LONE_ALIGNMENT));
 }
 
 void * lone_reallocate(struct lone_system *system, void *pointer, size_t size)
 {
-	struct lone_memory *old = ((struct lone_memory *) pointer) - 1,
-	                   *new = ((struct lone_memory *) lone_allocate(system, size)) - 1;
+	struct lone_memory *old, *new;
+	size_t needed_size, old_size;
+
+	if (!pointer) { return lone_allocate(system, size); }
+
+	old = ((struct lone_memory *) pointer) - 1;
+	needed_size = lone_memory_needed_size(size, LONE_ALIGNMENT);
+
+	if (old->mapped && lone_memory_is_large(needed_size)) {
+		/* remapped blocks may move, their samples are forgotten */
+		if (old->sampled) {
+			system->memory.sampler.deallocated(system->memory.sampler.context, pointer);
+			old->sampled = false;
+		}
+
+		old_size = old->size;
+		lone_memory_lock(system);
+		new = lone_memory_remap(system, old, needed_size);
+		system->memory.statistics.allocated -= old_size;
+		system->memory.statistics.allocated += new->size;
+		lone_memory_unlock(system);
+		/* pages gained by remapping are zero filled by Linux, shrinking leaves stale data */
+		if (size < old_size) {
+			old_size = lone_min(old_size, lone_memory_mapped_size(system, needed_size) - sizeof(struct lone_memory));
+			lone_memory_zero(new->pointer + size, old_size - size);
+		}
+		return new->pointer;
+	}
 
-	if (pointer) {
-		lone_memory_move(old->pointer, new->pointer, lone_min(old->size, new->size));
+	if (old->mapped) {
+		/* shrunk below the large size, move it back into the heap */
+		new = ((struct lone_memory *) lone_allocate(system, size)) - 1;
+		lone_memory_move(old->pointer, new->pointer, size);
 		lone_deallocate(system, pointer);
+		return new->pointer;
 	}
 
+	old_size = old->size;
+
+	lone_memory_lock(system);
+
+	if (needed_size <= old->size) {
+		lone_memory_shrink_in_place(system, old, needed_size, size);
+		system->memory.statistics.allocated -= old_size - old->size;
+		lone_memory_unlock(system);
+		return old->pointer;
+	}
+
+	if (!lone_memory_is_large(needed_size) && lone_memory_grow_in_place(system, old, needed_size)) {
+		system->memory.statistics.allocated += old->size - old_size;
+		lone_memory_unlock(system);
+		return old->pointer;
+	}
+
+	lone_memory_unlock(system);
+
+	new = ((struct lone_memory *) lone_allocate(system, size)) - 1;
+	lone_memory_move(old->pointer, new->pointer, old->size);
+	lone_deallocate(system, pointer);
+
 	return new->pointer;
 }
 
 void lone_deallocate(struct lone_system *system, void *pointer)
 {
 	struct lone_memory *block = ((struct lone_memory *) pointer) - 1;
-	block->free = 1;
 
-	lone_memory_coalesce(block);
-	lone_memory_coalesce(block->prev);
+	if (block->sampled) {
+		system->memory.sampler.deallocated(system->memory.sampler.context, pointer);
+	}
+
+	lone_memory_lock(system);
+
+	system->memory.statistics.deallocations += 1;
+	system->memory.statistics.allocated -= block->size;
+
+	if (block->mapped) {
+		lone_memory_unmap(system, block);
+	} else {
+		lone_memory_release(system, block);
+	}
+
+	lone_memory_unlock(system);
+}
+
+size_t lone_memory_largest_free_block(struct lone_system *system)
+{
+	unsigned long occupied;
+	struct lone_memory *block;
+	size_t largest = 0;
+
+	lone_memory_lock(system);
+
+	occupied = system->memory.free.occupied;
+
+	/* the largest block is in the highest occupied size class */
+	if (occupied) {
+		for (block = system->memory.free.lists[(8 * sizeof(occupied) - 1) - __builtin_clzl(occupied)];
+		     block; block = block->next_free) {
+			if (block->size > largest) { largest = block->size; }
+		}
+	}
+
+	lone_memory_unlock(system);
+
+	return largest;
+}
+
+static bool lone_memory_spans_arena(struct lone_memory *block)
+{
+	/* blocks tile their arenas, only the sole block has no adjacent neighbors */
+	return !(block->prev && lone_memory_is_adjacent(block->prev, block))
+	    && !(block->next && lone_memory_is_adjacent(block, block->next));
+}
+
+static void lone_memory_unmap_arena(struct lone_system *system, struct lone_memory *block)
+{
+	lone_memory_free_list_remove(system, block);
+
+	if (block->prev) {
+		block->prev->next = block->next;
+	} else {
+		system->memory.blocks = block->next;
+	}
+
+	if (block->next) { block->next->prev = block->prev; }
+
+	lone_memory_arena_unmap(system, ((struct lone_memory_arena *) block) - 1);
+}
+
+static void lone_memory_discard(struct lone_system *system, struct lone_memory *block)
+{
+	uintptr_t start, end;
+	size_t granularity;
+
+	/* discarding part of a huge page would split it */
+	granularity = system->memory.huge_pages? LONE_MEMORY_HUGE_PAGE_SIZE : system->memory.page_size;
+
+	start = lone_align((uintptr_t) block->pointer, granularity);
+	end = ((uintptr_t) block->pointer + block->size) & ~(granularity - 1);
+
+	if (end > start) {
+		linux_madvise((void *) start, end - start, MADV_DONTNEED);
+		system->memory.statistics.trimmed += end - start;
+	}
+
+	block->trimmed = true;
+}
+
+void lone_memory_trim(struct lone_system *system)
+{
+	struct lone_memory *block, *next;
+	unsigned long occupied;
+
+	lone_memory_lock(system);
+
+	/* only size classes which may contain blocks large enough to trim */
+	occupied = system->memory.free.occupied & ~((1UL << lone_memory_size_class(LONE_MEMORY_TRIM_SIZE)) - 1);
+
+	for (/* occupied */; occupied; occupied &= occupied - 1) {
+		for (block = system->memory.free.lists[__builtin_ctzl(occupied)]; block; block = next) {
+			next = block->next_free;
+
+			if (block->trimmed || block->size < LONE_MEMORY_TRIM_SIZE) { continue; }
+
+			if (lone_memory_spans_arena(block) && (((struct lone_memory_arena *) block) - 1)->mapped) {
+				lone_memory_unmap_arena(system, block);
+			} else {
+				lone_memory_discard(system, block);
+			}
+		}
+	}
+
+	lone_memory_unlock(system);
+}
+
+/* reclaiming may wait for the other threads, which may need the allocator to finish */
+bool lone_memory_reclaim(struct lone_system *system)
+{
+	if (!system->memory.reclaim.function) { return false; }
+
+	lone_memory_unlock(system);
+	system->memory.reclaim.function(system->memory.reclaim.context);
+	lone_memory_lock(system);
+
+	return true;
 }
@@ -0,0 +1,91 @@
+/* SPDX-License-Identifier: AGPL-3.0-or-later */
+
+#include <lone/memory/arena.h>
+#include <lone/memory/allocator.h>
+#include <lone/linux.h>
+
+struct lone_memory *lone_memory_arena_initialize(struct lone_system *system, struct lone_bytes memory, bool mapped)
+{
+	struct lone_memory_arena *arena;
+	struct lone_memory *block;
+
+	arena = (struct lone_memory_arena *) __builtin_assume_aligned(memory.pointer, LONE_ALIGNMENT);
+	arena->size = memory.count;
+	arena->mapped = mapped;
+	arena->next = system->memory.arenas;
+	system->memory.arenas = arena;
+
+	block = (struct lone_memory *) __builtin_assume_aligned(arena + 1, LONE_ALIGNMENT);
+	block->prev = 0;
+	block->next = system->memory.blocks;
+	block->prev_free = block->next_free = 0;
+	block->free = true;
+	block->mapped = false;
+	block->trimmed = false;
+	block->size = memory.count - sizeof(struct lone_memory_arena) - sizeof(struct lone_memory);
+
+	if (block->next) { block->next->prev = block; }
+	system->memory.blocks = block;
+
+	system->memory.statistics.arenas += 1;
+	lone_memory_release(system, block);
+
+	return block;
+}
+
+/* maps extra memory so that an aligned region fits and unmaps the excess on both sides */
+static intptr_t lone_memory_arena_map_aligned(struct lone_system *system, size_t size, size_t alignment)
+{
+	size_t mapped_size = size + alignment - system->memory.page_size;
+	uintptr_t memory, aligned, end;
+	intptr_t result;
+
+	result = linux_mmap(0, mapped_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (result < 0 && lone_memory_reclaim(system)) {
+		result = linux_mmap(0, mapped_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	}
+	if (result < 0) { /* out of memory */ linux_exit(-1); }
+
+	memory = (uintptr_t) result;
+	aligned = lone_align(memory, alignment);
+	end = memory + mapped_size;
+
+	if (aligned > memory) { linux_munmap((void *) memory, aligned - memory); }
+	if (end > aligned + size) { linux_munmap((void *) (aligned + size), end - (aligned + size)); }
+
+	return (intptr_t) aligned;
+}
+
+struct lone_memory *lone_memory_arena_map(struct lone_system *system, size_t minimum_size)
+{
+	size_t size, alignment;
+	intptr_t memory;
+
+	alignment = system->memory.huge_pages? LONE_MEMORY_HUGE_PAGE_SIZE : system->memory.page_size;
+
+	size = minimum_size + sizeof(struct lone_memory_arena) + sizeof(struct lone_memory);
+	if (size < LONE_MEMORY_ARENA_SIZE) { size = LONE_MEMORY_ARENA_SIZE; }
+	size = lone_align(size, alignment);
+
+	memory = lone_memory_arena_map_aligned(system, size, alignment);
+
+	/* transparent huge pages might be disabled, the arena works either way */
+	if (system->memory.huge_pages) { linux_madvise((void *) memory, size, MADV_HUGEPAGE); }
+
+	system->memory.statistics.mapped += size;
+
+	return lone_memory_arena_initialize(system, LONE_BYTES_VALUE(size, memory), true);
+}
+
+void lone_memory_arena_unmap(struct lone_system *system, struct lone_memory_arena *arena)
+{
+	struct lone_memory_arena **link;
+
+	for (link = &system->memory.arenas; *link != arena; link = &(*link)->next);
+	*link = arena->next;
+
+	system->memory.statistics.arenas -= 1;
+	system->memory.statistics.mapped -= arena->size;
+
+	linux_munmap(arena, arena->size);
+}
@@ -2,10 +2,49 @@
 
 #include <lone/memory/functions.h>
 
+/* ╭────────────────────────────────────────────────────────────────────────╮
+   │                                                                        │
+   │    Memory functions process data one machine word at a time.           │
+   │    Architecture-specific vector kernels are tried first on bulk        │
+   │    data: they process as many whole vectors as they can and return     │
+   │    the number of bytes they handled. Words and then single bytes       │
+   │    take care of whatever is left.                                      │
+   │                                                                        │
+   │    Words are accessed through a type that may alias anything and       │
+   │    may be unaligned, so callers need not align their pointers.         │
+   │                                                                        │
+   ╰────────────────────────────────────────────────────────────────────────╯ */
+
+typedef unsigned long __attribute__((may_alias, aligned(1))) lone_memory_word;
+typedef unsigned long __attribute__((may_alias)) lone_memory_aligned_word;
+
+#define LONE_MEMORY_WORD_SIZE sizeof(lone_memory_word)
+#define LONE_MEMORY_WORD_ONES (~0UL / 0xFF)
+#define LONE_MEMORY_WORD_HIGHS (LONE_MEMORY_WORD_ONES << 7)
+
+#include <lone/architecture/memory/functions.c>
+
+static size_t lone_memory_mismatch(unsigned char *p, unsigned char *q, size_t count)
+{
+	size_t i;
+
+	i = lone_memory_vector_mismatch(p, q, count);
+
+	for (; i + LONE_MEMORY_WORD_SIZE <= count; i += LONE_MEMORY_WORD_SIZE) {
+		if (*(lone_memory_word *) (p + i) != *(lone_memory_word *) (q + i)) { break; }
+	}
+
+	for (; i < count; ++i) {
+		if (p[i] != q[i]) { break; }
+	}
+
+	return i;
+}
+
 int lone_memory_compare(void *a, void *b, size_t count)
 {
+	unsigned char *p, *q;
 	size_t i;
-	unsigned char *p, *q, x, y;
 
 	if (a == b || count == 0) {
 		return 0;
@@ -13,19 +52,9 @@ int lone_memory_compare(void *a, void *b, size_t count)
 
 	p = a;
 	q = b;
+	i = lone_memory_mismatch(p, q, count);
 
-	for (i = 0; i < count; ++i) {
-		x = p[i];
-		y = q[i];
-
-		if (x == y) {
-			continue;
-		}
-
-		return x - y;
-	}
-
-	return 0;
+	return i < count? p[i] - q[i] : 0;
 }
 
 bool lone_memory_is_equal(void *a, void *b, size_t count)
@@ -42,23 +71,59 @@ bool lone_memory_is_zero(void *x, size_t count)
 		return true;
 	}
 
-	for (i = 0, p = x; i < count; ++i) {
+	p = x;
+	i = lone_memory_vector_zero_prefix(p, count);
+
+	for (; i + LONE_MEMORY_WORD_SIZE <= count; i += LONE_MEMORY_WORD_SIZE) {
+		if (*(lone_memory_word *) (p + i)) { return false; }
+	}
+
+	for (; i < count; ++i) {
 		if (p[i]) { return false; }
 	}
 
 	return true;
 }
 
+/* ╭────────────────────────────────────────────────────────────────────────╮
+   │                                                                        │
+   │    Overlapping memory is moved safely by copying away from the         │
+   │    destination: every chunk is loaded before any store can reach it.   │
+   │                                                                        │
+   ╰────────────────────────────────────────────────────────────────────────╯ */
+
 void lone_memory_move(void *from, void *to, size_t count)
 {
 	unsigned char *source = from, *destination = to;
+	size_t copied;
+
+	if (source == destination || count == 0) {
+		return;
+	}
+
+	if (source > destination) {
+		/* destination is behind source, copy forwards */
+		copied = lone_memory_vector_copy_forwards(destination, source, count);
+		source += copied; destination += copied; count -= copied;
+
+		for (; count >= LONE_MEMORY_WORD_SIZE; count -= LONE_MEMORY_WORD_SIZE) {
+			*(lone_memory_word *) destination = *(lone_memory_word *) source;
+			source += LONE_MEMORY_WORD_SIZE; destination += LONE_MEMORY_WORD_SIZE;
+		}
 
-	if (source >= destination) {
-		/* destination is at or behind source, copy forwards */
 		while (count--) { *destination++ = *source++; }
 	} else {
 		/* destination is ahead of source, copy backwards */
 		source += count; destination += count;
+
+		copied = lone_memory_vector_copy_backwards(destination, source, count);
+		source -= copied; destination -= copied; count -= copied;
+
+		for (; count >= LONE_MEMORY_WORD_SIZE; count -= LONE_MEMORY_WORD_SIZE) {
+			source -= LONE_MEMORY_WORD_SIZE; destination -= LONE_MEMORY_WORD_SIZE;
+			*(lone_memory_word *) destination = *(lone_memory_word *) source;
+		}
+
 		while (count--) { *--destination = *--source; }
 	}
 }
@@ -66,9 +131,16 @@ void lone_memory_move(void *from, void *to, size_t count)
 void lone_memory_set(void *to, unsigned char byte, size_t count)
 {
 	unsigned char *memory = to;
+	unsigned long word = LONE_MEMORY_WORD_ONES * byte;
 	size_t i;
 
-	for (i = 0; i < count; ++i) {
+	i = lone_memory_vector_set(memory, byte, count);
+
+	for (; i + LONE_MEMORY_WORD_SIZE <= count; i += LONE_MEMORY_WORD_SIZE) {
+		*(lone_memory_word *) (memory + i) = word;
+	}
+
+	for (; i < count; ++i) {
 		memory[i] = byte;
 	}
 }
@@ -78,12 +150,37 @@ void lone_memory_zero(void *to, size_t count)
 	lone_memory_set(to, 0, count);
 }
 
+/* ╭────────────────────────────────────────────────────────────────────────╮
+   │                                                                        │
+   │    The string is scanned one aligned word at a time. Aligned words     │
+   │    never cross a page boundary, so reading past the terminator is      │
+   │    harmless. A word contains a zero byte exactly when subtracting      │
+   │    one from each of its bytes borrows into a byte whose high bit       │
+   │    was not already set.                                                │
+   │                                                                        │
+   ╰────────────────────────────────────────────────────────────────────────╯ */
+
+static bool lone_memory_word_has_zero(unsigned long word)
+{
+	return (word - LONE_MEMORY_WORD_ONES) & ~word & LONE_MEMORY_WORD_HIGHS;
+}
+
 size_t lone_c_string_length(char *c_string)
 {
-	size_t length = 0;
+	lone_memory_aligned_word *word;
+	char *c;
+
 	if (!c_string) { return 0; }
-	while (c_string[length++]);
-	return length - 1;
+
+	for (c = c_string; (unsigned long) c % LONE_MEMORY_WORD_SIZE; ++c) {
+		if (!*c) { return (size_t) (c - c_string); }
+	}
+
+	for (word = (lone_memory_aligned_word *) c; !lone_memory_word_has_zero(*word); ++word);
+
+	for (c = (char *) word; *c; ++c);
+
+	return (size_t) (c - c_string);
 }
 
 /* Compilers emit calls to mem* functions even with -nostdlib */
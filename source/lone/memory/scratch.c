@@ -0,0 +1,111 @@
+/* SPDX-License-Identifier: AGPL-3.0-or-later */
+
+#include <lone/memory/scratch.h>
+#include <lone/memory/allocator.h>
+#include <lone/memory/functions.h>
+#include <lone/utilities.h>
+
+void lone_memory_scratch_initialize(struct lone_memory_scratch *scratch,
+		struct lone_system *system, size_t chunk_size)
+{
+	scratch->system = system;
+	scratch->chunks = 0;
+	scratch->chunk_size = chunk_size? lone_align(chunk_size, LONE_ALIGNMENT) : LONE_MEMORY_SCRATCH_SIZE;
+}
+
+static struct lone_memory_scratch_chunk *lone_memory_scratch_add_chunk(struct lone_memory_scratch *scratch, size_t size)
+{
+	struct lone_memory_scratch_chunk *chunk;
+
+	size = lone_max(size, scratch->chunk_size);
+	chunk = lone_allocate_uninitialized(scratch->system, sizeof(*chunk) + size);
+	chunk->size = size;
+	chunk->used = 0;
+	chunk->next = scratch->chunks;
+	scratch->chunks = chunk;
+	scratch->chunk_size = size * 2;
+
+	return chunk;
+}
+
+void * lone_memory_scratch_allocate_uninitialized(struct lone_memory_scratch *scratch, size_t size)
+{
+	struct lone_memory_scratch_chunk *chunk = scratch->chunks;
+	unsigned char *pointer;
+
+	size = lone_align(size? size : 1, LONE_ALIGNMENT);
+
+	if (!chunk || chunk->size - chunk->used < size) {
+		chunk = lone_memory_scratch_add_chunk(scratch, size);
+	}
+
+	pointer = chunk->pointer + chunk->used;
+	chunk->used += size;
+
+	return pointer;
+}
+
+void * lone_memory_scratch_allocate(struct lone_memory_scratch *scratch, size_t size)
+{
+	void *pointer = lone_memory_scratch_allocate_uninitialized(scratch, size);
+	lone_memory_zero(pointer, size);
+	return pointer;
+}
+
+void * lone_memory_scratch_reallocate(struct lone_memory_scratch *scratch, void *pointer, size_t old_size, size_t new_size)
+{
+	struct lone_memory_scratch_chunk *chunk = scratch->chunks;
+	unsigned char *bytes = pointer, *new;
+	size_t offset;
+
+	if (!pointer) { return lone_memory_scratch_allocate(scratch, new_size); }
+
+	old_size = lone_align(old_size? old_size : 1, LONE_ALIGNMENT);
+
+	/* the most recent allocation can be resized by moving the bump pointer */
+	if (chunk && bytes + old_size == chunk->pointer + chunk->used) {
+		offset = (size_t) (bytes - chunk->pointer);
+
+		if (new_size <= chunk->size - offset) {
+			chunk->used = offset + lone_align(new_size? new_size : 1, LONE_ALIGNMENT);
+			if (new_size > old_size) { lone_memory_zero(bytes + old_size, new_size - old_size); }
+			return pointer;
+		}
+	}
+
+	if (new_size <= old_size) { return pointer; }
+
+	new = lone_memory_scratch_allocate(scratch, new_size);
+	lone_memory_move(bytes, new, old_size);
+
+	return new;
+}
+
+static void lone_memory_scratch_deallocate_chunks(struct lone_memory_scratch *scratch,
+		struct lone_memory_scratch_chunk *chunk)
+{
+	struct lone_memory_scratch_chunk *next;
+
+	for (; chunk; chunk = next) {
+		next = chunk->next;
+		lone_deallocate(scratch->system, chunk);
+	}
+}
+
+void lone_memory_scratch_reset(struct lone_memory_scratch *scratch)
+{
+	struct lone_memory_scratch_chunk *chunk = scratch->chunks;
+
+	if (!chunk) { return; }
+
+	/* keep only the largest chunk around for reuse */
+	lone_memory_scratch_deallocate_chunks(scratch, chunk->next);
+	chunk->next = 0;
+	chunk->used = 0;
+}
+
+void lone_memory_scratch_finalize(struct lone_memory_scratch *scratch)
+{
+	lone_memory_scratch_deallocate_chunks(scratch, scratch->chunks);
+	scratch->chunks = 0;
+}
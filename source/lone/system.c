@@ -4,8 +4,8 @@
 #include <lone/memory.h>
 #include <lone/hash.h>
 
-void lone_system_initialize(struct lone_system *system, struct lone_bytes initial_static_memory, struct lone_bytes random_bytes)
+void lone_system_initialize(struct lone_system *system, struct lone_bytes initial_static_memory, struct lone_bytes random_bytes, size_t page_size)
 {
-	lone_memory_initialize(system, initial_static_memory);
+	lone_memory_initialize(system, initial_static_memory, page_size);
 	lone_hash_initialize(system, random_bytes);
 }
@@ -11,3 +11,32 @@ long lone_max(long x, long y)
 {
 	if (x >= y) { return x; } else { return y; }
 }
+
+/* empty variables are treated as if they were not set */
+char *lone_environment_get(char **environment, char *name)
+{
+	char *variable, *character;
+
+	for (/* environment */; *environment; ++environment) {
+		for (variable = *environment, character = name; *character && *variable == *character; ++variable, ++character);
+
+		if (!*character && *variable == '=' && variable[1]) {
+			return variable + 1;
+		}
+	}
+
+	return 0;
+}
+
+/* xorshift, intervals are spread evenly between half and one and a half times the mean */
+size_t lone_random_interval(unsigned long *state, size_t mean)
+{
+	unsigned long x = *state? *state : 1;
+
+	x ^= x << 13;
+	x ^= x >> 7;
+	x ^= x << 17;
+	*state = x;
+
+	return mean / 2 + x % (mean + 1);
+}
@@ -0,0 +1,276 @@
+/* SPDX-License-Identifier: AGPL-3.0-or-later */
+
+#include <lone/types.h>
+#include <lone/memory.h>
+#include <lone/memory/allocator.h>
+#include <lone/memory/functions.h>
+
+#include <lone/test.h>
+
+static void initialize(struct lone_system *system)
+{
+	static unsigned char __attribute__((aligned(LONE_ALIGNMENT))) bytes[64 * 1024];
+	lone_memory_initialize(system, LONE_BYTES_VALUE(sizeof(bytes), bytes), 0);
+	system->memory.huge_pages = false;
+}
+
+static void fill(unsigned char *bytes, size_t count)
+{
+	for (size_t i = 0; i < count; ++i) { bytes[i] = (unsigned char) (i + 1); }
+}
+
+static bool is_filled(unsigned char *bytes, size_t count)
+{
+	for (size_t i = 0; i < count; ++i) { if (bytes[i] != (unsigned char) (i + 1)) { return false; } }
+	return true;
+}
+
+static LONE_TEST_FUNCTION(test_lone_memory_allocator_reuse)
+{
+	struct lone_system system;
+	void *a, *b;
+
+	initialize(&system);
+
+	a = lone_allocate(&system, 100);
+	lone_allocate(&system, 100);
+	lone_deallocate(&system, a);
+	b = lone_allocate(&system, 100);
+
+	lone_test_assert_true(suite, test, a == b);
+}
+
+static LONE_TEST_FUNCTION(test_lone_memory_allocator_reallocate_grow_in_place)
+{
+	struct lone_system system;
+	unsigned char *a, *b, *c;
+
+	initialize(&system);
+
+	a = lone_allocate(&system, 64);
+	b = lone_allocate(&system, 64);
+	lone_allocate(&system, 64);
+	lone_deallocate(&system, b);
+
+	fill(a, 64);
+	c = lone_reallocate(&system, a, 128);
+
+	lone_test_assert_true(suite, test, a == c);
+	lone_test_assert_true(suite, test, is_filled(c, 64));
+	lone_test_assert_true(suite, test, lone_memory_is_zero(c + 64, 64));
+}
+
+static LONE_TEST_FUNCTION(test_lone_memory_allocator_reallocate_grow_by_moving)
+{
+	struct lone_system system;
+	unsigned char *a, *c;
+
+	initialize(&system);
+
+	a = lone_allocate(&system, 64);
+	lone_allocate(&system, 64);
+
+	fill(a, 64);
+	c = lone_reallocate(&system, a, 256);
+
+	lone_test_assert_true(suite, test, a != c);
+	lone_test_assert_true(suite, test, is_filled(c, 64));
+	lone_test_assert_true(suite, test, lone_memory_is_zero(c + 64, 192));
+}
+
+static LONE_TEST_FUNCTION(test_lone_memory_allocator_reallocate_shrink_in_place)
+{
+	struct lone_system system;
+	unsigned char *a, *b, *c;
+
+	initialize(&system);
+
+	a = lone_allocate(&system, 256);
+	lone_allocate(&system, 64);
+
+	fill(a, 256);
+	b = lone_reallocate(&system, a, 32);
+	c = lone_allocate(&system, 64);
+
+	lone_test_assert_true(suite, test, a == b);
+	lone_test_assert_true(suite, test, is_filled(b, 32));
+	lone_test_assert_true(suite, test, c > b && c < a + 256);
+}
+
+static LONE_TEST_FUNCTION(test_lone_memory_allocator_large)
+{
+	struct lone_system system;
+	unsigned char *a, *b, *c;
+
+	initialize(&system);
+
+	a = lone_allocate(&system, LONE_MEMORY_LARGE_SIZE);
+	lone_test_assert_true(suite, test, lone_memory_is_zero(a, LONE_MEMORY_LARGE_SIZE));
+	fill(a, 256);
+
+	b = lone_reallocate(&system, a, 4 * LONE_MEMORY_LARGE_SIZE);
+	lone_test_assert_true(suite, test, is_filled(b, 256));
+	lone_test_assert_true(suite, test, lone_memory_is_zero(b + 256, 4 * LONE_MEMORY_LARGE_SIZE - 256));
+
+	c = lone_reallocate(&system, b, 64);
+	lone_test_assert_true(suite, test, is_filled(c, 64));
+
+	c = lone_reallocate(&system, c, 128);
+	lone_test_assert_true(suite, test, is_filled(c, 64));
+	lone_test_assert_true(suite, test, lone_memory_is_zero(c + 64, 64));
+
+	lone_deallocate(&system, c);
+}
+
+static LONE_TEST_FUNCTION(test_lone_memory_allocator_aligned)
+{
+	struct lone_system system;
+	unsigned char *a, *b;
+	size_t largest;
+
+	initialize(&system);
+
+	a = lone_allocate(&system, 100);
+	largest = lone_memory_largest_free_block(&system);
+	b = lone_allocate_aligned(&system, 1000, 4096);
+
+	lone_test_assert_true(suite, test, ((uintptr_t) b & 4095) == 0);
+	lone_test_assert_true(suite, test, lone_memory_is_zero(b, 1000));
+
+	/* the memory skipped to align the block is given back */
+	lone_deallocate(&system, b);
+	lone_test_assert_true(suite, test, lone_memory_largest_free_block(&system) == largest);
+
+	lone_deallocate(&system, a);
+}
+
+static LONE_TEST_FUNCTION(test_lone_memory_allocator_statistics)
+{
+	struct lone_system system;
+	void *a, *b;
+
+	initialize(&system);
+
+	lone_test_assert_unsigned_long_equal(suite, test, system.memory.statistics.free.blocks, 1);
+
+	a = lone_allocate(&system, 100);
+	b = lone_allocate(&system, LONE_MEMORY_LARGE_SIZE);
+	lone_deallocate(&system, a);
+
+	lone_test_assert_unsigned_long_equal(suite, test, system.memory.statistics.allocations, 2);
+	lone_test_assert_unsigned_long_equal(suite, test, system.memory.statistics.deallocations, 1);
+	lone_test_assert_unsigned_long_equal(suite, test, system.memory.statistics.allocated, LONE_MEMORY_LARGE_SIZE);
+	lone_test_assert_unsigned_long_equal(suite, test, system.memory.statistics.free.blocks, 1);
+	lone_test_assert_unsigned_long_equal(suite, test, lone_memory_largest_free_block(&system), system.memory.statistics.free.bytes);
+
+	lone_deallocate(&system, b);
+
+	lone_test_assert_unsigned_long_equal(suite, test, system.memory.statistics.allocated, 0);
+	lone_test_assert_unsigned_long_equal(suite, test, system.memory.statistics.mapped, 0);
+}
+
+static LONE_TEST_FUNCTION(test_lone_memory_allocator_trim_arena)
+{
+	struct lone_system system;
+	void *a;
+
+	initialize(&system);
+
+	/* too large for the initial memory, not large enough to be mapped directly */
+	a = lone_allocate(&system, LONE_MEMORY_LARGE_SIZE / 2);
+	lone_test_assert_unsigned_long_equal(suite, test, system.memory.statistics.arenas, 2);
+
+	lone_deallocate(&system, a);
+	lone_memory_trim(&system);
+
+	lone_test_assert_unsigned_long_equal(suite, test, system.memory.statistics.arenas, 1);
+	lone_test_assert_unsigned_long_equal(suite, test, system.memory.statistics.mapped, 0);
+	lone_test_assert_unsigned_long_equal(suite, test, system.memory.statistics.free.blocks, 1);
+}
+
+static LONE_TEST_FUNCTION(test_lone_memory_allocator_trim_block)
+{
+	struct lone_system system;
+	unsigned char *a, *b;
+	size_t trimmed;
+
+	initialize(&system);
+
+	/* the second block keeps the arena in use */
+	a = lone_allocate(&system, LONE_MEMORY_LARGE_SIZE / 2);
+	lone_allocate(&system, LONE_MEMORY_LARGE_SIZE / 2);
+	fill(a, LONE_MEMORY_LARGE_SIZE / 2);
+	lone_deallocate(&system, a);
+
+	lone_memory_trim(&system);
+	trimmed = system.memory.statistics.trimmed;
+	lone_test_assert_true(suite, test, trimmed >= LONE_MEMORY_LARGE_SIZE / 2 - 2 * system.memory.page_size);
+	lone_test_assert_unsigned_long_equal(suite, test, system.memory.statistics.arenas, 2);
+
+	/* already trimmed blocks are left alone */
+	lone_memory_trim(&system);
+	lone_test_assert_unsigned_long_equal(suite, test, system.memory.statistics.trimmed, trimmed);
+
+	b = lone_allocate(&system, LONE_MEMORY_LARGE_SIZE / 2);
+	lone_test_assert_true(suite, test, a == b);
+	lone_test_assert_true(suite, test, lone_memory_is_zero(b, LONE_MEMORY_LARGE_SIZE / 2));
+}
+
+static LONE_TEST_FUNCTION(test_lone_memory_allocator_huge_pages)
+{
+	struct lone_system system;
+	unsigned char *a;
+
+	initialize(&system);
+	system.memory.huge_pages = true;
+
+	a = lone_allocate(&system, LONE_MEMORY_LARGE_SIZE / 2);
+
+	lone_test_assert_true(suite, test, (uintptr_t) system.memory.arenas % LONE_MEMORY_HUGE_PAGE_SIZE == 0);
+	lone_test_assert_unsigned_long_equal(suite, test, system.memory.arenas->size, LONE_MEMORY_HUGE_PAGE_SIZE);
+	lone_test_assert_unsigned_long_equal(suite, test, system.memory.statistics.mapped, LONE_MEMORY_HUGE_PAGE_SIZE);
+	lone_test_assert_true(suite, test, lone_memory_is_zero(a, LONE_MEMORY_LARGE_SIZE / 2));
+
+	lone_deallocate(&system, a);
+	lone_memory_trim(&system);
+
+	lone_test_assert_unsigned_long_equal(suite, test, system.memory.statistics.mapped, 0);
+}
+
+long lone(int argc, char **argv, char **envp, struct lone_auxiliary_vector *auxv)
+{
+
+	static struct lone_test_case cases[] = {
+
+		LONE_TEST_CASE("lone/memory/allocator/reuse", test_lone_memory_allocator_reuse),
+		LONE_TEST_CASE("lone/memory/allocator/reallocate/grow/in-place", test_lone_memory_allocator_reallocate_grow_in_place),
+		LONE_TEST_CASE("lone/memory/allocator/reallocate/grow/by-moving", test_lone_memory_allocator_reallocate_grow_by_moving),
+		LONE_TEST_CASE("lone/memory/allocator/reallocate/shrink/in-place", test_lone_memory_allocator_reallocate_shrink_in_place),
+		LONE_TEST_CASE("lone/memory/allocator/large", test_lone_memory_allocator_large),
+		LONE_TEST_CASE("lone/memory/allocator/aligned", test_lone_memory_allocator_aligned),
+		LONE_TEST_CASE("lone/memory/allocator/statistics", test_lone_memory_allocator_statistics),
+		LONE_TEST_CASE("lone/memory/allocator/trim/arena", test_lone_memory_allocator_trim_arena),
+		LONE_TEST_CASE("lone/memory/allocator/trim/block", test_lone_memory_allocator_trim_block),
+		LONE_TEST_CASE("lone/memory/allocator/huge-pages", test_lone_memory_allocator_huge_pages),
+
+		LONE_TEST_CASE_NULL(),
+	};
+
+	struct lone_test_suite suite = LONE_TEST_SUITE(cases);
+	enum lone_test_result result;
+
+	result = lone_test_suite_run(&suite);
+
+	switch (result) {
+	case LONE_TEST_RESULT_PASS:
+		return 0;
+	case LONE_TEST_RESULT_FAIL:
+		return 1;
+	case LONE_TEST_RESULT_SKIP:
+		return 2;
+	default:
+		return -1;
+	}
+}
+
+#include <lone/architecture/linux/entry_point.c>
@@ -0,0 +1,168 @@
+/* SPDX-License-Identifier: AGPL-3.0-or-later */
+
+#include <lone/types.h>
+#include <lone/memory/functions.h>
+
+#include <lone/test.h>
+
+#define BUFFER_SIZE 1024
+
+static unsigned char buffer[BUFFER_SIZE], expected[BUFFER_SIZE];
+
+static void fill(unsigned char *bytes, size_t count)
+{
+	for (size_t i = 0; i < count; ++i) { bytes[i] = (unsigned char) (i * 7 + 1); }
+}
+
+static bool is_same(unsigned char *a, unsigned char *b, size_t count)
+{
+	for (size_t i = 0; i < count; ++i) { if (a[i] != b[i]) { return false; } }
+	return true;
+}
+
+/* the byte at a time loops the vectorized functions must agree with */
+static void reference_move(unsigned char *from, unsigned char *to, size_t count)
+{
+	if (from >= to) {
+		while (count--) { *to++ = *from++; }
+	} else {
+		from += count; to += count;
+		while (count--) { *--to = *--from; }
+	}
+}
+
+static LONE_TEST_FUNCTION(test_lone_memory_move)
+{
+	static size_t counts[] = { 0, 1, 7, 8, 15, 16, 31, 33, 64, 255, 256, 300, 600 };
+	size_t from, to, i;
+	bool passed = true;
+
+	for (i = 0; i < sizeof(counts) / sizeof(counts[0]); ++i) {
+		for (from = 0; from < 40; from += 3) {
+			for (to = 0; to < 40; to += 5) {
+				fill(buffer, BUFFER_SIZE);
+				fill(expected, BUFFER_SIZE);
+
+				lone_memory_move(buffer + from, buffer + to, counts[i]);
+				reference_move(expected + from, expected + to, counts[i]);
+
+				passed = passed && is_same(buffer, expected, BUFFER_SIZE);
+			}
+		}
+	}
+
+	lone_test_assert_true(suite, test, passed);
+}
+
+static LONE_TEST_FUNCTION(test_lone_memory_set)
+{
+	size_t offset, count;
+	bool passed = true;
+
+	for (offset = 0; offset < 33; ++offset) {
+		for (count = 0; count < 600; count += 37) {
+			fill(buffer, BUFFER_SIZE);
+			fill(expected, BUFFER_SIZE);
+
+			lone_memory_set(buffer + offset, 0xA5, count);
+			for (size_t i = 0; i < count; ++i) { expected[offset + i] = 0xA5; }
+
+			passed = passed && is_same(buffer, expected, BUFFER_SIZE);
+		}
+	}
+
+	lone_test_assert_true(suite, test, passed);
+}
+
+static LONE_TEST_FUNCTION(test_lone_memory_compare)
+{
+	size_t position;
+	bool passed = true;
+
+	fill(buffer, BUFFER_SIZE);
+	fill(expected, BUFFER_SIZE);
+
+	lone_test_assert_int_equal(suite, test, lone_memory_compare(buffer, expected, BUFFER_SIZE), 0);
+
+	for (position = 0; position < 700; position += 13) {
+		fill(buffer, BUFFER_SIZE);
+		buffer[position] += 1;
+
+		passed = passed && lone_memory_compare(buffer, expected, 700) > 0;
+		passed = passed && lone_memory_compare(expected, buffer, 700) < 0;
+		passed = passed && lone_memory_compare(buffer, expected, position) == 0;
+	}
+
+	lone_test_assert_true(suite, test, passed);
+}
+
+static LONE_TEST_FUNCTION(test_lone_memory_is_zero)
+{
+	size_t position;
+	bool passed = true;
+
+	lone_memory_zero(buffer, BUFFER_SIZE);
+	lone_test_assert_true(suite, test, lone_memory_is_zero(buffer, BUFFER_SIZE));
+
+	for (position = 0; position < 700; position += 11) {
+		lone_memory_zero(buffer, BUFFER_SIZE);
+		buffer[position] = 1;
+
+		passed = passed && !lone_memory_is_zero(buffer, 700);
+		passed = passed && lone_memory_is_zero(buffer, position);
+		passed = passed && lone_memory_is_zero(buffer + position + 1, 700 - position - 1);
+	}
+
+	lone_test_assert_true(suite, test, passed);
+}
+
+static LONE_TEST_FUNCTION(test_lone_c_string_length)
+{
+	size_t offset, length;
+	bool passed = true;
+
+	for (offset = 0; offset < 16; ++offset) {
+		for (length = 0; length < 40; ++length) {
+			lone_memory_set(buffer, 'x', BUFFER_SIZE);
+			buffer[offset + length] = '\0';
+
+			passed = passed && lone_c_string_length((char *) buffer + offset) == length;
+		}
+	}
+
+	lone_test_assert_true(suite, test, passed);
+	lone_test_assert_true(suite, test, lone_c_string_length(0) == 0);
+}
+
+long lone(int argc, char **argv, char **envp, struct lone_auxiliary_vector *auxv)
+{
+
+	static struct lone_test_case cases[] = {
+
+		LONE_TEST_CASE("lone/memory/functions/move", test_lone_memory_move),
+		LONE_TEST_CASE("lone/memory/functions/set", test_lone_memory_set),
+		LONE_TEST_CASE("lone/memory/functions/compare", test_lone_memory_compare),
+		LONE_TEST_CASE("lone/memory/functions/is-zero", test_lone_memory_is_zero),
+		LONE_TEST_CASE("lone/memory/functions/c-string-length", test_lone_c_string_length),
+
+		LONE_TEST_CASE_NULL(),
+	};
+
+	struct lone_test_suite suite = LONE_TEST_SUITE(cases);
+	enum lone_test_result result;
+
+	result = lone_test_suite_run(&suite);
+
+	switch (result) {
+	case LONE_TEST_RESULT_PASS:
+		return 0;
+	case LONE_TEST_RESULT_FAIL:
+		return 1;
+	case LONE_TEST_RESULT_SKIP:
+		return 2;
+	default:
+		return -1;
+	}
+}
+
+#include <lone/architecture/linux/entry_point.c>